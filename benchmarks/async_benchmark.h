@@ -0,0 +1,59 @@
+#ifndef ASYNC_BENCHMARK_H
+#define ASYNC_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_async.h"
+#include "propex/propex_node.h"
+
+namespace numsim::propex::bench {
+
+/// Cost versioning adds to every `set()` when nobody waits (atomic increment of the version).
+void BM_async_set_without_waiters(benchmark::State& state) {
+    node<double> n(0.0);
+    double x = 0.0;
+    for (auto _ : state) {
+        n.set(x += 1.0);
+        benchmark::ClobberMemory();
+    }
+}
+
+/// Same for a policy that allows concurrent writers.
+void BM_async_atomic_set_without_waiters(benchmark::State& state) {
+    node<double, ownership::by_atomic> n(0.0);
+    double x = 0.0;
+    for (auto _ : state) {
+        n.set(x += 1.0);
+        benchmark::ClobberMemory();
+    }
+}
+
+/// `range(0)` coroutines wait on one node; one `set()` wakes them and the loop resumes them.
+void BM_async_wake_waiters(benchmark::State& state) {
+    node<std::uint64_t, ownership::by_atomic> n(0);
+    property_view<std::uint64_t, node, ownership::by_atomic> v(&n);
+    manual_scheduler loop;
+    const auto waiters = static_cast<std::size_t>(state.range(0));
+    const auto waiter = [&]() -> detached_task { co_await v.changed(loop); };
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (std::size_t i = 0; i < waiters; ++i) waiter();
+        state.ResumeTiming();
+        v.set(v.get() + 1);
+        benchmark::DoNotOptimize(loop.run());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_async_set_without_waiters);
+BENCHMARK(BM_async_atomic_set_without_waiters);
+BENCHMARK(BM_async_wake_waiters)->Arg(1)->Arg(1000);
+
+} // namespace numsim::propex::bench
+
+#endif // ASYNC_BENCHMARK_H
@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace numsim::propex::bench {
+
+/// Fixed seed so that every run (and every baseline) sees the same key order.
+inline constexpr std::uint_fast32_t seed{0x5eed};
+
+/**
+ * @brief Generates @p count distinct hierarchical keys of (at least) @p length characters.
+ *
+ * Keys look like `"obj17____:value"`; the padding sits in the object part so
+ * that long keys still share the hierarchical shape produced by `key_traits::merge`.
+ */
+inline std::vector<std::string> make_keys(std::size_t count, std::size_t length) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string object = "obj" + std::to_string(i);
+        constexpr std::string_view property{":value"};
+        const std::size_t used = object.size() + property.size();
+        if (used < length) object.append(length - used, '_');
+        keys.push_back(object.append(property));
+    }
+    return keys;
+}
+
+/// Returns a copy of @p keys in a deterministic pseudo-random order.
+inline std::vector<std::string> shuffled(std::vector<std::string> keys) {
+    std::mt19937 gen(seed);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    return keys;
+}
+
+/// Helper wrapper so we can pass ownership templates to `BENCHMARK_TEMPLATE`.
+template <template<class> class Policy>
+struct OwnershipTag {
+    template<class T>
+    using type = Policy<T>;
+};
+
+} // namespace numsim::propex::bench
+
+#endif // BENCHMARK_UTILS_H
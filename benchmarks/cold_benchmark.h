@@ -0,0 +1,78 @@
+#ifndef COLD_BENCHMARK_H
+#define COLD_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "propex/propex_cold.h"
+#include "propex/propex_node.h"
+
+namespace numsim::propex::bench {
+
+/// Run metadata: `range(0)` bytes of JSON-like text.
+struct Metadata {
+    using type = std::string;
+    static type make(std::size_t bytes) {
+        std::string s = "{";
+        for (std::size_t i = 0; s.size() < bytes; ++i)
+            s += "\"region_" + std::to_string(i) + "\": {\"material\": \"steel_" + std::to_string(i % 5)
+               + "\", \"temperature\": 293.15, \"fixed\": false},";
+        s.resize(bytes);
+        return s;
+    }
+};
+
+/// Initial condition: `range(0)` bytes of a piecewise constant field.
+struct InitialField {
+    using type = std::vector<double>;
+    static type make(std::size_t bytes) {
+        type u(bytes / sizeof(double));
+        for (std::size_t i = 0; i < u.size(); ++i) u[i] = i < u.size() / 3 ? 293.15 : 1200.0;
+        return u;
+    }
+};
+
+/// Read of a value that is in use (uncompressed): the steady-state overhead of the policy.
+template <class Data>
+void BM_cold_get_hot(benchmark::State& state) {
+    node<typename Data::type, ownership::by_compressed> n(Data::make(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) benchmark::DoNotOptimize(n.get().data());
+}
+
+/**
+ * @brief First read after compression (decompression latency), with the memory it saved.
+ *
+ * `hot_bytes`/`cold_bytes` are the node's payload before and after a sweep.
+ */
+template <class Data>
+void BM_cold_get_thaw(benchmark::State& state) {
+    node<typename Data::type, ownership::by_compressed> n(Data::make(static_cast<std::size_t>(state.range(0))));
+    const auto hot_bytes = n.payload_bytes();
+    std::size_t cold_bytes = hot_bytes;
+    for (auto _ : state) {
+        n.compress_cold();
+        n.compress_cold();
+        cold_bytes = n.payload_bytes();
+        const auto start = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(n.get().data());
+        const auto stop = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(stop - start).count());
+    }
+    state.counters["hot_bytes"] = static_cast<double>(hot_bytes);
+    state.counters["cold_bytes"] = static_cast<double>(cold_bytes);
+    state.counters["ratio"] = static_cast<double>(hot_bytes) / static_cast<double>(cold_bytes);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_cold_get_hot, Metadata)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_cold_get_thaw, Metadata)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_cold_get_hot, InitialField)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_cold_get_thaw, InitialField)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20)->UseManualTime();
+
+} // namespace numsim::propex::bench
+
+#endif // COLD_BENCHMARK_H
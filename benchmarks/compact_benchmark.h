@@ -0,0 +1,108 @@
+#ifndef COMPACT_BENCHMARK_H
+#define COMPACT_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "propex/propex_node.h"
+#include "propex/propex_pmr.h"
+#include "propex/propex_registry.h"
+#include "benchmark_utils.h"
+#include "hugepage_benchmark.h"
+#include "perf_counters.h"
+
+namespace numsim::propex::bench {
+
+/// Compaction applied after churning, before the timed iteration.
+enum class Compaction { none, index, relocate };
+
+/**
+ * @brief A pmr registry after emulated adaptive refinement.
+ *
+ * The registry grows to `4 n` entries, interleaved with unrelated
+ * allocations, then shrinks back to `n` survivors in random order. Survivors
+ * end up scattered and the hash table keeps its peak size.
+ */
+template <class Memory, template<class...> class Map>
+struct churned_fixture {
+    Memory memory;
+    pmr::registry<node<double>, Map> reg{memory.resource()};
+
+    churned_fixture(std::size_t n, std::size_t key_len) {
+        const auto keys = make_keys(4 * n, key_len);
+        std::vector<void*> noise;
+        double v{0.0};
+        for (const auto& key : keys) {
+            reg.add(pmr::make_unique<node<double>>(memory.resource(), v++), std::string_view(key));
+            noise.push_back(memory.resource()->allocate(48));
+        }
+        auto order = shuffled(keys);
+        order.resize(keys.size() - n);
+        for (const auto& key : order) reg.erase(std::pmr::string(key, memory.resource()));
+        for (void* p : noise) memory.resource()->deallocate(p, 48);
+    }
+
+    compaction_result compact(Compaction mode) {
+        if (mode == Compaction::none) return {};
+        return reg.compact(mode == Compaction::relocate ? compact_mode::relocate_nodes : compact_mode::index);
+    }
+};
+
+template <class Memory, template<class...> class Map, Compaction Mode>
+void BM_registry_iterate_churned(benchmark::State& state) {
+    churned_fixture<Memory, Map> f(state.range(0), state.range(1));
+    f.compact(Mode);
+
+    perf_counters perf;
+    perf.start();
+    for (auto _ : state) {
+        double sum{0.0};
+        for (const auto& [key, n] : f.reg.data()) sum += n->get();
+        benchmark::DoNotOptimize(sum);
+    }
+    perf.stop();
+    perf.report(state);
+    state.SetItemsProcessed(state.iterations() * f.reg.data().size());
+}
+
+/// Measures `compact()` itself.
+template <class Memory, template<class...> class Map, Compaction Mode>
+void BM_registry_compact(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto f = std::make_unique<churned_fixture<Memory, Map>>(state.range(0), state.range(1));
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(f->compact(Mode));
+
+        state.PauseTiming();
+        f.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+inline void compact_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "key_len"});
+    for (long n : {1L << 12, 1L << 17})
+        b->Args({n, 64});
+}
+
+#define PROPEX_COMPACT_BENCHMARKS(Memory, Map)                                                                \
+    BENCHMARK_TEMPLATE(BM_registry_iterate_churned, Memory, Map, Compaction::none)->Apply(compact_args);     \
+    BENCHMARK_TEMPLATE(BM_registry_iterate_churned, Memory, Map, Compaction::index)->Apply(compact_args);    \
+    BENCHMARK_TEMPLATE(BM_registry_iterate_churned, Memory, Map, Compaction::relocate)->Apply(compact_args); \
+    BENCHMARK_TEMPLATE(BM_registry_compact, Memory, Map, Compaction::index)->Apply(compact_args);            \
+    BENCHMARK_TEMPLATE(BM_registry_compact, Memory, Map, Compaction::relocate)->Apply(compact_args)
+
+PROPEX_COMPACT_BENCHMARKS(GlobalHeap, pmr::unordered_map);
+PROPEX_COMPACT_BENCHMARKS(NormalPages, pmr::unordered_map);
+PROPEX_COMPACT_BENCHMARKS(NormalPages, pmr::map);
+
+#undef PROPEX_COMPACT_BENCHMARKS
+
+} // namespace numsim::propex::bench
+
+#endif // COMPACT_BENCHMARK_H
@@ -0,0 +1,93 @@
+#ifndef EXPR_BENCHMARK_H
+#define EXPR_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_expr.h"
+#include "propex/propex_field.h"
+#include "propex/propex_node.h"
+
+namespace numsim::propex::bench {
+
+/// Three fields of `range(0)` elements for `u = u + dt * v - c * w`.
+struct update_fixture {
+    using field = aligned_vector<double>;
+    using view = property_view<field, node, ownership::by_value>;
+
+    node<field> un, vn, wn;
+    view u{&un}, v{&vn}, w{&wn};
+    static constexpr double dt = 1e-3, c = 0.25;
+
+    explicit update_fixture(std::size_t n) : un(field(n, 1.0)), vn(field(n, 2.0)), wn(field(n, 0.5)) {}
+
+    void report(benchmark::State& state) const {
+        // Fused traffic: three reads and one write per element.
+        state.SetBytesProcessed(state.iterations() * state.range(0) * 4 * static_cast<std::int64_t>(sizeof(double)));
+    }
+};
+
+/// Baseline: whole-container arithmetic with a temporary per operator, then set().
+void BM_expr_naive_temporaries(benchmark::State& state) {
+    update_fixture f(static_cast<std::size_t>(state.range(0)));
+    const std::size_t n = f.u.get().size();
+    for (auto _ : state) {
+        update_fixture::field dv(n), cw(n), sum(n), result(n);
+        for (std::size_t i = 0; i < n; ++i) dv[i] = f.dt * f.v.get()[i];
+        for (std::size_t i = 0; i < n; ++i) cw[i] = f.c * f.w.get()[i];
+        for (std::size_t i = 0; i < n; ++i) sum[i] = f.u.get()[i] + dv[i];
+        for (std::size_t i = 0; i < n; ++i) result[i] = sum[i] - cw[i];
+        f.u.set(std::move(result));
+        benchmark::ClobberMemory();
+    }
+    f.report(state);
+}
+
+/// Reference: the hand-written fused loop over spans.
+void BM_expr_hand_fused(benchmark::State& state) {
+    update_fixture f(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        const std::span<double> u = f.u.span();
+        const auto v = std::as_const(f.v).span();
+        const auto w = std::as_const(f.w).span();
+        for (std::size_t i = 0; i < u.size(); ++i) u[i] = u[i] + f.dt * v[i] - f.c * w[i];
+        benchmark::ClobberMemory();
+    }
+    f.report(state);
+}
+
+/// `assign(u, u + dt * v - c * w)`.
+void BM_expr_assign(benchmark::State& state) {
+    update_fixture f(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        assign(f.u, f.u + f.dt * f.v - f.c * f.w);
+        benchmark::ClobberMemory();
+    }
+    f.report(state);
+}
+
+/// `parallel_assign()` with `range(1)` threads.
+void BM_expr_parallel_assign(benchmark::State& state) {
+    update_fixture f(static_cast<std::size_t>(state.range(0)));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    for (auto _ : state) {
+        parallel_assign(f.u, f.u + f.dt * f.v - f.c * f.w, threads);
+        benchmark::ClobberMemory();
+    }
+    f.report(state);
+}
+
+BENCHMARK(BM_expr_naive_temporaries)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(BM_expr_hand_fused)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(BM_expr_assign)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(BM_expr_parallel_assign)->Args({1 << 20, 1})->Args({1 << 20, 2})->Args({1 << 20, 4})->UseRealTime();
+
+} // namespace numsim::propex::bench
+
+#endif // EXPR_BENCHMARK_H
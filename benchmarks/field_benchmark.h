@@ -0,0 +1,85 @@
+#ifndef FIELD_BENCHMARK_H
+#define FIELD_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_field.h"
+#include "propex/propex_node.h"
+
+namespace numsim::propex::bench {
+
+using field_vector = aligned_vector<double>;
+using field_view = property_view<field_vector, node, ownership::by_value>;
+
+/// Baseline: updating one element of an array property through get()/set() copies the container.
+void BM_field_update_element_copy(benchmark::State& state) {
+    node<field_vector> n(field_vector(static_cast<std::size_t>(state.range(0)), 1.0));
+    field_view v(&n);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        field_vector u = v.get();
+        u[i] += 1.0;
+        v.set(std::move(u));
+        i = i + 1 == n.get().size() ? 0 : i + 1;
+    }
+}
+
+/// The same update through `operator[]`.
+void BM_field_update_element_inplace(benchmark::State& state) {
+    node<field_vector> n(field_vector(static_cast<std::size_t>(state.range(0)), 1.0));
+    field_view v(&n);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        v[i] += 1.0;
+        benchmark::ClobberMemory();
+        i = i + 1 == v.size() ? 0 : i + 1;
+    }
+}
+
+/// Streaming reduction over the span of an aligned field.
+void BM_field_stream_span(benchmark::State& state) {
+    node<field_vector> n(field_vector(static_cast<std::size_t>(state.range(0)), 1.0));
+    field_view v(&n);
+    for (auto _ : state) {
+        const auto s = std::as_const(v).span();
+        benchmark::DoNotOptimize(std::accumulate(s.begin(), s.end(), 0.0));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(double)));
+}
+
+/// Reading 8 elements of a locked field: a full snapshot copy versus a range `load()`.
+template <bool Bulk>
+void BM_field_locked_read(benchmark::State& state) {
+    node<std::vector<double>, ownership::by_spinlock> n(std::vector<double>(static_cast<std::size_t>(state.range(0)), 1.0));
+    property_view<std::vector<double>, node, ownership::by_spinlock> v(&n);
+    std::array<double, 8> out{};
+    for (auto _ : state) {
+        if constexpr (Bulk) {
+            v.load(0, out);
+        } else {
+            const std::vector<double> snapshot = v.get();
+            std::copy_n(snapshot.begin(), out.size(), out.begin());
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+
+BENCHMARK(BM_field_update_element_copy)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_field_update_element_inplace)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_field_stream_span)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_field_locked_read, false)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_field_locked_read, true)->Arg(1 << 10)->Arg(1 << 16);
+
+} // namespace numsim::propex::bench
+
+#endif // FIELD_BENCHMARK_H
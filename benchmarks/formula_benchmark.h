@@ -0,0 +1,122 @@
+#ifndef FORMULA_BENCHMARK_H
+#define FORMULA_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "propex/propex_field.h"
+#include "propex/propex_formula.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+
+namespace numsim::propex::bench {
+
+/// `e = 0.5 * rho * v^2 + p / ((gamma - 1) * rho)` over fields of `range(0)` elements.
+struct formula_fixture {
+    using field = aligned_vector<double>;
+    static constexpr const char* text = "e = 0.5 * rho * v^2 + p / ((gamma - 1) * rho)";
+
+    registry<std::string, node_base> reg;
+    std::size_t n;
+
+    explicit formula_fixture(std::size_t size) : n(size) {
+        reg.add(std::make_unique<node<field>>(field(n, 1.2)), "rho");
+        reg.add(std::make_unique<node<field>>(field(n, 3.0)), "v");
+        reg.add(std::make_unique<node<field>>(field(n, 1e5)), "p");
+        reg.add(std::make_unique<node<double>>(1.4), "gamma");
+        reg.add(std::make_unique<node<field>>(field(n)), "e");
+    }
+
+    const double* data(const char* key) const { return static_cast<node<field>*>(reg.find(key))->get().data(); }
+};
+
+/// Baseline: an expression tree walked recursively for every element.
+struct tree_walker {
+    enum class op { leaf, constant, add, sub, mul, div, pow };
+    struct expr {
+        op o;
+        const double* data{nullptr};  // leaf; scalars repeat element 0
+        bool scalar{false};
+        double value{0.0};
+        std::unique_ptr<expr> l, r;
+    };
+
+    static std::unique_ptr<expr> leaf(const double* d, bool scalar = false) {
+        return std::unique_ptr<expr>(new expr{op::leaf, d, scalar, 0.0, nullptr, nullptr});
+    }
+    static std::unique_ptr<expr> constant(double v) {
+        return std::unique_ptr<expr>(new expr{op::constant, nullptr, false, v, nullptr, nullptr});
+    }
+    static std::unique_ptr<expr> binary(op o, std::unique_ptr<expr> l, std::unique_ptr<expr> r) {
+        return std::unique_ptr<expr>(new expr{o, nullptr, false, 0.0, std::move(l), std::move(r)});
+    }
+
+    static double eval(const expr& e, std::size_t i) {
+        switch (e.o) {
+            case op::leaf: return e.data[e.scalar ? 0 : i];
+            case op::constant: return e.value;
+            case op::add: return eval(*e.l, i) + eval(*e.r, i);
+            case op::sub: return eval(*e.l, i) - eval(*e.r, i);
+            case op::mul: return eval(*e.l, i) * eval(*e.r, i);
+            case op::div: return eval(*e.l, i) / eval(*e.r, i);
+            case op::pow: return std::pow(eval(*e.l, i), eval(*e.r, i));
+        }
+        return 0.0;
+    }
+};
+
+void BM_formula_tree_walk(benchmark::State& state) {
+    formula_fixture f(static_cast<std::size_t>(state.range(0)));
+    using tw = tree_walker;
+    const double gamma = static_cast<node<double>*>(f.reg.find("gamma"))->get();
+    const auto tree = tw::binary(
+        tw::op::add,
+        tw::binary(tw::op::mul, tw::binary(tw::op::mul, tw::constant(0.5), tw::leaf(f.data("rho"))),
+                   tw::binary(tw::op::pow, tw::leaf(f.data("v")), tw::constant(2.0))),
+        tw::binary(tw::op::div, tw::leaf(f.data("p")),
+                   tw::binary(tw::op::mul, tw::binary(tw::op::sub, tw::leaf(&gamma, true), tw::constant(1.0)),
+                              tw::leaf(f.data("rho")))));
+    double* e = static_cast<node<formula_fixture::field>*>(f.reg.find("e"))->span().data();
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < f.n; ++i) e[i] = tw::eval(*tree, i);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_formula_bytecode(benchmark::State& state) {
+    formula_fixture f(static_cast<std::size_t>(state.range(0)));
+    const formula energy = compile_formula(f.reg, formula_fixture::text);
+    for (auto _ : state) {
+        energy.apply();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Scalar formula: dispatch and broadcast overhead per evaluation.
+void BM_formula_bytecode_scalar(benchmark::State& state) {
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<node<double>>(210e3), "mat", "E");
+    reg.add(std::make_unique<node<double>>(0.3), "mat", "nu");
+    reg.add(std::make_unique<node<double>>(0.0), "mat", "G");
+    const formula shear = compile_formula(reg, "mat:G = mat:E / (2*(1+mat:nu))");
+    for (auto _ : state) {
+        shear.apply();
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(BM_formula_tree_walk)->Arg(1 << 10)->Arg(1 << 18);
+BENCHMARK(BM_formula_bytecode)->Arg(1 << 10)->Arg(1 << 18);
+BENCHMARK(BM_formula_bytecode_scalar);
+
+} // namespace numsim::propex::bench
+
+#endif // FORMULA_BENCHMARK_H
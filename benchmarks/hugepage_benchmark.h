@@ -0,0 +1,118 @@
+#ifndef HUGEPAGE_BENCHMARK_H
+#define HUGEPAGE_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "propex/propex_hugepage.h"
+#include "propex/propex_node.h"
+#include "propex/propex_pmr.h"
+#include "benchmark_utils.h"
+#include "perf_counters.h"
+
+namespace numsim::propex::bench {
+
+// -----------------------------------------------------------------------------
+// Backing memory for a pmr registry
+// -----------------------------------------------------------------------------
+
+/// Baseline: every map node, key and property node comes from the global heap.
+struct GlobalHeap {
+    std::pmr::memory_resource* resource() noexcept { return std::pmr::new_delete_resource(); }
+    double huge_fraction() const noexcept { return 0.0; }
+};
+
+/// One arena per registry, backed by 4 KB pages or by huge pages.
+template <huge_page_mode Mode>
+struct Arena {
+    huge_page_arena arena{Mode};
+
+    std::pmr::memory_resource* resource() noexcept { return &arena; }
+
+    double huge_fraction() const noexcept {
+        const auto s = arena.upstream().stats();
+        const auto total = s.explicit_bytes + s.transparent_bytes + s.normal_bytes;
+        return total ? double(s.explicit_bytes + s.transparent_bytes) / double(total) : 0.0;
+    }
+};
+
+using NormalPages   = Arena<huge_page_mode::none>;
+using Transparent   = Arena<huge_page_mode::transparent>;
+using ExplicitPages = Arena<huge_page_mode::explicit_pages>;
+
+/// A filled pmr registry together with the memory it lives in.
+template <class Memory>
+struct hugepage_fixture {
+    Memory memory;
+    pmr::registry<node<double>> reg{memory.resource()};
+    std::vector<std::pmr::string> lookup;
+
+    hugepage_fixture(std::size_t n, std::size_t key_len) {
+        const auto keys = make_keys(n, key_len);
+        double v{0.0};
+        for (const auto& key : keys)
+            reg.add(pmr::make_unique<node<double>>(memory.resource(), v++), std::string_view(key));
+        for (const auto& key : shuffled(keys)) lookup.emplace_back(key, memory.resource());
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Benchmarks — args: {number of properties, key length}
+// -----------------------------------------------------------------------------
+template <class Memory>
+void BM_hugepage_find(benchmark::State& state) {
+    hugepage_fixture<Memory> f(state.range(0), state.range(1));
+
+    std::size_t i{0};
+    perf_counters perf;
+    perf.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f.reg.find(f.lookup[i]));
+        if (++i == f.lookup.size()) i = 0;
+    }
+    perf.stop();
+    perf.report(state);
+    state.counters["huge_fraction"] = f.memory.huge_fraction();
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Memory>
+void BM_hugepage_iterate(benchmark::State& state) {
+    hugepage_fixture<Memory> f(state.range(0), state.range(1));
+
+    perf_counters perf;
+    perf.start();
+    for (auto _ : state) {
+        double sum{0.0};
+        for (const auto& [key, n] : f.reg.data()) sum += n->get();
+        benchmark::DoNotOptimize(sum);
+    }
+    perf.stop();
+    perf.report(state);
+    state.counters["huge_fraction"] = f.memory.huge_fraction();
+    state.SetItemsProcessed(state.iterations() * f.reg.data().size());
+}
+
+/// Working sets well beyond the reach of a 4 KB-page dTLB.
+inline void hugepage_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "key_len"});
+    for (long n : {1L << 16, 1L << 20})
+        b->Args({n, 64});
+}
+
+#define PROPEX_HUGEPAGE_BENCHMARKS(Memory)                                    \
+    BENCHMARK_TEMPLATE(BM_hugepage_find, Memory)->Apply(hugepage_args);        \
+    BENCHMARK_TEMPLATE(BM_hugepage_iterate, Memory)->Apply(hugepage_args)
+
+PROPEX_HUGEPAGE_BENCHMARKS(GlobalHeap);
+PROPEX_HUGEPAGE_BENCHMARKS(NormalPages);
+PROPEX_HUGEPAGE_BENCHMARKS(Transparent);
+PROPEX_HUGEPAGE_BENCHMARKS(ExplicitPages);
+
+#undef PROPEX_HUGEPAGE_BENCHMARKS
+
+} // namespace numsim::propex::bench
+
+#endif // HUGEPAGE_BENCHMARK_H
@@ -0,0 +1,59 @@
+#ifndef KEY_TRAITS_BENCHMARK_H
+#define KEY_TRAITS_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <string>
+#include <utility>
+
+#include "propex/key_traits.h"
+
+namespace numsim::propex::bench {
+
+using string_traits = key_traits<std::string>;
+
+/// Builds `Depth` fragments such as `{"level0", "level1", ...}`.
+template <std::size_t Depth>
+std::array<std::string, Depth> make_fragments() {
+    std::array<std::string, Depth> parts;
+    for (std::size_t i = 0; i < Depth; ++i) parts[i] = "level" + std::to_string(i);
+    return parts;
+}
+
+template <std::size_t Depth, std::size_t... I>
+std::string merge_fragments(const std::array<std::string, Depth>& parts, std::index_sequence<I...>) {
+    return string_traits::merge(parts[I]...);
+}
+
+template <std::size_t Depth>
+void BM_key_split(benchmark::State& state) {
+    const auto parts = make_fragments<Depth>();
+    const auto key = merge_fragments(parts, std::make_index_sequence<Depth>{});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(string_traits::split(key));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <std::size_t Depth>
+void BM_key_merge(benchmark::State& state) {
+    const auto parts = make_fragments<Depth>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(merge_fragments(parts, std::make_index_sequence<Depth>{}));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_key_split, 1);
+BENCHMARK_TEMPLATE(BM_key_split, 2);
+BENCHMARK_TEMPLATE(BM_key_split, 4);
+BENCHMARK_TEMPLATE(BM_key_split, 8);
+
+BENCHMARK_TEMPLATE(BM_key_merge, 1);
+BENCHMARK_TEMPLATE(BM_key_merge, 2);
+BENCHMARK_TEMPLATE(BM_key_merge, 4);
+BENCHMARK_TEMPLATE(BM_key_merge, 8);
+
+} // namespace numsim::propex::bench
+
+#endif // KEY_TRAITS_BENCHMARK_H
@@ -0,0 +1,104 @@
+#ifndef LOCK_BENCHMARK_H
+#define LOCK_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_node.h"
+#include "benchmark_utils.h"
+
+namespace numsim::propex::bench {
+
+/// A 6x6 stiffness matrix in Voigt notation: too large for a lock-free atomic.
+using stiffness = std::array<double, 36>;
+
+/// A node with a locking policy, accessed through a view.
+template <class Tag>
+struct locked_cell {
+    template<class T>
+    using Ownership = typename Tag::template type<T>;
+
+    node<stiffness, Ownership> n{stiffness{}};
+    property_view<stiffness, node, Ownership> view{&n};
+
+    stiffness get() const { return view.get(); }
+    void set(const stiffness& v) { view.set(v); }
+};
+
+/**
+ * @brief Optimistic baseline: single-writer sequence lock.
+ *
+ * Readers never write shared memory; they copy the value and retry if the
+ * sequence number changed (or was odd, i.e. a write was in progress).
+ * Elements are relaxed atomics so the racy copy is well-defined.
+ */
+class seqlock_cell {
+public:
+    stiffness get() const {
+        stiffness out;
+        for (;;) {
+            const auto before = seq_.load(std::memory_order_acquire);
+            if (before & 1u) continue;
+            for (std::size_t i = 0; i < out.size(); ++i)
+                out[i] = value_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) return out;
+        }
+    }
+
+    void set(const stiffness& v) {
+        const auto s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < v.size(); ++i)
+            value_[i].store(v[i], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+private:
+    std::atomic<unsigned> seq_{0};
+    std::array<std::atomic<double>, 36> value_{};
+};
+
+/**
+ * @brief Snapshot reads of one shared property under contention.
+ *
+ * With more than one thread, thread 0 writes continuously and the others
+ * read; `reads` and `writes` are the aggregate rates. With one thread it
+ * measures the uncontended read.
+ */
+template <class Cell>
+void BM_locked_snapshot(benchmark::State& state) {
+    static Cell cell;
+    const bool writer = state.thread_index() == 0 && state.threads() > 1;
+    stiffness v{};
+    for (auto _ : state) {
+        if (writer) {
+            v[0] += 1.0;
+            cell.set(v);
+            benchmark::ClobberMemory();
+        } else {
+            benchmark::DoNotOptimize(cell.get());
+        }
+    }
+    const auto n = static_cast<double>(state.iterations());
+    state.counters["reads"]  = benchmark::Counter(writer ? 0.0 : n, benchmark::Counter::kIsRate);
+    state.counters["writes"] = benchmark::Counter(writer ? n : 0.0, benchmark::Counter::kIsRate);
+}
+
+using Spinlock = locked_cell<OwnershipTag<ownership::by_spinlock>>;
+using RwLock   = locked_cell<OwnershipTag<ownership::by_rwlock>>;
+using Seqlock  = seqlock_cell;
+
+BENCHMARK_TEMPLATE(BM_locked_snapshot, Seqlock)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_locked_snapshot, Spinlock)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_locked_snapshot, RwLock)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace numsim::propex::bench
+
+#endif // LOCK_BENCHMARK_H
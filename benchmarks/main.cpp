@@ -0,0 +1,21 @@
+#include <benchmark/benchmark.h>
+#include "key_traits_benchmark.h"
+#include "registry_benchmark.h"
+#include "property_view_benchmark.h"
+#include "memory_benchmark.h"
+#include "hugepage_benchmark.h"
+#include "compact_benchmark.h"
+#include "lock_benchmark.h"
+#include "tabulated_benchmark.h"
+#include "cold_benchmark.h"
+#include "field_benchmark.h"
+#include "expr_benchmark.h"
+#include "formula_benchmark.h"
+#include "sensitivity_benchmark.h"
+#include "async_benchmark.h"
+#include "scheduler_benchmark.h"
+#include "regression.h"
+
+int main(int argc, char** argv) {
+  return numsim::propex::bench::regression::run(argc, argv);
+}
@@ -0,0 +1,74 @@
+#ifndef MEMORY_BENCHMARK_H
+#define MEMORY_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+#include "benchmark_utils.h"
+
+namespace numsim::propex::bench {
+
+/// Payloads of the common property configurations.
+struct ScalarPayload {
+    using type = double;
+    static type make() { return 1.0; }
+};
+
+struct SmallVectorPayload {
+    using type = std::vector<double>;
+    static type make() { return type(16, 1.0); }
+};
+
+struct StringPayload {
+    using type = std::string;
+    static type make() { return std::string(48, 'm'); }
+};
+
+/**
+ * @brief Reports the footprint of a registry with `n` properties of one payload type.
+ *
+ * The timed loop measures `memory_usage()` itself; the interesting output is the
+ * `bytes_per_property` counter and its breakdown.
+ */
+template <template<class...> class Ptr, template<class...> class Map, class Payload>
+void BM_registry_footprint(benchmark::State& state) {
+    using node_type = node<typename Payload::type>;
+    registry<std::string, node_base, Ptr, Map> reg;
+    const auto keys = make_keys(state.range(0), state.range(1));
+    for (const auto& key : keys)
+        reg.add(typename decltype(reg)::node_pointer(new node_type(Payload::make())), key);
+
+    memory_footprint f;
+    for (auto _ : state) {
+        f = reg.memory_usage();
+        benchmark::DoNotOptimize(f);
+    }
+
+    const auto n = static_cast<double>(f.properties);
+    state.counters["bytes_per_property"] = f.bytes_per_property();
+    state.counters["index"]    = double(f.index_nodes + f.index_buckets) / n;
+    state.counters["keys"]     = double(f.key_objects + f.key_heap) / n;
+    state.counters["pointers"] = double(f.node_pointers) / n;
+    state.counters["nodes"]    = double(f.node_objects) / n;
+    state.counters["payload"]  = double(f.payload_heap) / n;
+}
+
+inline void footprint_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "key_len"})->Args({1L << 16, 8})->Args({1L << 16, 64})->Iterations(3);
+}
+
+BENCHMARK_TEMPLATE(BM_registry_footprint, std::unique_ptr, std::unordered_map, ScalarPayload)->Apply(footprint_args);
+BENCHMARK_TEMPLATE(BM_registry_footprint, std::shared_ptr, std::unordered_map, ScalarPayload)->Apply(footprint_args);
+BENCHMARK_TEMPLATE(BM_registry_footprint, std::unique_ptr, std::map, ScalarPayload)->Apply(footprint_args);
+BENCHMARK_TEMPLATE(BM_registry_footprint, std::unique_ptr, std::unordered_map, SmallVectorPayload)->Apply(footprint_args);
+BENCHMARK_TEMPLATE(BM_registry_footprint, std::unique_ptr, std::unordered_map, StringPayload)->Apply(footprint_args);
+
+} // namespace numsim::propex::bench
+
+#endif // MEMORY_BENCHMARK_H
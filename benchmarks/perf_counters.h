@@ -0,0 +1,178 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters for the propex benchmarks (Linux `perf_event_open`).
+ *
+ * `perf_counters` opens one counter per event for the calling thread, counting
+ * user-space only. Events the kernel or the CPU does not provide (virtual
+ * machines, containers, `perf_event_paranoid` > 2, non-Linux builds) are
+ * silently skipped; if none can be opened the benchmark is labelled
+ * `perf: unavailable` and reports wall-clock numbers only.
+ *
+ * Counters are reported per benchmark iteration (i.e. per operation for the
+ * single-operation benchmarks) and scaled for multiplexing.
+ *
+ * @code
+ * perf_counters perf;
+ * perf.start();
+ * for (auto _ : state) { ... }
+ * perf.stop();
+ * perf.report(state);
+ * @endcode
+ */
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace numsim::propex::bench {
+
+class perf_counters {
+public:
+    /// Events collected for every instrumented benchmark.
+    enum event : std::size_t {
+        cycles,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        branch_misses,
+        dtlb_misses,
+        event_count
+    };
+
+    /// Counter names as they appear in the benchmark output.
+    static constexpr std::array<std::string_view, event_count> names{
+        "cycles", "instructions", "L1d_misses", "LLC_misses", "branch_misses", "dTLB_misses"};
+
+    perf_counters() noexcept {
+#if defined(__linux__)
+        for (std::size_t e = 0; e < event_count; ++e) fds_[e] = open(static_cast<event>(e));
+#endif
+    }
+
+    ~perf_counters() {
+#if defined(__linux__)
+        for (int fd : fds_) if (fd >= 0) ::close(fd);
+#endif
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    /// @return `true` if at least one counter could be opened.
+    [[nodiscard]] bool available() const noexcept {
+        for (int fd : fds_) if (fd >= 0) return true;
+        return false;
+    }
+
+    /// Resets and enables all open counters.
+    void start() noexcept {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// Disables all open counters and latches their (multiplex-scaled) values.
+    void stop() noexcept {
+#if defined(__linux__)
+        for (std::size_t e = 0; e < event_count; ++e) {
+            if (fds_[e] < 0) continue;
+            ::ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0);
+            struct { std::uint64_t value, enabled, running; } sample{};
+            if (::read(fds_[e], &sample, sizeof(sample)) != static_cast<ssize_t>(sizeof(sample))) {
+                values_[e] = -1.0;
+                continue;
+            }
+            values_[e] = sample.running == 0 ? -1.0
+                : static_cast<double>(sample.value) * static_cast<double>(sample.enabled)
+                      / static_cast<double>(sample.running);
+        }
+#endif
+    }
+
+    /// Adds one per-iteration counter per available event to @p state.
+    void report(benchmark::State& state) const {
+        if (!available()) {
+            state.SetLabel("perf: unavailable");
+            return;
+        }
+        for (std::size_t e = 0; e < event_count; ++e) {
+            if (fds_[e] < 0 || values_[e] < 0.0) continue;
+            state.counters[std::string(names[e])] =
+                benchmark::Counter(values_[e], benchmark::Counter::kAvgIterations);
+        }
+        if (fds_[cycles] >= 0 && fds_[instructions] >= 0 && values_[cycles] > 0.0)
+            state.counters["IPC"] = values_[instructions] / values_[cycles];
+    }
+
+private:
+#if defined(__linux__)
+    static int open(event e) noexcept {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const auto cache = [](std::uint64_t id, std::uint64_t op, std::uint64_t result) {
+            return id | (op << 8) | (result << 16);
+        };
+        switch (e) {
+        case cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case l1d_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        case llc_misses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case branch_misses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case dtlb_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        default:
+            return -1;
+        }
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    std::array<int, event_count> fds_{-1, -1, -1, -1, -1, -1};
+    std::array<double, event_count> values_{};
+};
+
+} // namespace numsim::propex::bench
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,80 @@
+#ifndef PROPERTY_VIEW_BENCHMARK_H
+#define PROPERTY_VIEW_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_node.h"
+#include "benchmark_utils.h"
+#include "perf_counters.h"
+
+namespace numsim::propex::bench {
+
+/// Owns a node (and, for `by_reference`, the external value) plus a view onto it.
+template <class Tag>
+struct view_fixture {
+    template<class T>
+    using Ownership = typename Tag::template type<T>;
+
+    double external{1.0};
+    node<double, Ownership> n{external};
+    property_view<double, node, Ownership> view{&n};
+};
+
+template <class Tag>
+void BM_view_get(benchmark::State& state) {
+    view_fixture<Tag> f;
+    perf_counters perf;
+    perf.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f.view.get());
+    }
+    perf.stop();
+    perf.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Tag>
+void BM_view_set(benchmark::State& state) {
+    view_fixture<Tag> f;
+    double v{0.0};
+    perf_counters perf;
+    perf.start();
+    for (auto _ : state) {
+        f.view.set(v);
+        v += 1.0;
+        benchmark::ClobberMemory();
+    }
+    perf.stop();
+    perf.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+
+using ByValue     = OwnershipTag<ownership::by_value>;
+using ByReference = OwnershipTag<ownership::by_reference>;
+using ByShared    = OwnershipTag<ownership::by_shared>;
+using ByAtomic    = OwnershipTag<ownership::by_atomic>;
+using ByLazy      = OwnershipTag<ownership::by_lazy>;
+using ByAtomicShared = OwnershipTag<ownership::by_atomic_shared>;
+using ByAtomicRef = OwnershipTag<ownership::by_atomic_ref>;
+
+BENCHMARK_TEMPLATE(BM_view_get, ByValue);
+BENCHMARK_TEMPLATE(BM_view_get, ByReference);
+BENCHMARK_TEMPLATE(BM_view_get, ByShared);
+BENCHMARK_TEMPLATE(BM_view_get, ByAtomic);
+BENCHMARK_TEMPLATE(BM_view_get, ByLazy);
+BENCHMARK_TEMPLATE(BM_view_get, ByAtomicShared);
+BENCHMARK_TEMPLATE(BM_view_get, ByAtomicRef);
+
+BENCHMARK_TEMPLATE(BM_view_set, ByValue);
+BENCHMARK_TEMPLATE(BM_view_set, ByReference);
+BENCHMARK_TEMPLATE(BM_view_set, ByShared);
+BENCHMARK_TEMPLATE(BM_view_set, ByAtomic);
+BENCHMARK_TEMPLATE(BM_view_set, ByLazy);
+BENCHMARK_TEMPLATE(BM_view_set, ByAtomicShared);
+BENCHMARK_TEMPLATE(BM_view_set, ByAtomicRef);
+
+} // namespace numsim::propex::bench
+
+#endif // PROPERTY_VIEW_BENCHMARK_H
@@ -0,0 +1,141 @@
+#ifndef REGISTRY_BENCHMARK_H
+#define REGISTRY_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+#include "benchmark_utils.h"
+#include "perf_counters.h"
+
+namespace numsim::propex::bench {
+
+// -----------------------------------------------------------------------------
+// Registry configurations (NodePtr x Map)
+// -----------------------------------------------------------------------------
+template <template<class...> class Ptr, template<class...> class Map>
+struct RegistryConfig {
+    using node_type = node<double>;
+    using Reg = registry<std::string, node_type, Ptr, Map>;
+
+    static typename Reg::node_pointer make_node(double v) {
+        return typename Reg::node_pointer(new node_type(v));
+    }
+};
+
+using UniqueHash   = RegistryConfig<std::unique_ptr, std::unordered_map>;
+using SharedHash   = RegistryConfig<std::shared_ptr, std::unordered_map>;
+using UniqueTree   = RegistryConfig<std::unique_ptr, std::map>;
+using SharedTree   = RegistryConfig<std::shared_ptr, std::map>;
+
+/// Fills a registry with one node per key.
+template <class Config>
+void fill(typename Config::Reg& reg, const std::vector<std::string>& keys) {
+    double v{0.0};
+    for (const auto& key : keys) reg.add(Config::make_node(v++), key);
+}
+
+// -----------------------------------------------------------------------------
+// Benchmarks — args: {number of properties, key length}
+// -----------------------------------------------------------------------------
+template <class Config>
+void BM_registry_add(benchmark::State& state) {
+    const auto keys = make_keys(state.range(0), state.range(1));
+    for (auto _ : state) {
+        state.PauseTiming();
+        typename Config::Reg reg;
+        std::vector<typename Config::Reg::node_pointer> nodes;
+        nodes.reserve(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) nodes.push_back(Config::make_node(double(i)));
+        state.ResumeTiming();
+
+        for (std::size_t i = 0; i < keys.size(); ++i) reg.add(std::move(nodes[i]), keys[i]);
+        benchmark::ClobberMemory();
+
+        state.PauseTiming();
+        reg.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <class Config>
+void BM_registry_find(benchmark::State& state) {
+    const auto keys = make_keys(state.range(0), state.range(1));
+    const auto lookup = shuffled(keys);
+    typename Config::Reg reg;
+    fill<Config>(reg, keys);
+
+    std::size_t i{0};
+    perf_counters perf;
+    perf.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reg.find(lookup[i]));
+        if (++i == lookup.size()) i = 0;
+    }
+    perf.stop();
+    perf.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Config>
+void BM_registry_erase(benchmark::State& state) {
+    const auto keys = make_keys(state.range(0), state.range(1));
+    const auto order = shuffled(keys);
+    typename Config::Reg reg;
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill<Config>(reg, keys);
+        state.ResumeTiming();
+
+        for (const auto& key : order) benchmark::DoNotOptimize(reg.erase(key));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <class Config>
+void BM_registry_iterate(benchmark::State& state) {
+    const auto keys = make_keys(state.range(0), state.range(1));
+    typename Config::Reg reg;
+    fill<Config>(reg, keys);
+
+    perf_counters perf;
+    perf.start();
+    for (auto _ : state) {
+        double sum{0.0};
+        for (const auto& [key, n] : reg.data()) sum += n->get();
+        benchmark::DoNotOptimize(sum);
+    }
+    perf.stop();
+    perf.report(state);
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+/// Property counts below / above typical cache sizes, keys inside / outside SSO.
+inline void registry_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "key_len"});
+    for (long n : {1L << 10, 1L << 16})
+        for (long len : {8L, 64L})
+            b->Args({n, len});
+}
+
+#define PROPEX_REGISTRY_BENCHMARKS(Config)                                   \
+    BENCHMARK_TEMPLATE(BM_registry_add, Config)->Apply(registry_args);      \
+    BENCHMARK_TEMPLATE(BM_registry_find, Config)->Apply(registry_args);     \
+    BENCHMARK_TEMPLATE(BM_registry_erase, Config)->Apply(registry_args);    \
+    BENCHMARK_TEMPLATE(BM_registry_iterate, Config)->Apply(registry_args)
+
+PROPEX_REGISTRY_BENCHMARKS(UniqueHash);
+PROPEX_REGISTRY_BENCHMARKS(SharedHash);
+PROPEX_REGISTRY_BENCHMARKS(UniqueTree);
+PROPEX_REGISTRY_BENCHMARKS(SharedTree);
+
+#undef PROPEX_REGISTRY_BENCHMARKS
+
+} // namespace numsim::propex::bench
+
+#endif // REGISTRY_BENCHMARK_H
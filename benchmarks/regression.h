@@ -0,0 +1,336 @@
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+/**
+ * @file regression.h
+ * @brief Baseline storage and statistical comparison for the propex benchmarks.
+ *
+ * The benchmark executable understands a few extra flags on top of the
+ * Google Benchmark ones:
+ *
+ *  - `--propex_save_baseline=<file>`  store every repetition of every benchmark
+ *  - `--propex_compare=<file>`        compare this run against a stored baseline
+ *  - `--propex_threshold=<fraction>`  tolerated slowdown (default `0.05`, i.e. 5 %)
+ *  - `--propex_gate=<regex>`          benchmarks that fail the run on regression
+ *                                     (default: lookup, view get/set and iteration)
+ *
+ * Each benchmark is summarized by the median of its repetitions. A benchmark
+ * counts as regressed only if the lower bound of the 95 % bootstrap confidence
+ * interval of `median(new) / median(baseline)` exceeds `1 + threshold`, so a
+ * single noisy repetition cannot fail the run. Baselines are plain text files
+ * (`name<TAB>t0 t1 ...`, nanoseconds per iteration) and never leave the machine.
+ *
+ * Exit codes: 0 success, 1 I/O or Google Benchmark failure, 2 gated
+ * regression, 64 (`EX_USAGE`) malformed `--propex_*` flag.
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace numsim::propex::bench::regression {
+
+/// Per-benchmark samples, in nanoseconds of real time per iteration.
+using sample_map = std::map<std::string, std::vector<double>>;
+
+/// Options consumed from the command line before Google Benchmark sees it.
+struct options {
+    std::string save_baseline;
+    std::string compare;
+    double threshold{0.05};
+    std::string gate{"BM_registry_find|BM_registry_iterate|BM_view_get|BM_view_set"};
+    std::regex gate_pattern;  ///< `gate`, compiled by `parse()`
+    bool repetitions_given{false};
+    bool aggregates_only{false};
+};
+
+/// Result of comparing one benchmark against its baseline.
+struct comparison {
+    std::string name;
+    double baseline_median{};
+    double median{};
+    double ratio{};
+    double ci_low{};
+    double ci_high{};
+    bool gated{};
+    bool regressed{};
+};
+
+/**
+ * @brief Console reporter that additionally records every iteration run.
+ *
+ * Google Benchmark withholds individual repetitions from the display reporter
+ * under `--benchmark_display_aggregates_only`, so that flag is handled here:
+ * all runs are collected, only aggregates are printed.
+ */
+class collecting_reporter final : public benchmark::ConsoleReporter {
+public:
+    explicit collecting_reporter(bool aggregates_only = false) noexcept
+        : aggregates_only_(aggregates_only) {}
+
+    void ReportRuns(const std::vector<Run>& reports) override {
+        std::vector<Run> shown;
+        for (const auto& run : reports) {
+            const bool iteration = run.run_type == Run::RT_Iteration;
+            if (!aggregates_only_ || !iteration) shown.push_back(run);
+            if (!iteration || run.error_occurred || run.iterations == 0) continue;
+            samples_[run.benchmark_name()].push_back(
+                run.real_accumulated_time / static_cast<double>(run.iterations) * 1e9);
+        }
+        if (!shown.empty()) ConsoleReporter::ReportRuns(shown);
+    }
+
+    [[nodiscard]] const sample_map& samples() const noexcept { return samples_; }
+
+private:
+    bool aggregates_only_;
+    sample_map samples_;
+};
+
+[[nodiscard]] inline double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    const auto mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    const double upper = v[mid];
+    if (v.size() % 2 != 0) return upper;
+    return 0.5 * (upper + *std::max_element(v.begin(), v.begin() + mid));
+}
+
+/**
+ * @brief 95 % percentile-bootstrap interval of `median(current) / median(baseline)`.
+ *
+ * Uses a fixed seed so that re-running a comparison on the same data is
+ * reproducible.
+ */
+[[nodiscard]] inline std::pair<double, double>
+bootstrap_ratio_ci(const std::vector<double>& baseline, const std::vector<double>& current,
+                   std::size_t resamples = 2000) {
+    std::mt19937_64 gen(0x5eed);
+    std::vector<double> ratios;
+    ratios.reserve(resamples);
+    std::vector<double> b(baseline.size()), c(current.size());
+    std::uniform_int_distribution<std::size_t> pick_b(0, baseline.size() - 1);
+    std::uniform_int_distribution<std::size_t> pick_c(0, current.size() - 1);
+    for (std::size_t r = 0; r < resamples; ++r) {
+        for (auto& x : b) x = baseline[pick_b(gen)];
+        for (auto& x : c) x = current[pick_c(gen)];
+        const double mb = median(b);
+        if (mb > 0.0) ratios.push_back(median(c) / mb);
+    }
+    if (ratios.empty()) return {0.0, 0.0};
+    std::sort(ratios.begin(), ratios.end());
+    const auto at = [&](double q) { return ratios[static_cast<std::size_t>(q * double(ratios.size() - 1))]; };
+    return {at(0.025), at(0.975)};
+}
+
+/// Writes all samples as `name<TAB>t0 t1 ...` lines.
+inline bool save(const std::string& path, const sample_map& samples) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out.precision(17);
+    for (const auto& [name, times] : samples) {
+        out << name << '\t';
+        for (std::size_t i = 0; i < times.size(); ++i) out << (i ? " " : "") << times[i];
+        out << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+/// Reads a baseline written by @ref save.
+/// @throws std::runtime_error if the file cannot be opened.
+inline sample_map load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("regression::load(): cannot open baseline '" + path + "'");
+    sample_map samples;
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto tab = line.find('\t');
+        if (tab == std::string::npos) continue;
+        std::istringstream values(line.substr(tab + 1));
+        auto& times = samples[line.substr(0, tab)];
+        for (double t; values >> t;) times.push_back(t);
+    }
+    return samples;
+}
+
+/// Compares every benchmark present in both sample sets.
+inline std::vector<comparison> compare(const sample_map& baseline, const sample_map& current,
+                                       double threshold, const std::regex& gate) {
+    std::vector<comparison> result;
+    for (const auto& [name, times] : current) {
+        const auto it = baseline.find(name);
+        if (it == baseline.end() || it->second.empty() || times.empty()) continue;
+
+        comparison c;
+        c.name = name;
+        c.baseline_median = median(it->second);
+        c.median = median(times);
+        c.ratio = c.baseline_median > 0.0 ? c.median / c.baseline_median : 0.0;
+        std::tie(c.ci_low, c.ci_high) = bootstrap_ratio_ci(it->second, times);
+        c.gated = std::regex_search(name, gate);
+        c.regressed = c.gated && c.ci_low > 1.0 + threshold;
+        result.push_back(std::move(c));
+    }
+    return result;
+}
+
+/// Prints a comparison table; returns the number of gated regressions.
+inline std::size_t report(std::ostream& os, const std::vector<comparison>& results, double threshold) {
+    std::size_t regressions{0};
+    os << "\nComparison against baseline (threshold " << threshold * 100.0 << " %)\n";
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-64s %12s %12s %8s %18s\n",
+                  "Benchmark", "base [ns]", "new [ns]", "ratio", "95% CI");
+    os << line;
+    for (const auto& c : results) {
+        const char* verdict = c.regressed ? "  REGRESSION"
+                            : (c.ci_high < 1.0 - threshold ? "  faster" : "");
+        std::snprintf(line, sizeof(line), "%-64s %12.2f %12.2f %8.3f    [%6.3f, %6.3f]%s%s\n",
+                      c.name.c_str(), c.baseline_median, c.median, c.ratio, c.ci_low, c.ci_high,
+                      c.gated ? "" : "  (not gated)", verdict);
+        os << line;
+        if (c.regressed) ++regressions;
+    }
+    return regressions;
+}
+
+/**
+ * @brief Parses the value of `--propex_threshold`.
+ * @throws std::invalid_argument unless @p v is a positive number.
+ */
+inline double parse_threshold(std::string_view v) {
+    double threshold{};
+    const auto [end, ec] = std::from_chars(v.data(), v.data() + v.size(), threshold);
+    if (ec != std::errc{} || end != v.data() + v.size() || !(threshold > 0.0) || !std::isfinite(threshold))
+        throw std::invalid_argument("--propex_threshold: expected a positive fraction such as 0.05, got '"
+                                    + std::string(v) + "'");
+    return threshold;
+}
+
+/**
+ * @brief Removes the `--propex_*` flags from @p argv and returns them.
+ *
+ * Also notes whether `--benchmark_repetitions` was given, so that baseline
+ * and compare runs can default to enough repetitions for the statistics, and
+ * takes over `--benchmark_display_aggregates_only` (see @ref collecting_reporter).
+ * @throws std::invalid_argument for malformed flag values, including a `--propex_gate`
+ *         that is not a valid regular expression.
+ */
+inline options parse(int& argc, char** argv) {
+    options opt;
+    const auto value = [](std::string_view arg, std::string_view flag, std::string& out) {
+        if (arg.substr(0, flag.size()) != flag) return false;
+        out = std::string(arg.substr(flag.size()));
+        return true;
+    };
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        std::string v;
+        if (value(arg, "--propex_save_baseline=", opt.save_baseline)) continue;
+        if (value(arg, "--propex_compare=", opt.compare)) continue;
+        if (value(arg, "--propex_gate=", opt.gate)) continue;
+        if (value(arg, "--propex_threshold=", v)) {
+            opt.threshold = parse_threshold(v);
+            continue;
+        }
+        if (value(arg, "--benchmark_display_aggregates_only", v)) {
+            opt.aggregates_only = v.empty() || v == "=true" || v == "=1";
+            continue;
+        }
+        if (arg.substr(0, 24) == "--benchmark_repetitions=") opt.repetitions_given = true;
+        argv[kept++] = argv[i];
+    }
+    argc = kept;
+    try {
+        opt.gate_pattern = std::regex(opt.gate);
+    } catch (const std::regex_error& e) {
+        throw std::invalid_argument("--propex_gate: '" + opt.gate + "' is not a valid regular expression ("
+                                    + e.what() + ")");
+    }
+    return opt;
+}
+
+/// Exit code of @ref run for a gated regression.
+inline constexpr int exit_regression = 2;
+
+/// Exit code of @ref run for malformed `--propex_*` flags (`EX_USAGE`), distinct from a regression.
+inline constexpr int exit_usage = 64;
+
+/// Default number of repetitions for baseline/compare runs.
+inline constexpr const char* default_repetitions = "--benchmark_repetitions=10";
+
+/**
+ * @brief Entry point shared by the benchmark executable.
+ * @return `exit_regression` if a gated benchmark regressed, `exit_usage` for
+ *         malformed flags, 1 if the baseline is unreadable, 0 otherwise.
+ */
+inline int run(int argc, char** argv) {
+    options opt;
+    try {
+        opt = parse(argc, argv);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "usage error: " << e.what() << '\n';
+        return exit_usage;
+    }
+
+    // Fail before spending minutes on benchmarks if the baseline is unusable.
+    sample_map baseline;
+    if (!opt.compare.empty()) {
+        try {
+            baseline = load(opt.compare);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    std::vector<char*> args(argv, argv + argc);
+    std::string repetitions{default_repetitions};
+    if ((!opt.save_baseline.empty() || !opt.compare.empty()) && !opt.repetitions_given)
+        args.push_back(repetitions.data());
+    int n = static_cast<int>(args.size());
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&n, args.data());
+    if (benchmark::ReportUnrecognizedArguments(n, args.data())) return 1;
+
+    collecting_reporter reporter(opt.aggregates_only);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    if (!opt.save_baseline.empty()) {
+        if (!save(opt.save_baseline, reporter.samples())) {
+            std::cerr << "cannot write baseline '" << opt.save_baseline << "'\n";
+            return 1;
+        }
+        std::cout << "Baseline written to " << opt.save_baseline << '\n';
+    }
+
+    if (!opt.compare.empty()) {
+        const auto results = compare(baseline, reporter.samples(), opt.threshold, opt.gate_pattern);
+        const auto regressions = report(std::cout, results, opt.threshold);
+        if (regressions > 0) {
+            std::cout << regressions << " significant regression(s)\n";
+            return exit_regression;
+        }
+    }
+    return 0;
+}
+
+} // namespace numsim::propex::bench::regression
+
+#endif // REGRESSION_H
@@ -0,0 +1,59 @@
+#ifndef SCHEDULER_BENCHMARK_H
+#define SCHEDULER_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "propex/propex_scheduler.h"
+
+namespace numsim::propex::bench {
+
+/// Submit + wait of `range(0)` empty tasks: the per-task overhead of the pool.
+void BM_scheduler_task_overhead(benchmark::State& state) {
+    work_stealing_scheduler pool(scheduler_options{.workers = 2});
+    const auto tasks = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        task_group g;
+        for (std::size_t i = 0; i < tasks; ++i) pool.run(g, [] {});
+        pool.wait(g);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// Baseline for the overhead: one `std::jthread` per task.
+void BM_scheduler_thread_per_task(benchmark::State& state) {
+    const auto tasks = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        std::vector<std::jthread> threads;
+        threads.reserve(tasks);
+        for (std::size_t i = 0; i < tasks; ++i) threads.emplace_back([] {});
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// `parallel_for` over 1M elements with `range(0)` workers (0: default size); scales only up to the machine's cores.
+void BM_scheduler_parallel_for_scaling(benchmark::State& state) {
+    work_stealing_scheduler pool(scheduler_options{.workers = static_cast<std::size_t>(state.range(0))});
+    std::vector<double> x(1 << 20, 1.0);
+    for (auto _ : state) {
+        parallel_for(pool, x.size(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) x[i] = std::sqrt(x[i] * 1.0001 + 0.5);
+        });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(x.size()));
+    state.counters["hw_threads"] = std::thread::hardware_concurrency();
+}
+
+BENCHMARK(BM_scheduler_task_overhead)->Arg(1)->Arg(1000);
+BENCHMARK(BM_scheduler_thread_per_task)->Arg(1)->Arg(1000);
+BENCHMARK(BM_scheduler_parallel_for_scaling)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+} // namespace numsim::propex::bench
+
+#endif // SCHEDULER_BENCHMARK_H
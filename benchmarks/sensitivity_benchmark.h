@@ -0,0 +1,71 @@
+#ifndef SENSITIVITY_BENCHMARK_H
+#define SENSITIVITY_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "propex/propex_formula.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+#include "propex/propex_sensitivity.h"
+
+namespace numsim::propex::bench {
+
+/// Degree-7 polynomial `y = p0 + x*(p1 + x*(... + x*p7))` over a field of `range(0)` elements.
+struct polynomial_fixture {
+    static constexpr std::size_t parameters = 8;
+    registry<std::string, node_base> reg;
+    std::string text = "y = p0";
+    std::size_t n;
+
+    explicit polynomial_fixture(std::size_t size) : n(size) {
+        for (std::size_t k = 0; k < parameters; ++k)
+            reg.add(std::make_unique<node<double>>(1.0 / static_cast<double>(k + 1)), "p" + std::to_string(k));
+        std::string tail = "p7";
+        for (std::size_t k = parameters - 1; k-- > 1;) tail = "p" + std::to_string(k) + " + x*(" + tail + ")";
+        text += " + x*(" + tail + ")";
+        reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(n, 0.5)), "x");
+        reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(n)), "y");
+    }
+};
+
+/// Baseline: forward differences, one extra evaluation per parameter.
+void BM_sensitivity_finite_difference(benchmark::State& state) {
+    polynomial_fixture f(static_cast<std::size_t>(state.range(0)));
+    const formula poly = compile_formula(f.reg, f.text);
+    std::vector<double> base(f.n), perturbed(f.n), derivatives(polynomial_fixture::parameters * f.n);
+    for (auto _ : state) {
+        poly.evaluate(base);
+        for (std::size_t k = 0; k < polynomial_fixture::parameters; ++k) {
+            auto* p = static_cast<node<double>*>(f.reg.find("p" + std::to_string(k)));
+            const double value = p->get(), h = 1e-7;
+            p->set(value + h);
+            poly.evaluate(perturbed);
+            p->set(value);
+            for (std::size_t i = 0; i < f.n; ++i) derivatives[k * f.n + i] = (perturbed[i] - base[i]) / h;
+        }
+        benchmark::DoNotOptimize(derivatives.data());
+    }
+}
+
+/// One dual-number pass seeded with all parameters.
+void BM_sensitivity_forward_mode(benchmark::State& state) {
+    polynomial_fixture f(static_cast<std::size_t>(state.range(0)));
+    const formula poly = compile_formula(f.reg, f.text);
+    for (auto _ : state) {
+        sensitivity_pass pass(f.reg, {"p0", "p1", "p2", "p3", "p4", "p5", "p6", "p7"});
+        pass.apply(poly);
+        benchmark::DoNotOptimize(pass.derivatives("y").data());
+    }
+}
+
+BENCHMARK(BM_sensitivity_finite_difference)->Arg(1 << 14);
+BENCHMARK(BM_sensitivity_forward_mode)->Arg(1 << 14);
+
+} // namespace numsim::propex::bench
+
+#endif // SENSITIVITY_BENCHMARK_H
@@ -0,0 +1,97 @@
+#ifndef TABULATED_BENCHMARK_H
+#define TABULATED_BENCHMARK_H
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_node.h"
+#include "propex/propex_tabulated.h"
+#include "benchmark_utils.h"
+
+namespace numsim::propex::bench {
+
+/// Quadrature points evaluated per batch call.
+inline constexpr std::size_t table_points = std::size_t{1} << 20;
+
+/// A temperature table with `range(0)` points and random temperatures inside it.
+struct table_fixture {
+    std::vector<double> xs, ys, points, out;
+
+    explicit table_fixture(std::size_t size, bool equidistant) : xs(size), ys(size) {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> jitter(0.0, 0.4);
+        for (std::size_t i = 0; i < size; ++i) {
+            xs[i] = 250.0 + 10.0 * (static_cast<double>(i) + (equidistant ? 0.0 : jitter(gen)));
+            ys[i] = 210e9 * std::exp(-1e-4 * xs[i]);
+        }
+        std::uniform_real_distribution<double> temperature(xs.front(), xs.back());
+        points.resize(table_points);
+        for (auto& x : points) x = temperature(gen);
+        out.resize(table_points);
+    }
+};
+
+/// Baseline: what user code did so far — linear search and linear interpolation per point.
+void BM_table_linear_search(benchmark::State& state) {
+    table_fixture f(static_cast<std::size_t>(state.range(0)), false);
+    for (auto _ : state) {
+        for (std::size_t j = 0; j < f.points.size(); ++j) {
+            const double x = f.points[j];
+            std::size_t i = 0;
+            while (i + 2 < f.xs.size() && f.xs[i + 1] <= x) ++i;
+            const double t = (x - f.xs[i]) / (f.xs[i + 1] - f.xs[i]);
+            f.out[j] = f.ys[i] + t * (f.ys[i + 1] - f.ys[i]);
+        }
+        benchmark::DoNotOptimize(f.out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(table_points));
+}
+
+/// One `eval(x)` call per point through a view.
+template <table_search Search, interpolation Kind>
+void BM_table_eval_scalar(benchmark::State& state) {
+    table_fixture f(static_cast<std::size_t>(state.range(0)), Search == table_search::uniform);
+    node<tabulated, ownership::by_value> n(tabulated(f.xs, f.ys, Kind, Search));
+    property_view<tabulated, node, ownership::by_value> view(&n);
+    for (auto _ : state) {
+        for (std::size_t j = 0; j < f.points.size(); ++j) f.out[j] = view.eval(f.points[j]);
+        benchmark::DoNotOptimize(f.out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(table_points));
+}
+
+/// One `eval(xs, out)` call for all points through a view.
+template <table_search Search, interpolation Kind>
+void BM_table_eval_batch(benchmark::State& state) {
+    table_fixture f(static_cast<std::size_t>(state.range(0)), Search == table_search::uniform);
+    node<tabulated, ownership::by_value> n(tabulated(f.xs, f.ys, Kind, Search));
+    property_view<tabulated, node, ownership::by_value> view(&n);
+    for (auto _ : state) {
+        view.eval(f.points, f.out);
+        benchmark::DoNotOptimize(f.out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(table_points));
+}
+
+BENCHMARK(BM_table_linear_search)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_table_eval_scalar, table_search::uniform, interpolation::linear)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_table_eval_scalar, table_search::eytzinger, interpolation::linear)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_table_eval_batch, table_search::uniform, interpolation::linear)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_table_eval_batch, table_search::eytzinger, interpolation::linear)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_table_eval_batch, table_search::uniform, interpolation::cubic)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_table_eval_batch, table_search::eytzinger, interpolation::cubic)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
+
+} // namespace numsim::propex::bench
+
+#endif // TABULATED_BENCHMARK_H
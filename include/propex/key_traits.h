@@ -17,9 +17,11 @@
 #ifndef KEY_TRAITS_H
 #define KEY_TRAITS_H
 
+#include <memory>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -46,10 +48,18 @@ namespace numsim::propex {
 template <typename KeyType, char Delimiter = ':'>
 struct key_traits;
 
-template <char Delimiter>
-struct key_traits<std::string, Delimiter> {
-    using key_type = std::string;
-    using view_type = std::basic_string_view<typename key_type::value_type>;
+/**
+ * @brief Specialization for all `std::basic_string` instantiations.
+ *
+ * Covers `std::string` as well as allocator-aware keys such as
+ * `std::pmr::string`; `merge()` can construct the key with a given allocator
+ * so that it lives in the same memory resource as the registry.
+ */
+template <class CharT, class Traits, class Alloc, char Delimiter>
+struct key_traits<std::basic_string<CharT, Traits, Alloc>, Delimiter> {
+    using key_type = std::basic_string<CharT, Traits, Alloc>;
+    using view_type = std::basic_string_view<CharT, Traits>;
+    using allocator_type = Alloc;
 
     /**
      * @brief Splits a delimited key string into subkeys.
@@ -88,12 +98,27 @@ struct key_traits<std::string, Delimiter> {
      * @return A merged `KeyType` key (e.g., `"object:property"`).
      */
     template <typename... Args>
+        requires (!(std::is_same_v<Args, std::allocator_arg_t> || ...))
     [[nodiscard]]
     static constexpr inline key_type merge(const Args&... args) {
+        return merge(std::allocator_arg, allocator_type{}, args...);
+    }
+
+    /**
+     * @brief Merges subkeys into a key that uses the allocator @p alloc.
+     *
+     * @param alloc Allocator of the resulting key (e.g. the registry's memory resource).
+     * @param args  The subkeys to concatenate.
+     */
+    template <typename... Args>
+    [[nodiscard]]
+    static constexpr inline key_type merge(std::allocator_arg_t, const allocator_type& alloc,
+                                           const Args&... args) {
         if constexpr (sizeof...(Args) == 0)
-            return {};
+            return key_type(alloc);
 
-        key_type result;
+        key_type result(alloc);
+        result.reserve((std::size_t{0} + ... + view_type(args).size()) + sizeof...(Args));
         ((result.append(args).append(1, Delimiter)), ...);
         if (!result.empty()) result.pop_back(); // remove trailing delimiter
         return result;
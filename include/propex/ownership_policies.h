@@ -20,7 +20,20 @@
 
 #include <stdexcept>
 #include <memory>
+#include <array>
 #include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "propex_field.h"
 
 namespace ownership {
 
@@ -45,6 +58,9 @@ struct by_value {
     /// Constructs a new instance with a copy of @p v.
     explicit by_value(const T& v) : value(v) {}
 
+    /// Constructs a new instance by moving @p v in.
+    explicit by_value(T&& v) noexcept(std::is_nothrow_move_constructible_v<T>) : value(std::move(v)) {}
+
     /// Returns a mutable reference to the stored value.
     T& get() noexcept { return value; }
 
@@ -121,6 +137,42 @@ struct by_shared {
     const T& get() const noexcept { return *ptr; }
 };
 
+/**
+ * @brief Publishes immutable values through an atomic shared pointer.
+ *
+ * Unlike `by_shared`, replacing the value is safe while other threads read:
+ * a writer builds a complete new value and publishes it with one atomic
+ * store. Readers get a `std::shared_ptr<const T>` snapshot, which keeps the
+ * version they loaded alive for as long as they hold it, even after a newer
+ * version has been published. Readers never see a partially written value.
+ *
+ * Intended for large values that change rarely and are read often
+ * (material tables, meshes). Each read costs an atomic reference count
+ * increment, so hot loops should load the snapshot once and reuse it.
+ *
+ * @tparam T Value type.
+ *
+ * @code
+ * ownership::by_atomic_shared<table> t(std::make_shared<const table>(load()));
+ * auto snapshot = t.get();                            // shared_ptr<const table>
+ * t.publish(std::make_shared<const table>(reload())); // readers keep their snapshot
+ * @endcode
+ */
+template <class T>
+struct by_atomic_shared {
+    /// The currently published value.
+    std::atomic<std::shared_ptr<const T>> ptr;
+
+    /// Constructs a new instance publishing @p p.
+    explicit by_atomic_shared(std::shared_ptr<const T> p) noexcept : ptr(std::move(p)) {}
+
+    /// Returns a snapshot of the currently published value.
+    std::shared_ptr<const T> get() const noexcept { return ptr.load(std::memory_order_acquire); }
+
+    /// Atomically replaces the published value with @p p.
+    void publish(std::shared_ptr<const T> p) noexcept { ptr.store(std::move(p), std::memory_order_release); }
+};
+
 /**
  * @brief Owns a value stored in an atomic variable.
  *
@@ -156,12 +208,444 @@ struct by_atomic {
     void set(T v) noexcept { value.store(v, std::memory_order_relaxed); }
 };
 
+/**
+ * @brief Constructs the value on first access from a stored factory.
+ *
+ * The `by_lazy` ownership policy defers building expensive values (lookup
+ * tables, preconditioners) until they are first read. The first `get()`
+ * runs the factory exactly once, even when several threads race for it;
+ * every later access is a single acquire load of the ready flag. A `set()`
+ * before the first `get()` replaces the factory's result, so the factory
+ * never runs.
+ *
+ * If the factory throws, the exception propagates and the next `get()`
+ * retries. The factory is released once the value exists.
+ *
+ * @tparam T Value type.
+ *
+ * @code
+ * ownership::by_lazy<table> t([] { return build_table(); });
+ * const table& ref = t.get(); // builds the table now
+ * @endcode
+ */
+template <class T>
+class by_lazy {
+public:
+    using factory_type = std::function<T()>;
+
+    /// Stores @p factory; nothing is constructed yet.
+    explicit by_lazy(factory_type factory) : factory_(std::move(factory)) {}
+
+    /// Constructs an already initialized instance holding a copy of @p v.
+    explicit by_lazy(const T& v) { emplace(v); }
+
+    /// Constructs an already initialized instance by moving @p v in.
+    explicit by_lazy(T&& v) { emplace(std::move(v)); }
+
+    by_lazy(const by_lazy&) = delete;
+    by_lazy& operator=(const by_lazy&) = delete;
+
+    /// @return `true` once the value has been constructed.
+    [[nodiscard]] bool initialized() const noexcept { return ready_.load(std::memory_order_acquire); }
+
+    /// Returns the value, constructing it on first use.
+    const T& get() const {
+        if (!ready_.load(std::memory_order_acquire)) [[unlikely]] initialize();
+        return *value_;
+    }
+
+    /// Returns a mutable reference to the value, constructing it on first use.
+    T& get() {
+        std::as_const(*this).get();
+        return *value_;
+    }
+
+    /// Assigns @p v; before the first `get()` this replaces the factory.
+    template <class U>
+    void set(U&& v) noexcept(std::is_nothrow_constructible_v<T, U> && std::is_nothrow_assignable_v<T&, U>) {
+        if (ready_.load(std::memory_order_acquire)) [[likely]]
+            *value_ = std::forward<U>(v);
+        else
+            set_first(T(std::forward<U>(v)));
+    }
+
+private:
+    // Kept out of line so the initialized fast path neither needs a stack
+    // frame nor forces the argument into memory.
+    [[gnu::noinline]] void set_first(T&& v) {
+        {
+            const std::lock_guard lock(mutex_);
+            if (!ready_.load(std::memory_order_relaxed)) {
+                emplace(std::move(v));
+                return;
+            }
+        }
+        *value_ = std::move(v);  // another thread's get() was faster
+    }
+
+    // A mutex rather than std::call_once: a throwing factory simply leaves
+    // ready_ unset, without relying on exceptional call_once (GCC PR 66146).
+    [[gnu::noinline]] void initialize() const {
+        const std::lock_guard lock(mutex_);
+        if (!ready_.load(std::memory_order_relaxed)) emplace(factory_());
+    }
+
+    template <class U>
+    void emplace(U&& v) const {
+        value_.emplace(std::forward<U>(v));
+        factory_ = nullptr;
+        ready_.store(true, std::memory_order_release);
+    }
+
+    mutable factory_type factory_;
+    mutable std::optional<T> value_;
+    mutable std::atomic<bool> ready_{false};
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief Keeps the last `K` values of a property in a ring buffer.
+ *
+ * Multistep integrators (BDF, Adams) and history-dependent material laws
+ * read `u_n`, `u_{n-1}`, ... `u_{n-K+1}`. `get()` returns the current value,
+ * `get(lag)` an older one, and `advance()` starts a new step by rotating the
+ * ring index in O(1) without copying or moving any value.
+ *
+ * After `advance()`, the current slot is the recycled oldest slot. It still
+ * holds the oldest value (and, for containers, its capacity) until the step's
+ * result is written with `set()` or through `get_mutable()`.
+ *
+ * Use it as a node policy through the single-parameter alias
+ * `history<K>::type`.
+ *
+ * @tparam T Value type.
+ * @tparam K Number of stored values (current one included), `K >= 1`.
+ *
+ * @code
+ * node<double, ownership::history<3>::type> u(0.0);
+ * u.set(1.0);
+ * u.advance();                 // u_{n-1} = 1.0
+ * u.set(2.0);
+ * double prev = u.get(1);      // 1.0
+ * @endcode
+ */
+template <class T, std::size_t K>
+struct by_history {
+    static_assert(K >= 1, "by_history needs at least one slot");
+
+    /// Ring of values; `values[head]` is the current one.
+    std::array<T, K> values;
+    /// Index of the current value.
+    std::size_t head{0};
+
+    /// Constructs the history with every slot set to @p v.
+    explicit by_history(const T& v) : values(filled(v, std::make_index_sequence<K>{})) {}
+
+    /// Constructs the history from @p v: `K - 1` copies, and @p v itself moved into the current slot.
+    explicit by_history(T&& v) : values(filled_moving(std::move(v), std::make_index_sequence<K - 1>{})) {}
+
+    /// Number of values kept.
+    static constexpr std::size_t depth() noexcept { return K; }
+
+    /// Returns the current value.
+    const T& get() const noexcept { return values[head]; }
+
+    /// Returns a mutable reference to the current value.
+    T& get_mutable() noexcept { return values[head]; }
+
+    /**
+     * @brief Returns the value @p lag steps back (`get(0) == get()`).
+     * @throws std::out_of_range if `lag >= K`.
+     */
+    const T& get(std::size_t lag) const {
+        if (lag >= K) throw std::out_of_range("by_history: lag exceeds history depth");
+        return values[head >= lag ? head - lag : head + K - lag];
+    }
+
+    /// Makes the current value the previous one (O(1), no copies).
+    void advance() noexcept { head = head + 1 == K ? 0 : head + 1; }
+
+private:
+    template <std::size_t... I>
+    static std::array<T, K> filled(const T& v, std::index_sequence<I...>) {
+        return {{((void)I, v)...}};
+    }
+
+    // Braced initializers are evaluated left to right: the copies are made before the move.
+    template <std::size_t... I>
+    static std::array<T, K> filled_moving(T&& v, std::index_sequence<I...>) {
+        return {{((void)I, v)..., std::move(v)}};
+    }
+};
+
+/// Adapts `by_history<T, K>` to the single-parameter policy slot of `node`.
+template <std::size_t K>
+struct history {
+    template <class T>
+    using type = by_history<T, K>;
+};
+
+/**
+ * @brief Atomic access to an external value through `std::atomic_ref`.
+ *
+ * Like `by_reference`, the policy points into storage owned elsewhere (e.g.
+ * a solver array). Every read and write goes through `std::atomic_ref<T>`,
+ * so the array can be shared with worker threads without copies or locks.
+ * All concurrent accesses to the referenced object must go through atomic
+ * operations for as long as any of them may race.
+ *
+ * Loads use @p Load and stores use @p Store. `by_atomic_ref<T>` is the relaxed
+ * variant (matching `by_atomic`), which gives atomicity only. Use
+ * `atomic_ref_order<std::memory_order_acquire, std::memory_order_release>::type`
+ * when a store must publish other data.
+ *
+ * @tparam T     Trivially copyable value type.
+ * @tparam Load  Memory order of `get()`.
+ * @tparam Store Memory order of `set()`.
+ *
+ * @code
+ * std::vector<double> u(n);                      // owned by the solver
+ * node<double, ownership::by_atomic_ref> un(u[i]);
+ * un.set(1.0);                                   // atomic store into u[i]
+ * un.ref().fetch_add(0.5);                       // read-modify-write
+ * @endcode
+ */
+template <class T, std::memory_order Load, std::memory_order Store>
+struct basic_atomic_ref {
+    static_assert(std::is_trivially_copyable_v<T>, "by_atomic_ref requires a trivially copyable type");
+    static_assert(Load != std::memory_order_release && Load != std::memory_order_acq_rel,
+                  "invalid memory order for a load");
+    static_assert(Store != std::memory_order_consume && Store != std::memory_order_acquire
+                  && Store != std::memory_order_acq_rel, "invalid memory order for a store");
+
+    /// Pointer to the external value.
+    T* ptr{};
+
+    /// Constructs a new instance referring to @p ref.
+    /// @throws std::invalid_argument if @p ref is not aligned to `std::atomic_ref<T>::required_alignment`.
+    explicit basic_atomic_ref(T& ref) : ptr(&ref) {
+        if (reinterpret_cast<std::uintptr_t>(ptr) % std::atomic_ref<T>::required_alignment != 0)
+            throw std::invalid_argument("by_atomic_ref: storage is not suitably aligned");
+    }
+
+    /// Returns an `atomic_ref` to the external value for read-modify-write operations.
+    std::atomic_ref<T> ref() const noexcept { return std::atomic_ref<T>(*ptr); }
+
+    /// Atomically loads the external value.
+    T get() const noexcept { return ref().load(Load); }
+
+    /// Atomically stores @p v into the external value.
+    void set(T v) const noexcept { ref().store(v, Store); }
+};
+
+/// `basic_atomic_ref` with relaxed loads and stores.
+template <class T>
+using by_atomic_ref = basic_atomic_ref<T, std::memory_order_relaxed, std::memory_order_relaxed>;
+
+/// Selects the memory orders of `basic_atomic_ref` for use as a node policy.
+template <std::memory_order Load, std::memory_order Store = Load>
+struct atomic_ref_order {
+    template <class T>
+    using type = basic_atomic_ref<T, Load, Store>;
+};
+
+/**
+ * @brief Test-and-test-and-set spinlock meeting the `Lockable` requirements.
+ *
+ * Waiters spin on a relaxed load (with a CPU pause hint) so that contended
+ * cache lines are only written when the lock looks free. After `spin_limit`
+ * rounds they yield the CPU, so a preempted holder can run instead of
+ * waiters burning whole timeslices. Meant for critical sections of a few
+ * hundred nanoseconds; use `by_rwlock` for longer ones.
+ */
+class spinlock {
+public:
+    spinlock() noexcept = default;
+    spinlock(const spinlock&) = delete;
+    spinlock& operator=(const spinlock&) = delete;
+
+    /// Pause rounds a waiter spins before it starts yielding.
+    static constexpr unsigned spin_limit = 64;
+
+    void lock() noexcept {
+        while (locked_.exchange(true, std::memory_order_acquire)) {
+            for (unsigned spins = 0; locked_.load(std::memory_order_relaxed); ++spins) {
+                if (spins < spin_limit) relax();
+                else std::this_thread::yield();
+            }
+        }
+    }
+
+    [[nodiscard]] bool try_lock() noexcept {
+        return !locked_.load(std::memory_order_relaxed)
+            && !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+private:
+    static void relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    std::atomic<bool> locked_{false};
+};
+
+/**
+ * @brief Guards a value with a per-node spinlock.
+ *
+ * For large, non-atomic values (matrices, small tensors) that writers
+ * update in place and readers copy out, without a registry-wide lock.
+ * `get()` returns a snapshot copied under the lock. `set()` builds the new
+ * value before locking and only swaps it in while holding the lock, so the
+ * critical section never allocates. `with_lock(fn)` runs `fn(T&)` under the
+ * lock for in-place updates.
+ *
+ * @tparam T Value type (copyable).
+ *
+ * @code
+ * ownership::by_spinlock<mat3> m(mat3::identity());
+ * m.with_lock([](mat3& a) { a(0, 0) += 1.0; });
+ * mat3 copy = m.get();
+ * @endcode
+ */
+template <class T>
+class by_spinlock {
+public:
+    /// Constructs a new instance holding a copy of @p v.
+    explicit by_spinlock(const T& v) : value_(v) {}
+
+    /// Constructs a new instance by moving @p v in.
+    explicit by_spinlock(T&& v) noexcept(std::is_nothrow_move_constructible_v<T>) : value_(std::move(v)) {}
+
+    by_spinlock(const by_spinlock&) = delete;
+    by_spinlock& operator=(const by_spinlock&) = delete;
+
+    /// Returns a copy of the value taken under the lock; throws whatever copying `T` throws.
+    T get() const noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        std::lock_guard guard(lock_);
+        return value_;
+    }
+
+    /// Replaces the value; only the swap happens under the lock.
+    template <class U>
+    void set(U&& v) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::lock_guard guard(lock_);
+            value_ = std::forward<U>(v);
+        } else {
+            T fresh(std::forward<U>(v));
+            std::lock_guard guard(lock_);
+            using std::swap;
+            swap(value_, fresh);
+        }
+    }
+
+    /// Calls `fn(T&)` while holding the lock and returns its result.
+    template <class F>
+        requires std::invocable<F, T&>
+    decltype(auto) with_lock(F&& fn) {
+        std::lock_guard guard(lock_);
+        return std::forward<F>(fn)(value_);
+    }
+
+    /// Calls `fn(const T&)` while holding the lock and returns its result.
+    template <class F>
+        requires std::invocable<F, const T&>
+    decltype(auto) with_lock(F&& fn) const {
+        std::lock_guard guard(lock_);
+        return std::forward<F>(fn)(std::as_const(value_));
+    }
+
+private:
+    T value_;
+    mutable spinlock lock_;
+};
+
+/**
+ * @brief Guards a value with a per-node reader-writer lock.
+ *
+ * Same interface as `by_spinlock`, but readers (`get()` and the const
+ * `with_lock()`) share the lock and only writers are exclusive. Prefer it
+ * when reads are long (copying a large matrix) or far outnumber writes.
+ *
+ * @tparam T Value type (copyable).
+ */
+template <class T>
+class by_rwlock {
+public:
+    /// Constructs a new instance holding a copy of @p v.
+    explicit by_rwlock(const T& v) : value_(v) {}
+
+    /// Constructs a new instance by moving @p v in.
+    explicit by_rwlock(T&& v) noexcept(std::is_nothrow_move_constructible_v<T>) : value_(std::move(v)) {}
+
+    by_rwlock(const by_rwlock&) = delete;
+    by_rwlock& operator=(const by_rwlock&) = delete;
+
+    /// Returns a copy of the value taken under a shared lock; throws whatever copying `T` or locking throws.
+    T get() const {
+        std::shared_lock guard(lock_);
+        return value_;
+    }
+
+    /// Replaces the value; only the swap happens under the exclusive lock.
+    template <class U>
+    void set(U&& v) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::unique_lock guard(lock_);
+            value_ = std::forward<U>(v);
+        } else {
+            T fresh(std::forward<U>(v));
+            std::unique_lock guard(lock_);
+            using std::swap;
+            swap(value_, fresh);
+        }
+    }
+
+    /// Calls `fn(T&)` under the exclusive lock and returns its result.
+    template <class F>
+        requires std::invocable<F, T&>
+    decltype(auto) with_lock(F&& fn) {
+        std::unique_lock guard(lock_);
+        return std::forward<F>(fn)(value_);
+    }
+
+    /// Calls `fn(const T&)` under a shared lock and returns its result.
+    template <class F>
+        requires std::invocable<F, const T&>
+    decltype(auto) with_lock(F&& fn) const {
+        std::shared_lock guard(lock_);
+        return std::forward<F>(fn)(std::as_const(value_));
+    }
+
+private:
+    T value_;
+    mutable std::shared_mutex lock_;
+};
+
 template<class Ownership>
 struct returns_reference : std::true_type{};
 
+template<typename T>
+struct returns_reference<by_spinlock<T>> : std::false_type{};
+
+template<typename T>
+struct returns_reference<by_rwlock<T>> : std::false_type{};
+
 template<typename T>
 struct returns_reference<by_atomic<T>> : std::false_type{};
 
+template<typename T>
+struct returns_reference<by_atomic_shared<T>> : std::false_type{};
+
+template<typename T, std::memory_order Load, std::memory_order Store>
+struct returns_reference<basic_atomic_ref<T, Load, Store>> : std::false_type{};
+
 template<class Ownership>
 concept returns_reference_v = returns_reference<Ownership>::value;
 
@@ -173,12 +657,17 @@ struct make_storage;
 
 /**
  * @brief Generic fallback for value-like storages (by_value, by_atomic).
+ *
+ * Rvalues are moved into the storage, lvalues are copied.
  */
 template<template<class> class Ownership, class T>
 struct make_storage<Ownership<T>> {
     static constexpr inline auto make(const T& v) {
         return Ownership<T>(v);
     }
+    static constexpr inline auto make(T&& v) {
+        return Ownership<T>(std::move(v));
+    }
 };
 
 /**
@@ -195,6 +684,69 @@ struct make_storage<by_shared<T>> {
     static inline auto make(const T& v) {
         return by_shared<T>(std::make_shared<T>(v));
     }
+    static inline auto make(T&& v) {
+        return by_shared<T>(std::make_shared<T>(std::move(v)));
+    }
+};
+
+/**
+ * @brief Specialized factory for `by_atomic_shared<T>`.
+ */
+template<class T>
+struct make_storage<by_atomic_shared<T>> {
+    static inline auto make(std::shared_ptr<const T> sp) noexcept {
+        return by_atomic_shared<T>(std::move(sp));
+    }
+    static inline auto make(const std::shared_ptr<T>& sp) noexcept {
+        return by_atomic_shared<T>(sp);
+    }
+    static inline auto make(const T& v) {
+        return by_atomic_shared<T>(std::make_shared<const T>(v));
+    }
+    static inline auto make(T&& v) {
+        return by_atomic_shared<T>(std::make_shared<const T>(std::move(v)));
+    }
+};
+
+/**
+ * @brief Specialized factory for `by_lazy<T>`: accepts a factory or a value.
+ */
+template<class T>
+struct make_storage<by_lazy<T>> {
+    template <class F>
+        requires std::is_invocable_r_v<T, const F&>
+    static inline auto make(const F& factory) {
+        return by_lazy<T>(typename by_lazy<T>::factory_type(factory));
+    }
+    static inline auto make(const T& v) {
+        return by_lazy<T>(v);
+    }
+    static inline auto make(T&& v) {
+        return by_lazy<T>(std::move(v));
+    }
+};
+
+/**
+ * @brief Specialized factory for `by_history<T, K>`.
+ */
+template<class T, std::size_t K>
+struct make_storage<by_history<T, K>> {
+    static inline auto make(const T& v) {
+        return by_history<T, K>(v);
+    }
+    static inline auto make(T&& v) {
+        return by_history<T, K>(std::move(v));
+    }
+};
+
+/**
+ * @brief Specialized factory for `basic_atomic_ref<T>` (and `by_atomic_ref<T>`).
+ */
+template<class T, std::memory_order Load, std::memory_order Store>
+struct make_storage<basic_atomic_ref<T, Load, Store>> {
+    static inline auto make(T& v) {
+        return basic_atomic_ref<T, Load, Store>(v);
+    }
 };
 
 /**
@@ -214,25 +766,160 @@ struct storage_traits;
 template<class T>
 struct storage_traits<by_value<T>> {
     static constexpr inline const T& get(const by_value<T>& s) noexcept { return s.get(); }
+    static constexpr inline T& get_mutable(by_value<T>& s) noexcept { return s.get(); }
     template<class U>
-    static constexpr inline void set(by_value<T>& s, U&& v) noexcept { s.get() = std::forward<U>(v); }
+    static constexpr inline void set(by_value<T>& s, U&& v) noexcept(std::is_nothrow_assignable_v<T&, U>) {
+        s.get() = std::forward<U>(v);
+    }
+    template<class F>
+    static constexpr inline void set_from(by_value<T>& s, F&& fn) { std::forward<F>(fn)(s.get()); }
 };
 
 // by_reference<T>
 template<class T>
 struct storage_traits<by_reference<T>> {
     static inline const T& get(const by_reference<T>& s) { return s.get(); }
+    static inline T& get_mutable(by_reference<T>& s) { return s.get(); }
     template<class U>
     static inline void set(by_reference<T>& s, U&& v) { s.get() = std::forward<U>(v); }
+    template<class F>
+    static inline void set_from(by_reference<T>& s, F&& fn) { std::forward<F>(fn)(s.get()); }
 };
 
 // by_shared<T>
 template<class T>
 struct storage_traits<by_shared<T>> {
-    static inline const T& get(const by_shared<T>& s) { return s.get(); }
+    static inline const T& get(const by_shared<T>& s) noexcept { return s.get(); }
+    static inline T& get_mutable(by_shared<T>& s) noexcept { return s.get(); }
     template<class U>
-    static inline void set(by_shared<T>& s, U&& v) { s.get() = std::forward<U>(v); }
+    static inline void set(by_shared<T>& s, U&& v) noexcept(std::is_nothrow_assignable_v<T&, U>) {
+        s.get() = std::forward<U>(v);
+    }
     static inline void set(by_shared<T>& s, std::shared_ptr<T>&& sp) noexcept { s.ptr = std::move(sp); }
+    template<class F>
+    static inline void set_from(by_shared<T>& s, F&& fn) { std::forward<F>(fn)(s.get()); }
+};
+
+// by_lazy<T>
+template<class T>
+struct storage_traits<by_lazy<T>> {
+    static inline const T& get(const by_lazy<T>& s) { return s.get(); }
+    static inline T& get_mutable(by_lazy<T>& s) { return s.get(); }
+    template<class U>
+    static inline void set(by_lazy<T>& s, U&& v) noexcept(noexcept(s.set(std::forward<U>(v)))) { s.set(std::forward<U>(v)); }
+    /// Constructs the value first if it was never read.
+    template<class F>
+    static inline void set_from(by_lazy<T>& s, F&& fn) { std::forward<F>(fn)(s.get()); }
+};
+
+// by_history<T, K>
+template<class T, std::size_t K>
+struct storage_traits<by_history<T, K>> {
+    static constexpr inline const T& get(const by_history<T, K>& s) noexcept { return s.get(); }
+    static constexpr inline T& get_mutable(by_history<T, K>& s) noexcept { return s.get_mutable(); }
+    template<class U>
+    static constexpr inline void set(by_history<T, K>& s, U&& v) noexcept(std::is_nothrow_assignable_v<T&, U>) {
+        s.get_mutable() = std::forward<U>(v);
+    }
+    /// After `advance()`, @p fn sees the recycled oldest value and its capacity.
+    template<class F>
+    static constexpr inline void set_from(by_history<T, K>& s, F&& fn) { std::forward<F>(fn)(s.get_mutable()); }
+};
+
+// by_atomic_shared<T>
+template<class T>
+struct storage_traits<by_atomic_shared<T>> {
+    static inline std::shared_ptr<const T> get(const by_atomic_shared<T>& s) noexcept { return s.get(); }
+    /// Publishes a copy of @p v as a new immutable value.
+    template<class U>
+        requires std::constructible_from<T, U&&>
+    static inline void set(by_atomic_shared<T>& s, U&& v) {
+        s.publish(std::make_shared<const T>(std::forward<U>(v)));
+    }
+    static inline void set(by_atomic_shared<T>& s, std::shared_ptr<const T> sp) noexcept { s.publish(std::move(sp)); }
+    static inline void set(by_atomic_shared<T>& s, const std::shared_ptr<T>& sp) noexcept { s.publish(sp); }
+    static inline void set(by_atomic_shared<T>& s, std::shared_ptr<T>&& sp) noexcept { s.publish(std::move(sp)); }
+    /// Copies a range of the current snapshot.
+    template<class E>
+    static inline void load(const by_atomic_shared<T>& s, std::size_t first, std::span<E> out) {
+        numsim::propex::detail::copy_range_out(*s.get(), first, out);
+    }
+    /// Publishes an updated copy; retried if another writer published in between.
+    template<class E>
+    static inline void store(by_atomic_shared<T>& s, std::size_t first, std::span<const E> in) {
+        std::shared_ptr<const T> current = s.get();
+        for (;;) {
+            auto next = std::make_shared<T>(*current);
+            numsim::propex::detail::copy_range_in(*next, first, in);
+            std::shared_ptr<const T> desired = std::move(next);
+            if (s.ptr.compare_exchange_weak(current, std::move(desired), std::memory_order_release,
+                                            std::memory_order_acquire))
+                return;
+        }
+    }
+};
+
+// basic_atomic_ref<T> (by_atomic_ref<T>)
+template<class T, std::memory_order Load, std::memory_order Store>
+struct storage_traits<basic_atomic_ref<T, Load, Store>> {
+    static inline T get(const basic_atomic_ref<T, Load, Store>& s) noexcept { return s.get(); }
+    template<class U>
+    static inline void set(basic_atomic_ref<T, Load, Store>& s, U&& v) noexcept { s.set(static_cast<T>(std::forward<U>(v))); }
+    template<class E>
+    static inline void load(const basic_atomic_ref<T, Load, Store>& s, std::size_t first, std::span<E> out) {
+        numsim::propex::detail::copy_range_out(s.get(), first, out);
+    }
+    /// Compare-and-swap loop, so concurrent range stores do not lose each other's elements.
+    template<class E>
+    static inline void store(basic_atomic_ref<T, Load, Store>& s, std::size_t first, std::span<const E> in) {
+        const auto ref = s.ref();
+        T expected = ref.load(std::memory_order_relaxed);
+        T desired = expected;
+        numsim::propex::detail::copy_range_in(desired, first, in);
+        while (!ref.compare_exchange_weak(expected, desired, Store, std::memory_order_relaxed)) {
+            desired = expected;
+            numsim::propex::detail::copy_range_in(desired, first, in);
+        }
+    }
+};
+
+// by_spinlock<T>
+template<class T>
+struct storage_traits<by_spinlock<T>> {
+    static inline T get(const by_spinlock<T>& s) noexcept(noexcept(s.get())) { return s.get(); }
+    template<class U>
+    static inline void set(by_spinlock<T>& s, U&& v) { s.set(std::forward<U>(v)); }
+    /// Runs @p fn under the lock.
+    template<class F>
+    static inline void set_from(by_spinlock<T>& s, F&& fn) { s.with_lock(std::forward<F>(fn)); }
+    template<class E>
+    static inline void load(const by_spinlock<T>& s, std::size_t first, std::span<E> out) {
+        s.with_lock([&](const T& v) { numsim::propex::detail::copy_range_out(v, first, out); });
+    }
+    template<class E>
+    static inline void store(by_spinlock<T>& s, std::size_t first, std::span<const E> in) {
+        s.with_lock([&](T& v) { numsim::propex::detail::copy_range_in(v, first, in); });
+    }
+};
+
+// by_rwlock<T>
+template<class T>
+struct storage_traits<by_rwlock<T>> {
+    static inline T get(const by_rwlock<T>& s) noexcept(noexcept(s.get())) { return s.get(); }
+    template<class U>
+    static inline void set(by_rwlock<T>& s, U&& v) { s.set(std::forward<U>(v)); }
+    /// Runs @p fn under the exclusive lock.
+    template<class F>
+    static inline void set_from(by_rwlock<T>& s, F&& fn) { s.with_lock(std::forward<F>(fn)); }
+    /// Copies under the shared lock.
+    template<class E>
+    static inline void load(const by_rwlock<T>& s, std::size_t first, std::span<E> out) {
+        s.with_lock([&](const T& v) { numsim::propex::detail::copy_range_out(v, first, out); });
+    }
+    template<class E>
+    static inline void store(by_rwlock<T>& s, std::size_t first, std::span<const E> in) {
+        s.with_lock([&](T& v) { numsim::propex::detail::copy_range_in(v, first, in); });
+    }
 };
 
 // by_atomic<T>
@@ -241,6 +928,21 @@ struct storage_traits<by_atomic<T>> {
     static constexpr inline T get(const by_atomic<T>& s) noexcept { return s.value.load(std::memory_order_relaxed); }
     template<class U>
     static constexpr inline void set(by_atomic<T>& s, U&& v) noexcept { s.set(static_cast<T>(std::forward<U>(v))); }
+    template<class E>
+    static inline void load(const by_atomic<T>& s, std::size_t first, std::span<E> out) {
+        numsim::propex::detail::copy_range_out(s.value.load(std::memory_order_relaxed), first, out);
+    }
+    /// Compare-and-swap loop, so concurrent range stores do not lose each other's elements.
+    template<class E>
+    static inline void store(by_atomic<T>& s, std::size_t first, std::span<const E> in) {
+        T expected = s.value.load(std::memory_order_relaxed);
+        T desired = expected;
+        numsim::propex::detail::copy_range_in(desired, first, in);
+        while (!s.value.compare_exchange_weak(expected, desired, std::memory_order_relaxed)) {
+            desired = expected;
+            numsim::propex::detail::copy_range_in(desired, first, in);
+        }
+    }
 };
 } // namespace ownership
 
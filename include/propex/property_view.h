@@ -16,7 +16,23 @@
  * | `ownership::by_value`   | `const T&`    | Direct storage |
  * | `ownership::by_reference` | `const T&` | External reference |
  * | `ownership::by_shared`   | `const T&`  | Shared ownership via `shared_ptr` |
+ * | `ownership::by_lazy`     | `const T&`  | Built by a factory on first read |
+ * | `ownership::history<K>::type` | `const T&` | Last `K` values; `get(lag)` reads older ones |
  * | `ownership::by_atomic`   | `T`          | Copy via atomic access |
+ * | `ownership::by_atomic_ref` | `T`        | Atomic access to external storage via `std::atomic_ref` |
+ * | `ownership::by_spinlock` | `T`          | Snapshot copied under a per-node spinlock; `with_lock(fn)` updates in place |
+ * | `ownership::by_rwlock`   | `T`          | Like `by_spinlock` with a shared lock for readers |
+ * | `ownership::by_compressed` (propex_cold.h) | `const T&` | Compressed by `compress_cold(reg)` while unused |
+ * | `ownership::by_mmap` (propex_mmap.h) | `std::span<const T>` | Array in a memory-mapped file; `span()` for writes |
+ * | `ownership::by_atomic_shared` | `std::shared_ptr<const T>` | Snapshot of an atomically published value |
+ *
+ * Views of array-valued properties (`std::vector`, `std::array`, `aligned_vector`)
+ * also offer element access: `span()`/`operator[]` where the policy keeps the
+ * container in place, and `load()`/`store()` of sub-ranges for every policy
+ * (see propex_field.h).
+ *
+ * Views of `node`s can be awaited from coroutines: `co_await view.changed()`
+ * and `co_await view.until(pred)` (see propex_async.h).
  *
  * ### Example
  * @code
@@ -42,6 +58,11 @@
 #define PROPEX_PROPERTY_VIEW_H
 
 #include "ownership_policies.h"
+#include "propex_async.h"
+#include "propex_profiling.h"
+#include "propex_trace.h"
+#include <concepts>
+#include <cstddef>
 #include <stdexcept>
 #include <utility>
 
@@ -93,7 +114,9 @@ public:
     constexpr property_view() noexcept = default;
 
     /// @brief Constructs a view bound to an existing node.
-    constexpr explicit property_view(Node<T, Ownership>* n) noexcept : node_(n) {}
+    constexpr explicit property_view(Node<T, Ownership>* n) noexcept : node_(n) {
+        PROPEX_TRACE_INSTANT("view", "bind");
+    }
 
     /// @brief Move-constructs a view, transferring the node binding.
     constexpr property_view(property_view&& other) noexcept
@@ -135,22 +158,65 @@ public:
     /// @brief Checked mutation — throws if unbound.
     constexpr void set_checked(const T& v) {
         if (!node_) throw std::runtime_error("property_view: null access");
+        PROPEX_TRACE_SCOPE("view", "set");
+        PROPEX_PROFILE_ACCESS(set, node_);
         node_->set(v);
     }
 
-    /// @brief Unchecked mutation — asserts in debug builds.
-    constexpr void set(const T& v) noexcept {
+    /// @brief Checked mutation moving @p v into the storage — throws if unbound.
+    constexpr void set_checked(T&& v) {
+        if (!node_) throw std::runtime_error("property_view: null access");
+        PROPEX_TRACE_SCOPE("view", "set");
+        PROPEX_PROFILE_ACCESS(set, node_);
+        node_->set(std::move(v));
+    }
+
+    /// @brief Perfect-forwarding checked mutation (e.g. a `shared_ptr` for `by_atomic_shared`).
+    template <typename V>
+    constexpr void set_checked(V&& v) {
+        if (!node_) throw std::runtime_error("property_view: null access");
+        PROPEX_TRACE_SCOPE("view", "set");
+        PROPEX_PROFILE_ACCESS(set, node_);
+        node_->set(std::forward<V>(v));
+    }
+
+    /// @brief Unchecked mutation — asserts in debug builds; `noexcept` whenever `Node::set()` is.
+    constexpr void set(const T& v) noexcept(noexcept(std::declval<Node<T, Ownership>&>().set(v))) {
         PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "set");
+        PROPEX_PROFILE_ACCESS(set, node_);
         node_->set(v);
     }
 
-    /// @brief Perfect-forwarding unchecked mutation.
+    /// @brief Perfect-forwarding unchecked mutation; rvalues are moved into the storage.
     template <typename V>
-    constexpr void set(V&& v) noexcept {
+    constexpr void set(V&& v) noexcept(noexcept(std::declval<Node<T, Ownership>&>().set(std::forward<V>(v)))) {
         PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "set");
+        PROPEX_PROFILE_ACCESS(set, node_);
         node_->set(std::forward<V>(v));
     }
 
+    /**
+     * @brief Rebuilds the value in place, reusing its storage (see `node::set_from`).
+     *
+     * @code
+     * u.set_from([&](std::vector<double>& v) {
+     *     v.resize(n);
+     *     for (std::size_t i = 0; i < n; ++i) v[i] = f(x[i]);
+     * });
+     * @endcode
+     */
+    template <class F>
+    void set_from(F&& fn)
+        requires requires(Node<T, Ownership>& n) { n.set_from(std::forward<F>(fn)); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "set");
+        PROPEX_PROFILE_ACCESS(set, node_);
+        node_->set_from(std::forward<F>(fn));
+    }
+
     // -------------------------------------------------------------------------
     // Read Operations
     // -------------------------------------------------------------------------
@@ -160,34 +226,252 @@ public:
         requires (returns_reference_v)
     {
         if (!node_) throw std::runtime_error("property_view: null access");
+        PROPEX_TRACE_SCOPE("view", "get");
+        PROPEX_PROFILE_ACCESS(get, node_);
         return node_->get();
     }
 
     /// @brief Checked access returning by value (value-returning policies only).
-    [[nodiscard]] constexpr T get_checked() const
+    /// @return What the policy hands out: `T` for `by_atomic`, a
+    ///         `std::shared_ptr<const T>` snapshot for `by_atomic_shared`.
+    [[nodiscard]] constexpr auto get_checked() const
         requires (!returns_reference_v)
     {
         if (!node_) throw std::runtime_error("property_view: null access");
+        PROPEX_TRACE_SCOPE("view", "get");
+        PROPEX_PROFILE_ACCESS(get, node_);
         return node_->get();
     }
 
-    /// @brief Unchecked access returning a reference.
-    [[nodiscard]] constexpr const T& get() const noexcept
+    /// @brief Unchecked access returning a reference; `noexcept` whenever `Node::get()` is.
+    [[nodiscard]] constexpr const T& get() const noexcept(noexcept(std::declval<Node<T, Ownership>&>().get()))
         requires (returns_reference_v)
     {
         PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "get");
+        PROPEX_PROFILE_ACCESS(get, node_);
         return node_->get();
     }
 
-    /// @brief Unchecked access returning by value.
-    [[nodiscard]] constexpr T get() const noexcept
+    /// @brief Unchecked access returning by value (see `get_checked()`); `noexcept` whenever `Node::get()` is.
+    [[nodiscard]] constexpr auto get() const noexcept(noexcept(std::declval<Node<T, Ownership>&>().get()))
         requires (!returns_reference_v)
     {
         PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "get");
+        PROPEX_PROFILE_ACCESS(get, node_);
         return node_->get();
     }
 
+    /// @brief Unchecked access to the value @p lag steps back (history policies only).
+    [[nodiscard]] constexpr const T& get(std::size_t lag) const
+        requires requires(const Node<T, Ownership>& n) { n.get(lag); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "get");
+        PROPEX_PROFILE_ACCESS(get, node_);
+        return node_->get(lag);
+    }
+
+    /**
+     * @brief Evaluates a function-like property, e.g. a `tabulated` table.
+     *
+     * Forwards to `get().eval(args...)`; snapshot policies (`by_atomic_shared`)
+     * are dereferenced first. Available whenever `T` has a matching `eval()`.
+     *
+     * @code
+     * double e = youngs_modulus.eval(temperature);
+     * youngs_modulus.eval(std::span(temperatures), std::span(moduli));
+     * @endcode
+     */
+    template <class... Args>
+    [[nodiscard]] decltype(auto) eval(Args&&... args) const
+        requires requires(const T& t) { t.eval(std::forward<Args>(args)...); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "eval");
+        PROPEX_PROFILE_ACCESS(get, node_);
+        return value_of(node_->get()).eval(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Zero-copy span into an array property.
+     *
+     * For `by_mmap` the span is writable (throws std::logic_error if the
+     * mapping is read-only). For fields with stable storage it is read-only
+     * on a const view; see the non-const overload.
+     */
+    [[nodiscard]] auto span() const
+        requires requires(const Node<T, Ownership>& n) { n.span(); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_PROFILE_ACCESS(set, node_);
+        return std::as_const(*node_).span();
+    }
+
+    /**
+     * @brief Writes pending modifications to the backing file (`by_mmap`).
+     */
+    void flush() const
+        requires requires(const Node<T, Ownership>& n) { n.flush(); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "flush");
+        std::as_const(*node_).flush();
+    }
+
+    // -------------------------------------------------------------------------
+    // Field Access (propex_field.h)
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Writable span over the elements of a field, without copying the container.
+     *
+     * Only for contiguous value types under policies with stable storage
+     * (`Node::stable_field_v`). Valid until the container is resized or replaced.
+     */
+    [[nodiscard]] auto span()
+        requires (Node<T, Ownership>::stable_field_v)
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_PROFILE_ACCESS(set, node_);
+        return node_->span();
+    }
+
+    /// @brief Element @p i of a field (unchecked) — policies with stable storage only.
+    [[nodiscard]] decltype(auto) operator[](std::size_t i)
+        requires (Node<T, Ownership>::stable_field_v)
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        return node_->span()[i];
+    }
+
+    /// @copydoc operator[]
+    [[nodiscard]] decltype(auto) operator[](std::size_t i) const
+        requires (Node<T, Ownership>::stable_field_v)
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        return std::as_const(*node_).span()[i];
+    }
+
+    /// @brief Number of elements of a field — policies with stable storage only.
+    [[nodiscard]] std::size_t size() const
+        requires (Node<T, Ownership>::stable_field_v)
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        return std::as_const(*node_).span().size();
+    }
+
+    /**
+     * @brief Copies `out.size()` elements starting at @p first into @p out (every policy).
+     * @throws std::out_of_range if the range exceeds the stored size.
+     */
+    template <class U = T>
+    void load(std::size_t first, std::span<field_element_t<U>> out) const
+        requires requires(const Node<U, Ownership>& n) { n.load(first, out); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "load");
+        PROPEX_PROFILE_ACCESS(get, node_);
+        std::as_const(*node_).load(first, out);
+    }
+
+    /**
+     * @brief Copies @p in into the field starting at element @p first (every policy).
+     * @throws std::out_of_range if the range exceeds the stored size.
+     */
+    template <class U = T>
+    void store(std::size_t first, std::span<const field_element_t<U>> in)
+        requires requires(Node<U, Ownership>& n) { n.store(first, in); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "store");
+        PROPEX_PROFILE_ACCESS(set, node_);
+        node_->store(first, in);
+    }
+
+    // -------------------------------------------------------------------------
+    // Locked Access
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Runs @p fn on the value in place while holding the node's lock.
+     *
+     * Only available for locking policies (`by_spinlock`, `by_rwlock`). The
+     * mutable overload passes `T&` under the exclusive lock; the const overload
+     * passes `const T&` (under a shared lock for `by_rwlock`).
+     *
+     * @code
+     * stress.with_lock([&](matrix& s) { s += ds; });
+     * @endcode
+     */
+    template <class F>
+    decltype(auto) with_lock(F&& fn)
+        requires requires(Node<T, Ownership>& n) { n.with_lock(std::forward<F>(fn)); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "with_lock");
+        PROPEX_PROFILE_ACCESS(set, node_);
+        return node_->with_lock(std::forward<F>(fn));
+    }
+
+    /// @copydoc with_lock
+    template <class F>
+    decltype(auto) with_lock(F&& fn) const
+        requires requires(const Node<T, Ownership>& n) { n.with_lock(std::forward<F>(fn)); }
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        PROPEX_TRACE_SCOPE("view", "with_lock");
+        PROPEX_PROFILE_ACCESS(get, node_);
+        return std::as_const(*node_).with_lock(std::forward<F>(fn));
+    }
+
+    // -------------------------------------------------------------------------
+    // Change Notification
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Awaitable completing at the next change of the node (see propex_async.h).
+     */
+    template <resume_scheduler S = inline_scheduler>
+    [[nodiscard]] change_awaitable<S> changed(S& scheduler = resume_inline) const noexcept
+        requires std::derived_from<Node<T, Ownership>, node_base>
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        return change_awaitable<S>(*node_, scheduler);
+    }
+
+    /**
+     * @brief Awaitable completing once `pred(get())` holds; ready at once if it already does.
+     *
+     * After each change @p pred runs on the publishing thread, so it should be cheap and must not throw.
+     */
+    template <class Pred, resume_scheduler S = inline_scheduler>
+    [[nodiscard]] until_awaitable<Node<T, Ownership>, Pred, S> until(Pred pred, S& scheduler = resume_inline) const
+        requires std::derived_from<Node<T, Ownership>, node_base>
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        return until_awaitable<Node<T, Ownership>, Pred, S>(*node_, std::move(pred), scheduler);
+    }
+
+    /**
+     * @brief Publishes writes made through `span()`, `operator[]` or other references (`node_base::mark_changed()`).
+     */
+    void mark_changed() const noexcept
+        requires std::derived_from<Node<T, Ownership>, node_base>
+    {
+        PROPERTYVIEW_ASSERT(node_);
+        node_->mark_changed();
+    }
+
 private:
+    /// @brief The value behind what `Node::get()` returns (the value itself or a snapshot pointer).
+    static constexpr const T& value_of(const T& v) noexcept { return v; }
+
+    template <class Ptr>
+        requires requires(const Ptr& p) { { *p } -> std::convertible_to<const T&>; }
+    static constexpr const T& value_of(const Ptr& p) noexcept { return *p; }
+
     /// @brief Non-owning pointer to the underlying node.
     Node<T, Ownership>* node_{nullptr};
 };
@@ -0,0 +1,246 @@
+/**
+ * @file propex_async.h
+ * @brief C++20 coroutine awaitables for property changes.
+ *
+ * @details
+ * Components that wait for another component to publish a value suspend
+ * instead of polling:
+ *
+ * @code
+ * manual_scheduler loop;
+ *
+ * detached_task consumer(registry<std::string, node_base>& reg, property_view<double, node> pressure) {
+ *     co_await reg.changed("fluid:p", loop);                // next change of the node
+ *     co_await pressure.until([](double p) { return p > 1e5; }, loop);
+ *     ...
+ * }
+ *
+ * loop.run();   // resumes the waiters whose nodes changed
+ * @endcode
+ *
+ * Waits build on node versioning (`node_base::version()`, bumped by every
+ * setter). A suspended coroutine is a table entry keyed by its node: no
+ * thread and no polling. Setting a node without waiters costs one atomic
+ * increment, for every policy: a subscription from another thread may race
+ * with the write and must not lose its wakeup.
+ *
+ * Woken coroutines are handed to a scheduler, anything with
+ * `schedule(std::coroutine_handle<>)` (`resume_scheduler`):
+ *  - `inline_scheduler` (the default) resumes on the thread that called `set()`;
+ *  - `manual_scheduler` queues them until the owner calls `run()`;
+ *  - `work_stealing_scheduler` (propex_scheduler.h) resumes them on a pool worker.
+ *
+ * `until()` re-checks its predicate on the setter's thread after each change
+ * and only schedules the coroutine once it holds, so the predicate should be
+ * cheap. If the predicate, reading the value or re-registering throws there,
+ * the coroutine is scheduled and `co_await` rethrows the exception.
+ *
+ * Destroying a node wakes its waiters; `co_await` then throws
+ * `std::runtime_error`. A suspended coroutine may be destroyed, which
+ * unregisters its wait, as long as it is not being woken at the same time.
+ */
+
+#ifndef PROPEX_ASYNC_H
+#define PROPEX_ASYNC_H
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "propex_node.h"
+
+namespace numsim::propex {
+
+/// Receives coroutines to resume once the node they wait for changed.
+template <class S>
+concept resume_scheduler = requires(S& s, std::coroutine_handle<> h) { s.schedule(h); };
+
+/// Resumes immediately, on the thread that published the change.
+struct inline_scheduler {
+    void schedule(std::coroutine_handle<> h) const { h.resume(); }
+};
+
+/// Default scheduler of the awaitables.
+inline inline_scheduler resume_inline;
+
+/**
+ * @brief Queues woken coroutines until `run()`; thread-safe.
+ *
+ * Suits components with their own loop: changes published by other threads
+ * resume the waiters on the loop's thread.
+ */
+class manual_scheduler {
+public:
+    void schedule(std::coroutine_handle<> h) {
+        const std::lock_guard lock(mutex_);
+        ready_.push_back(h);
+    }
+
+    /// Resumes the queued coroutines, including ones queued while running. Returns how many ran.
+    std::size_t run() {
+        std::size_t resumed = 0;
+        std::vector<std::coroutine_handle<>> batch;
+        for (;;) {
+            {
+                const std::lock_guard lock(mutex_);
+                if (ready_.empty()) return resumed;
+                batch.swap(ready_);
+            }
+            for (const std::coroutine_handle<> h : batch) h.resume();
+            resumed += batch.size();
+            batch.clear();
+        }
+    }
+
+    /// Number of queued coroutines.
+    [[nodiscard]] std::size_t pending() const {
+        const std::lock_guard lock(mutex_);
+        return ready_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::coroutine_handle<>> ready_;
+};
+
+/**
+ * @brief Coroutine return type for fire-and-forget consumers.
+ *
+ * Starts eagerly and frees its frame when it finishes. An exception leaving
+ * the coroutine calls `std::terminate()`, as for `std::thread`.
+ */
+struct detached_task {
+    struct promise_type {
+        detached_task get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+namespace detail {
+
+/// Bookkeeping shared by the awaitables: the suspended coroutine and how it was woken.
+template <resume_scheduler S>
+class awaiting_change : protected change_waiter {
+public:
+    awaiting_change(const node_base& node, S& scheduler) noexcept : node_(&node), scheduler_(&scheduler) {}
+    awaiting_change(const awaiting_change&) = delete;
+    awaiting_change& operator=(const awaiting_change&) = delete;
+
+    ~awaiting_change() {
+        if (suspended_ && !woken_) detail::change_waiters::instance().remove(node_, *this);
+    }
+
+protected:
+    /// Registers for the change after @p seen; nothing of `*this` may be touched after `true`.
+    bool suspend(std::coroutine_handle<> h, std::uint64_t seen) {
+        handle_ = h;
+        suspended_ = true;
+        return node_->subscribe(*this, seen);
+    }
+
+    void resume(bool destroyed) noexcept {
+        woken_ = true;
+        destroyed_ = destroyed;
+        scheduler_->schedule(handle_);
+    }
+
+    void check_alive() const {
+        if (destroyed_) throw std::runtime_error("propex: awaited node was destroyed");
+    }
+
+    void rebind(node_base& node) noexcept override { node_ = &node; }
+
+    const node_base* node_;
+    S* scheduler_;
+    std::coroutine_handle<> handle_;
+    bool suspended_{false};
+    bool woken_{false};
+    bool destroyed_{false};
+};
+
+} // namespace detail
+
+/**
+ * @brief Completes once the node's version differs from the one seen at construction.
+ *
+ * `co_await` yields the new `version()`.
+ */
+template <resume_scheduler S = inline_scheduler>
+class change_awaitable : private detail::awaiting_change<S> {
+    using base = detail::awaiting_change<S>;
+
+public:
+    explicit change_awaitable(const node_base& node, S& scheduler = resume_inline) noexcept
+        : base(node, scheduler), seen_(node.version()) {}
+
+    [[nodiscard]] bool await_ready() const noexcept { return this->node_->version() != seen_; }
+    bool await_suspend(std::coroutine_handle<> h) { return this->suspend(h, seen_); }
+    std::uint64_t await_resume() const {
+        this->check_alive();
+        return this->node_->version();
+    }
+
+private:
+    void wake(bool destroyed) noexcept override { this->resume(destroyed); }
+
+    std::uint64_t seen_;
+};
+
+/**
+ * @brief Completes once `pred(node.get())` holds; checks immediately, then after every change.
+ */
+template <class Node, class Pred, resume_scheduler S = inline_scheduler>
+class until_awaitable : private detail::awaiting_change<S> {
+    using base = detail::awaiting_change<S>;
+
+public:
+    until_awaitable(Node& node, Pred pred, S& scheduler = resume_inline)
+        : base(node, scheduler), pred_(std::move(pred)) {}
+
+    [[nodiscard]] bool await_ready() { return pred_(target()->get()); }
+    bool await_suspend(std::coroutine_handle<> h) {
+        for (;;) {
+            const std::uint64_t seen = target()->version();
+            if (pred_(target()->get())) return false;
+            if (this->suspend(h, seen)) return true;
+        }
+    }
+    void await_resume() const {
+        this->check_alive();
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+    void wake(bool destroyed) noexcept override {
+        if (!destroyed) {
+            try {
+                for (;;) {
+                    const std::uint64_t seen = target()->version();
+                    if (pred_(target()->get())) break;
+                    if (target()->subscribe(*this, seen)) return;  // still waiting
+                }
+            } catch (...) {
+                error_ = std::current_exception();  // runs on the setter's thread; rethrown by co_await
+            }
+        }
+        this->resume(destroyed);
+    }
+
+    /// The awaited node; read through the base so relocation (`rebind()`) is followed.
+    Node* target() const noexcept { return static_cast<Node*>(const_cast<node_base*>(this->node_)); }
+
+    Pred pred_;
+    std::exception_ptr error_;
+};
+
+} // namespace numsim::propex
+
+#endif // PROPEX_ASYNC_H
@@ -0,0 +1,179 @@
+/**
+ * @file propex_codec.h
+ * @brief Small, dependency-free LZ77 block codec used for cold property storage.
+ *
+ * @details
+ * The format follows the LZ4 block layout: a sequence is a token byte
+ * (literal length in the high nibble, match length - 4 in the low nibble),
+ * optional length extension bytes (255 = continue), the literals, and a
+ * 16-bit little-endian back-reference offset. The last sequence only has
+ * literals. Matches are found with a single-entry hash table over 4-byte
+ * prefixes, which favours speed over ratio: typical metadata strings and
+ * piecewise constant initial conditions shrink by 5-50x, while noisy
+ * floating point data is stored almost unchanged.
+ *
+ * `compress()` never fails except by `std::bad_alloc`; `decompress()`
+ * validates every length and offset and throws `std::runtime_error` on
+ * corrupt input.
+ *
+ * @see ownership::by_compressed
+ */
+
+#ifndef PROPEX_CODEC_H
+#define PROPEX_CODEC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace numsim::propex::codec {
+
+namespace detail {
+
+inline constexpr std::size_t min_match = 4;
+inline constexpr std::size_t max_offset = 65535;
+inline constexpr unsigned hash_bits = 12;
+/// No match may start in the last bytes, so the final sequence always has literals to copy.
+inline constexpr std::size_t tail_literals = 5;
+
+inline std::uint32_t read32(const std::byte* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+inline std::uint32_t hash(std::uint32_t v) noexcept {
+    return (v * 2654435761u) >> (32 - hash_bits);
+}
+
+inline void put_length(std::vector<std::byte>& out, std::size_t len) {
+    for (; len >= 255; len -= 255) out.push_back(std::byte{255});
+    out.push_back(static_cast<std::byte>(len));
+}
+
+inline void put_sequence(std::vector<std::byte>& out, const std::byte* literals, std::size_t literal_len,
+                         std::size_t offset, std::size_t match_len) {
+    const std::size_t lit_nibble = literal_len < 15 ? literal_len : 15;
+    const std::size_t extra = match_len ? match_len - min_match : 0;
+    const std::size_t match_nibble = extra < 15 ? extra : 15;
+    out.push_back(static_cast<std::byte>((lit_nibble << 4) | match_nibble));
+    if (lit_nibble == 15) put_length(out, literal_len - 15);
+    out.insert(out.end(), literals, literals + literal_len);
+    if (match_len == 0) return;
+    out.push_back(static_cast<std::byte>(offset & 0xff));
+    out.push_back(static_cast<std::byte>(offset >> 8));
+    if (match_nibble == 15) put_length(out, extra - 15);
+}
+
+} // namespace detail
+
+/// Worst-case size of `compress()`'s output for @p n input bytes.
+[[nodiscard]] constexpr std::size_t compress_bound(std::size_t n) noexcept {
+    return n + n / 255 + 16;
+}
+
+/**
+ * @brief Compresses @p in into a freshly allocated block.
+ * @return The compressed bytes; `decompress()` needs `in.size()` to restore them.
+ */
+[[nodiscard]] inline std::vector<std::byte> compress(std::span<const std::byte> in) {
+    using namespace detail;
+    std::vector<std::byte> out;
+    out.reserve(compress_bound(in.size()));
+
+    const std::byte* const base = in.data();
+    const std::size_t n = in.size();
+    std::size_t anchor = 0;  // first byte not yet emitted
+
+    if (n > min_match + tail_literals) {
+        // Positions + 1, so that 0 means "empty".
+        std::array<std::uint32_t, std::size_t{1} << hash_bits> table{};
+        const std::size_t limit = n - tail_literals - min_match;
+        std::size_t i = 0, misses = 0;
+        while (i <= limit) {
+            const std::uint32_t seq = read32(base + i);
+            const std::uint32_t h = hash(seq);
+            const std::size_t candidate = table[h];
+            table[h] = static_cast<std::uint32_t>(i + 1);
+            if (candidate == 0 || i + 1 - candidate > max_offset || read32(base + candidate - 1) != seq) {
+                i += 1 + (misses++ >> 5);  // skip faster through incompressible data
+                continue;
+            }
+            misses = 0;
+            std::size_t match = candidate - 1;
+            std::size_t len = min_match;
+            while (i + len < n - tail_literals && base[match + len] == base[i + len]) ++len;
+            // Extend backwards over literals that also match.
+            while (i > anchor && match > 0 && base[i - 1] == base[match - 1]) {
+                --i;
+                --match;
+                ++len;
+            }
+            put_sequence(out, base + anchor, i - anchor, i - match, len);
+            i += len;
+            anchor = i;
+        }
+    }
+    put_sequence(out, base + anchor, n - anchor, 0, 0);
+    return out;
+}
+
+/**
+ * @brief Restores exactly `out.size()` bytes from the block @p in.
+ * @throws std::runtime_error if @p in is corrupt or does not decode to `out.size()` bytes.
+ */
+inline void decompress(std::span<const std::byte> in, std::span<std::byte> out) {
+    const auto corrupt = [] { throw std::runtime_error("codec: corrupt compressed block"); };
+    std::size_t ip = 0, op = 0;
+    const auto read_length = [&](std::size_t len) {
+        if (len != 15) return len;
+        for (;;) {
+            if (ip >= in.size()) corrupt();
+            const auto b = static_cast<std::size_t>(in[ip++]);
+            len += b;
+            if (b != 255) return len;
+        }
+    };
+
+    for (;;) {
+        if (ip >= in.size()) corrupt();
+        const auto token = static_cast<std::size_t>(in[ip++]);
+        const std::size_t literal_len = read_length(token >> 4);
+        if (literal_len > in.size() - ip || literal_len > out.size() - op) corrupt();
+        if (literal_len != 0) std::memcpy(out.data() + op, in.data() + ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+        if (ip == in.size()) break;  // last sequence: literals only
+
+        if (in.size() - ip < 2) corrupt();
+        const std::size_t offset = static_cast<std::size_t>(in[ip]) | (static_cast<std::size_t>(in[ip + 1]) << 8);
+        ip += 2;
+        const std::size_t match_len = read_length(token & 15) + detail::min_match;
+        if (offset == 0 || offset > op || match_len > out.size() - op) corrupt();
+        const std::byte* src = out.data() + op - offset;
+        std::byte* dst = out.data() + op;
+        if (offset >= match_len) {
+            std::memcpy(dst, src, match_len);
+        } else {
+            // Overlapping match: the output repeats the last `offset` bytes.
+            // Copy one period, then keep doubling the copied prefix (it stays
+            // a whole number of periods, so every memcpy is non-overlapping).
+            std::memcpy(dst, src, offset);
+            for (std::size_t done = offset; done < match_len;) {
+                const std::size_t n = done < match_len - done ? done : match_len - done;
+                std::memcpy(dst + done, dst, n);
+                done += n;
+            }
+        }
+        op += match_len;
+    }
+    if (op != out.size()) corrupt();
+}
+
+} // namespace numsim::propex::codec
+
+#endif // PROPEX_CODEC_H
@@ -0,0 +1,323 @@
+/**
+ * @file propex_cold.h
+ * @brief `by_compressed<T>`: properties that are compressed while nobody reads them.
+ *
+ * @details
+ * Metadata, initial conditions and similar properties are written once and
+ * rarely read, yet occupy memory at full size for the whole run. A node with
+ * the `by_compressed` policy keeps its value on the heap while it is in use;
+ * `compress_cold(reg)` packs every such node that has not been read or
+ * written since the previous sweep into a block of `propex_codec.h`.
+ * The next `get()` restores the value transparently.
+ *
+ * Cold detection is a second-chance (CLOCK) scheme: every access sets a
+ * flag, each sweep clears it, so a node is compressed after one full sweep
+ * interval without accesses. Values that shrink by less than an eighth stay
+ * uncompressed (and are not retried until the next `set()`).
+ *
+ * @code
+ * registry<std::string, node_base> reg;
+ * reg.add(std::make_unique<node<std::string, ownership::by_compressed>>(json), "run", "metadata");
+ * ...
+ * if (step % 100 == 0) {
+ *     const cold_stats s = compress_cold(reg);    // s.saved() bytes freed
+ * }
+ * @endcode
+ *
+ * Threading: any number of threads may `get()` concurrently, including the
+ * first read of a compressed node. `set()` and `compress_cold()` need
+ * exclusive access, like `registry::advance()` and `registry::compact()`.
+ * References returned by `get()` are invalidated by `compress_cold()`.
+ *
+ * The sweep hook is not part of `node_base`: nodes of `by_compressed`
+ * additionally derive from `compressible_node` (via `node_policy_base`), and
+ * `compress_cold(reg)` finds them with a `dynamic_cast`.
+ *
+ * Supported value types are listed by `cold_codec`: trivially copyable
+ * types, and `std::vector`/`std::basic_string` of trivially copyable
+ * elements (restored with a default-constructed allocator).
+ */
+
+#ifndef PROPEX_COLD_H
+#define PROPEX_COLD_H
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ownership_policies.h"
+#include "propex_codec.h"
+#include "propex_memory.h"
+#include "propex_node.h"
+#include "propex_trace.h"
+
+namespace numsim::propex {
+
+/**
+ * @brief Outcome of a cold-storage sweep (`compress_cold()`).
+ * @see ownership::by_compressed
+ */
+struct cold_stats {
+    std::size_t compressed{};    ///< Nodes compressed by the sweep.
+    std::size_t bytes_before{};  ///< Payload of those nodes before compression.
+    std::size_t bytes_after{};   ///< Payload of those nodes after compression.
+
+    /// Bytes returned to the allocator.
+    [[nodiscard]] std::size_t saved() const noexcept { return bytes_before - bytes_after; }
+
+    cold_stats& operator+=(const cold_stats& other) noexcept {
+        compressed += other.compressed;
+        bytes_before += other.bytes_before;
+        bytes_after += other.bytes_after;
+        return *this;
+    }
+};
+
+/**
+ * @brief Interface of the nodes that take part in cold-storage sweeps (`ownership::by_compressed`).
+ */
+class compressible_node {
+public:
+    /// Compresses the value if it was not accessed since the previous sweep.
+    virtual cold_stats compress_cold() noexcept = 0;
+
+protected:
+    ~compressible_node() = default;
+};
+
+/**
+ * @brief Serializes values of `T` for `by_compressed`.
+ *
+ * Specializations provide `bytes(const T&)`, a view of the value's
+ * representation, and `restore(block, raw_size)`, which rebuilds the value
+ * from a compressed block of `raw_size` bytes.
+ */
+template <class T>
+struct cold_codec;
+
+template <class T>
+    requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+struct cold_codec<T> {
+    static std::span<const std::byte> bytes(const T& v) noexcept {
+        return std::as_bytes(std::span<const T, 1>(&v, 1));
+    }
+    static T restore(std::span<const std::byte> block, std::size_t) {
+        T v{};
+        codec::decompress(block, std::as_writable_bytes(std::span<T, 1>(&v, 1)));
+        return v;
+    }
+};
+
+template <class U, class Alloc>
+    requires std::is_trivially_copyable_v<U>
+struct cold_codec<std::vector<U, Alloc>> {
+    static std::span<const std::byte> bytes(const std::vector<U, Alloc>& v) noexcept {
+        return std::as_bytes(std::span<const U>(v));
+    }
+    static std::vector<U, Alloc> restore(std::span<const std::byte> block, std::size_t raw_size) {
+        std::vector<U, Alloc> v(raw_size / sizeof(U));
+        codec::decompress(block, std::as_writable_bytes(std::span<U>(v)));
+        return v;
+    }
+};
+
+template <class CharT, class Traits, class Alloc>
+struct cold_codec<std::basic_string<CharT, Traits, Alloc>> {
+    using string_type = std::basic_string<CharT, Traits, Alloc>;
+    static std::span<const std::byte> bytes(const string_type& s) noexcept {
+        return std::as_bytes(std::span<const CharT>(s.data(), s.size()));
+    }
+    static string_type restore(std::span<const std::byte> block, std::size_t raw_size) {
+        string_type s(raw_size / sizeof(CharT), CharT{});
+        codec::decompress(block, std::as_writable_bytes(std::span<CharT>(s.data(), s.size())));
+        return s;
+    }
+};
+
+} // namespace numsim::propex
+
+namespace ownership {
+
+/**
+ * @brief Keeps a value on the heap while it is used and compressed while it is cold.
+ *
+ * @tparam T Value type with a `numsim::propex::cold_codec<T>` specialization.
+ * @see propex_cold.h
+ */
+template <class T>
+class by_compressed {
+    using codec_type = numsim::propex::cold_codec<T>;
+
+public:
+    /// Constructs a new (uncompressed) instance holding a copy of @p v.
+    explicit by_compressed(const T& v) : value_(std::make_unique<T>(v)) {}
+
+    /// Constructs a new (uncompressed) instance by moving @p v in.
+    explicit by_compressed(T&& v) : value_(std::make_unique<T>(std::move(v))) {}
+
+    /// Moves the state; only valid without concurrent access (e.g. during `registry::compact()`).
+    by_compressed(by_compressed&& other) noexcept
+        : value_(std::move(other.value_)), packed_(std::move(other.packed_)), raw_size_(other.raw_size_),
+          hot_(other.hot_.load(std::memory_order_relaxed)),
+          accessed_(other.accessed_.load(std::memory_order_relaxed)),
+          incompressible_(other.incompressible_) {}
+
+    by_compressed(const by_compressed&) = delete;
+    by_compressed& operator=(const by_compressed&) = delete;
+
+    /**
+     * @brief Returns the value, decompressing it first if the node is cold.
+     * @throws std::bad_alloc or the codec's error (e.g. std::runtime_error for a corrupt
+     *         block); the value then stays compressed and the next `get()` retries.
+     */
+    const T& get() const {
+        touch();
+        if (!hot_.load(std::memory_order_acquire)) [[unlikely]] thaw();
+        return *value_;
+    }
+
+    /// Replaces the value; a compressed block is discarded.
+    template <class U>
+    void set(U&& v) {
+        touch();
+        incompressible_ = false;
+        if (hot_.load(std::memory_order_relaxed)) {
+            *value_ = std::forward<U>(v);
+        } else {
+            value_ = std::make_unique<T>(std::forward<U>(v));
+            std::vector<std::byte>().swap(packed_);
+            hot_.store(true, std::memory_order_release);
+        }
+    }
+
+    /// Calls `fn(T&)` on the value, decompressing it first if the node is cold.
+    template <class F>
+    void set_from(F&& fn) {
+        touch();
+        incompressible_ = false;
+        if (!hot_.load(std::memory_order_relaxed)) thaw();
+        std::forward<F>(fn)(*value_);
+    }
+
+    /// @return `true` while the value is held compressed.
+    [[nodiscard]] bool compressed() const noexcept { return !hot_.load(std::memory_order_acquire); }
+
+    /// Heap memory currently used: the value (and its allocations) or the compressed block.
+    [[nodiscard]] std::size_t payload_bytes() const noexcept {
+        return hot_.load(std::memory_order_acquire) ? sizeof(T) + numsim::propex::heap_bytes(*value_)
+                                                    : packed_.capacity();
+    }
+
+    /**
+     * @brief One sweep step: compresses the value if it was not accessed since the last sweep.
+     * @return What was compressed (nothing if the value was used, already cold, or barely shrinks).
+     */
+    numsim::propex::cold_stats compress_cold() noexcept {
+        if (accessed_.exchange(false, std::memory_order_relaxed) || incompressible_
+            || !hot_.load(std::memory_order_relaxed))
+            return {};
+        try {
+            const std::size_t before = payload_bytes();
+            const auto raw = codec_type::bytes(*value_);
+            auto block = numsim::propex::codec::compress(raw);
+            if (block.size() > before - before / 8) {  // not worth the access latency
+                incompressible_ = true;
+                return {};
+            }
+            block.shrink_to_fit();
+            raw_size_ = raw.size();
+            packed_ = std::move(block);
+            value_.reset();
+            hot_.store(false, std::memory_order_release);
+            return {1, before, packed_.capacity()};
+        } catch (...) {
+            return {};  // out of memory: stay uncompressed
+        }
+    }
+
+private:
+    void touch() const noexcept {
+        // Only write the shared flag when it changes.
+        if (!accessed_.load(std::memory_order_relaxed)) accessed_.store(true, std::memory_order_relaxed);
+    }
+
+    [[gnu::noinline]] void thaw() const {
+        std::lock_guard guard(lock_);
+        if (hot_.load(std::memory_order_relaxed)) return;  // another reader was faster
+        value_ = std::make_unique<T>(codec_type::restore(packed_, raw_size_));
+        std::vector<std::byte>().swap(packed_);
+        hot_.store(true, std::memory_order_release);
+    }
+
+    mutable std::unique_ptr<T> value_;
+    mutable std::vector<std::byte> packed_;
+    std::size_t raw_size_{0};
+    mutable std::atomic<bool> hot_{true};
+    /// New values count as accessed, so they survive at least one sweep.
+    mutable std::atomic<bool> accessed_{true};
+    bool incompressible_{false};
+    mutable spinlock lock_;
+};
+
+// by_compressed<T>
+template<class T>
+struct storage_traits<by_compressed<T>> {
+    static inline const T& get(const by_compressed<T>& s) { return s.get(); }
+    template<class U>
+    static inline void set(by_compressed<T>& s, U&& v) { s.set(std::forward<U>(v)); }
+    template<class F>
+    static inline void set_from(by_compressed<T>& s, F&& fn) { s.set_from(std::forward<F>(fn)); }
+    template<class E>
+    static inline void load(const by_compressed<T>& s, std::size_t first, std::span<E> out) {
+        numsim::propex::detail::copy_range_out(s.get(), first, out);
+    }
+    template<class E>
+    static inline void store(by_compressed<T>& s, std::size_t first, std::span<const E> in) {
+        s.set_from([&](T& v) { numsim::propex::detail::copy_range_in(v, first, in); });
+    }
+};
+
+template <class T>
+struct storage_memory<by_compressed<T>> {
+    static std::size_t heap_bytes(const by_compressed<T>& s) noexcept { return s.payload_bytes(); }
+};
+
+} // namespace ownership
+
+namespace numsim::propex {
+
+/// Nodes of `by_compressed` implement `compressible_node`.
+template <class T, class Node>
+struct node_policy_base<ownership::by_compressed<T>, Node> : compressible_node {
+    cold_stats compress_cold() noexcept final { return static_cast<Node&>(*this).storage_.compress_cold(); }
+};
+
+/**
+ * @brief Compresses every `ownership::by_compressed` node of @p reg not accessed since the last call.
+ *
+ * Call it periodically (e.g. every few hundred time steps); the interval
+ * between two calls is the idle time after which a property counts as
+ * cold. Must not run concurrently with accesses to the registry's nodes.
+ *
+ * @return Number of nodes compressed and the bytes saved.
+ */
+template <class Registry>
+    requires requires(Registry& reg) { { *reg.data().begin()->second } -> std::convertible_to<node_base&>; }
+cold_stats compress_cold(Registry& reg) noexcept {
+    PROPEX_TRACE_SCOPE("registry", "compress_cold");
+    cold_stats total;
+    for (auto& entry : reg.data())
+        if (auto* cold = dynamic_cast<compressible_node*>(std::to_address(entry.second)))
+            total += cold->compress_cold();
+    return total;
+}
+
+} // namespace numsim::propex
+
+#endif // PROPEX_COLD_H
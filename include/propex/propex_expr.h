@@ -0,0 +1,274 @@
+/**
+ * @file propex_expr.h
+ * @brief Expression templates for fused element-wise updates of field properties.
+ *
+ * @details
+ * Field views (array-valued properties with stable storage, see
+ * propex_field.h) can be combined with `+`, `-`, `*`, `/` and scalars. The
+ * operators only build a lightweight expression of spans and scalars;
+ * `assign()` evaluates it in one loop over the elements, without temporary
+ * arrays, which the compiler can vectorize:
+ *
+ * @code
+ * property_view<aligned_vector<double>, node, ownership::by_value> u(&un), v(&vn), w(&wn);
+ * assign(u, u + dt * v - c * w);            // u[i] = u[i] + dt * v[i] - c * w[i]
+ * parallel_assign(u, u + dt * v - c * w);   // same, chunked into tasks on shared_scheduler()
+ * @endcode
+ *
+ * Operands are field views, other expressions, arithmetic scalars and
+ * `field_ref`s over plain spans. Elements are combined index by index, so
+ * the target may appear on the right-hand side. All fields of an expression
+ * must have the same size (`std::invalid_argument` otherwise).
+ *
+ * Expressions refer to the fields' current storage: build and evaluate
+ * them in one statement, or at least before any operand is resized.
+ */
+
+#ifndef PROPEX_EXPR_H
+#define PROPEX_EXPR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "property_view.h"
+#include "propex_field.h"
+#include "propex_scheduler.h"
+
+namespace numsim::propex {
+
+/// Size reported by scalar operands, which match fields of any size.
+inline constexpr std::size_t broadcast_size = std::numeric_limits<std::size_t>::max();
+
+/// Expression leaf referring to the elements of a field.
+template <class E>
+struct field_ref {
+    std::span<const E> data;
+
+    using value_type = E;
+    [[nodiscard]] E operator[](std::size_t i) const noexcept { return data[i]; }
+    [[nodiscard]] std::size_t size() const noexcept { return data.size(); }
+};
+
+template <class E, std::size_t N>
+field_ref(std::span<E, N>) -> field_ref<std::remove_const_t<E>>;
+
+/// Expression leaf broadcasting a scalar to every element.
+template <class S>
+struct field_scalar {
+    S value;
+
+    using value_type = S;
+    [[nodiscard]] S operator[](std::size_t) const noexcept { return value; }
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return broadcast_size; }
+};
+
+/// `Op(a[i])` for every element.
+template <class Op, class A>
+struct field_unary {
+    A a;
+
+    [[nodiscard]] auto operator[](std::size_t i) const noexcept { return Op{}(a[i]); }
+    [[nodiscard]] std::size_t size() const noexcept { return a.size(); }
+};
+
+/// `Op(l[i], r[i])` for every element.
+template <class Op, class L, class R>
+struct field_binary {
+    L l;
+    R r;
+
+    /// @throws std::invalid_argument if both operands are fields of different sizes.
+    field_binary(L lhs, R rhs) : l(std::move(lhs)), r(std::move(rhs)) {
+        if (l.size() != r.size() && l.size() != broadcast_size && r.size() != broadcast_size)
+            throw std::invalid_argument("field expression: operand sizes differ");
+    }
+
+    [[nodiscard]] auto operator[](std::size_t i) const noexcept { return Op{}(l[i], r[i]); }
+    [[nodiscard]] std::size_t size() const noexcept { return l.size() == broadcast_size ? r.size() : l.size(); }
+};
+
+namespace detail {
+
+template <class T>
+struct is_field_expression : std::false_type {};
+template <class E>
+struct is_field_expression<field_ref<E>> : std::true_type {};
+template <class S>
+struct is_field_expression<field_scalar<S>> : std::true_type {};
+template <class Op, class A>
+struct is_field_expression<field_unary<Op, A>> : std::true_type {};
+template <class Op, class L, class R>
+struct is_field_expression<field_binary<Op, L, R>> : std::true_type {};
+
+template <class T>
+struct is_field_view : std::false_type {};
+template <class T, template <class, template <class> class> class Node, template <class> class Ownership>
+struct is_field_view<property_view<T, Node, Ownership>> : std::bool_constant<Node<T, Ownership>::stable_field_v> {};
+
+} // namespace detail
+
+/// An expression node built by the field operators.
+template <class T>
+concept field_expression = detail::is_field_expression<std::remove_cvref_t<T>>::value;
+
+/// A `property_view` whose field can be read and written through a span.
+template <class T>
+concept field_view = detail::is_field_view<std::remove_cvref_t<T>>::value;
+
+/// Anything that can appear in a field expression.
+template <class T>
+concept field_operand = field_expression<T> || field_view<T> || std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
+/// Wraps an operand as an expression node.
+template <field_operand T>
+[[nodiscard]] auto as_field_expression(const T& x) {
+    if constexpr (field_expression<T>)
+        return x;
+    else if constexpr (field_view<T>)
+        return field_ref{x.span()};
+    else
+        return field_scalar<T>{x};
+}
+
+namespace detail {
+
+/// At least one side must be a field; scalar-only arithmetic stays built-in.
+template <class L, class R>
+concept field_operands = field_operand<L> && field_operand<R>
+    && !(std::is_arithmetic_v<std::remove_cvref_t<L>> && std::is_arithmetic_v<std::remove_cvref_t<R>>);
+
+template <class Op, class L, class R>
+auto make_binary(const L& l, const R& r) {
+    using lhs = decltype(as_field_expression(l));
+    using rhs = decltype(as_field_expression(r));
+    return field_binary<Op, lhs, rhs>(as_field_expression(l), as_field_expression(r));
+}
+
+/// Elements each thread evaluates at least in `parallel_assign()`.
+inline constexpr std::size_t parallel_grain = std::size_t{1} << 14;
+
+/// Elements from @p p to the next cache-line boundary, or 0 if no element of the array starts on one.
+template <class E>
+std::size_t elements_to_cache_line(const E* p) noexcept {
+    constexpr std::size_t line = simd_alignment;
+    const std::size_t misalign = reinterpret_cast<std::uintptr_t>(p) % line;
+    if (line % sizeof(E) != 0 || misalign % sizeof(E) != 0) return 0;
+    return (line - misalign) % line / sizeof(E);
+}
+
+template <class E, std::size_t N, class X>
+void evaluate(std::span<E, N> out, const X& x, std::size_t first, std::size_t last) noexcept {
+    E* const dst = out.data();
+    for (std::size_t i = first; i < last; ++i) dst[i] = x[i];
+}
+
+template <class E, std::size_t N, class X>
+X checked_target(std::span<E, N> out, const X& x) {
+    if (x.size() != out.size() && x.size() != broadcast_size)
+        throw std::invalid_argument("field expression: size differs from the target");
+    return x;
+}
+
+} // namespace detail
+
+template <class L, class R>
+    requires detail::field_operands<L, R>
+[[nodiscard]] auto operator+(const L& l, const R& r) { return detail::make_binary<std::plus<>>(l, r); }
+
+template <class L, class R>
+    requires detail::field_operands<L, R>
+[[nodiscard]] auto operator-(const L& l, const R& r) { return detail::make_binary<std::minus<>>(l, r); }
+
+template <class L, class R>
+    requires detail::field_operands<L, R>
+[[nodiscard]] auto operator*(const L& l, const R& r) { return detail::make_binary<std::multiplies<>>(l, r); }
+
+template <class L, class R>
+    requires detail::field_operands<L, R>
+[[nodiscard]] auto operator/(const L& l, const R& r) { return detail::make_binary<std::divides<>>(l, r); }
+
+template <class A>
+    requires field_expression<A> || field_view<A>
+[[nodiscard]] auto operator-(const A& a) {
+    using operand = decltype(as_field_expression(a));
+    return field_unary<std::negate<>, operand>{as_field_expression(a)};
+}
+
+/**
+ * @brief Evaluates @p x into @p out in one fused loop.
+ * @throws std::invalid_argument if the sizes differ (scalars fill @p out).
+ */
+template <class E, std::size_t N, field_operand X>
+void assign(std::span<E, N> out, const X& x) {
+    const auto expr = detail::checked_target(out, as_field_expression(x));
+    detail::evaluate(out, expr, 0, out.size());
+}
+
+/// Evaluates @p x into the field of @p target in one fused loop.
+template <field_view V, field_operand X>
+void assign(V& target, const X& x) {
+    assign(target.span(), x);
+}
+
+/**
+ * @brief Like `assign()`, with the loop split into contiguous chunks run as tasks on @p ex.
+ *
+ * The calling thread evaluates the first chunk and helps with the rest.
+ * Chunks hold at least `detail::parallel_grain` elements (smaller fields run
+ * serially). Chunk boundaries are placed on cache-line boundaries of
+ * the actual `out.data()` address, so no two tasks write the same line. That
+ * needs `sizeof(E)` to divide the 64-byte line; for other element types
+ * neighbouring tasks may share the line at each boundary.
+ *
+ * @param threads Number of chunks; 0 uses `ex.concurrency()`.
+ * @throws std::invalid_argument if the sizes differ.
+ */
+template <executor Ex, class E, std::size_t N, field_operand X>
+void parallel_assign(Ex& ex, std::span<E, N> out, const X& x, std::size_t threads = 0) {
+    const auto expr = detail::checked_target(out, as_field_expression(x));
+    const std::size_t n = out.size();
+    if (threads == 0) threads = ex.concurrency();
+    threads = std::min(threads, std::max<std::size_t>(1, n / detail::parallel_grain));
+    if (threads <= 1) {
+        detail::evaluate(out, expr, 0, n);
+        return;
+    }
+
+    // Chunk c > 0 starts at head + c * chunk, the first element on a line boundary plus whole lines.
+    constexpr std::size_t line = std::max<std::size_t>(1, simd_alignment / sizeof(E));
+    const std::size_t head = detail::elements_to_cache_line(out.data());
+    const std::size_t chunk = ((n + threads - 1) / threads + line - 1) / line * line;
+    const std::size_t chunks = (n - head + chunk - 1) / chunk;
+    const auto start = [&](std::size_t c) { return c == 0 ? 0 : std::min(n, head + c * chunk); };
+    parallel_for(ex, chunks, [&](std::size_t first, std::size_t last) {
+        for (std::size_t c = first; c < last; ++c) detail::evaluate(out, expr, start(c), start(c + 1));
+    }, chunks);
+}
+
+/// `parallel_assign()` on `shared_scheduler()`.
+template <class E, std::size_t N, field_operand X>
+void parallel_assign(std::span<E, N> out, const X& x, std::size_t threads = 0) {
+    parallel_assign(shared_scheduler(), out, x, threads);
+}
+
+/// Evaluates @p x into the field of @p target in parallel on @p ex (see the span overload).
+template <executor Ex, field_view V, field_operand X>
+void parallel_assign(Ex& ex, V& target, const X& x, std::size_t threads = 0) {
+    parallel_assign(ex, target.span(), x, threads);
+}
+
+/// Evaluates @p x into the field of @p target in parallel on `shared_scheduler()`.
+template <field_view V, field_operand X>
+void parallel_assign(V& target, const X& x, std::size_t threads = 0) {
+    parallel_assign(shared_scheduler(), target.span(), x, threads);
+}
+
+} // namespace numsim::propex
+
+#endif // PROPEX_EXPR_H
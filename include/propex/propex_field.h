@@ -0,0 +1,132 @@
+/**
+ * @file propex_field.h
+ * @brief Element-wise access to array-valued properties and SIMD-aligned storage.
+ *
+ * @details
+ * A property whose value is a contiguous range (`std::vector`, `std::array`,
+ * `aligned_vector`) is a *field*. Reading one element through `get()` or
+ * writing one through `set()` would copy the whole container, so views of
+ * fields additionally offer:
+ *
+ *  - `span()` and `operator[]` — zero-copy access for policies that keep the
+ *    container in place (`by_value`, `by_reference`, `by_shared`, `by_lazy`,
+ *    `history<K>::type`);
+ *  - `load(first, out)` / `store(first, in)` — copies of a sub-range, for
+ *    every policy. Policies that cannot hand out a stable span (`by_atomic`,
+ *    `by_atomic_ref`, `by_spinlock`, `by_rwlock`, `by_atomic_shared`,
+ *    `by_compressed`) copy the range under their own synchronization.
+ *
+ * @code
+ * node<aligned_vector<double>> u(aligned_vector<double>(n));
+ * property_view<aligned_vector<double>, node, ownership::by_value> uv(&u);
+ * std::span<double> x = uv.span();                  // 64-byte aligned data
+ * uv[0] = 1.0;
+ *
+ * node<std::array<double, 6>, ownership::by_atomic> s(std::array<double, 6>{});
+ * property_view<std::array<double, 6>, node, ownership::by_atomic> sv(&s);
+ * sv.store(3, std::array{1.0, 2.0});                 // atomic read-modify-write
+ * @endcode
+ *
+ * `by_atomic` and `by_atomic_ref` fields larger than 16 bytes are not
+ * lock-free; GCC and Clang then call libatomic, which the `numsim-propex`
+ * CMake target links when the toolchain needs it.
+ *
+ * Spans stay valid until the container is resized or replaced (`set()`,
+ * `registry::compact()` moving an inline `std::array`).
+ */
+
+#ifndef PROPEX_FIELD_H
+#define PROPEX_FIELD_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace numsim::propex {
+
+/// Alignment of `aligned_allocator` by default: a cache line, enough for AVX-512 loads.
+inline constexpr std::size_t simd_alignment = 64;
+
+/**
+ * @brief Allocator returning storage aligned to @p Align bytes.
+ *
+ * Stateless, so containers using it move their buffers like with `std::allocator`.
+ */
+template <class T, std::size_t Align = simd_alignment>
+struct aligned_allocator {
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0,
+                  "alignment must be a power of two and at least alignof(T)");
+
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    aligned_allocator() = default;
+    template <class U>
+    aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Align}));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        ::operator delete(p, n * sizeof(T), std::align_val_t{Align});
+    }
+
+    template <class U>
+    friend bool operator==(const aligned_allocator&, const aligned_allocator<U, Align>&) noexcept {
+        return true;
+    }
+};
+
+/// `std::vector` whose data is aligned to `simd_alignment`.
+template <class T>
+using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+/// Value types that views treat as fields: contiguous ranges of known size.
+template <class T>
+concept contiguous_field = std::ranges::contiguous_range<T> && std::ranges::sized_range<T>;
+
+/// Element type of a field.
+template <contiguous_field T>
+using field_element_t = std::ranges::range_value_t<T>;
+
+namespace detail {
+
+[[noreturn, gnu::cold]] inline void throw_field_range() {
+    throw std::out_of_range("field: range exceeds the stored size");
+}
+
+// Small enough to inline, so the optimizer sees the bounds before the copies below.
+inline void check_field_range(std::size_t size, std::size_t first, std::size_t count) {
+    if (first > size || count > size - first) [[unlikely]] throw_field_range();
+}
+
+/// Copies `out.size()` elements of @p field, starting at @p first, into @p out.
+template <class Field, class E>
+void copy_range_out(const Field& field, std::size_t first, std::span<E> out) {
+    check_field_range(std::ranges::size(field), first, out.size());
+    std::copy_n(std::ranges::data(field) + first, out.size(), out.data());
+}
+
+/// Copies @p in into @p field, starting at element @p first.
+template <class Field, class E>
+void copy_range_in(Field& field, std::size_t first, std::span<const E> in) {
+    check_field_range(std::ranges::size(field), first, in.size());
+    std::copy(in.begin(), in.end(), std::ranges::data(field) + first);
+}
+
+} // namespace detail
+
+} // namespace numsim::propex
+
+#endif // PROPEX_FIELD_H
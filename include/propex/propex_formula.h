@@ -0,0 +1,621 @@
+/**
+ * @file propex_formula.h
+ * @brief Compiles runtime-defined formulas over registry keys to register bytecode.
+ *
+ * @details
+ * Derived properties read from input files, such as
+ * `"mat:G = mat:E / (2*(1+mat:nu))"`, are compiled once by
+ * `compile_formula()`:
+ *
+ *  1. keys are resolved to node handles (no lookups during evaluation);
+ *  2. the expression is built as a DAG in which identical sub-expressions
+ *     are shared (common-subexpression elimination) and operations on
+ *     constants are folded, along with `x+0`, `x*1`, `x/1`, `x^1` and `--x`;
+ *     `x^2` becomes `x*x`;
+ *  3. the DAG is lowered to three-address bytecode over a small register
+ *     file, reusing registers after their last use.
+ *
+ * Evaluation runs every instruction over a batch of up to
+ * `formula_batch` elements, so the inner loops are plain element-wise
+ * loops the compiler vectorizes. Scalar inputs are broadcast, field inputs
+ * (`std::vector<double>`, `std::array<double, N>`, `aligned_vector<double>`,
+ * `by_mmap<double>`, ...) are read in place when their policy allows it
+ * and copied batch-wise otherwise.
+ *
+ * Grammar: `[key =] expr` with `+ - * / ^`, unary minus, parentheses,
+ * numbers, keys (`[A-Za-z_][A-Za-z0-9_:.]*`) and the functions `sqrt`,
+ * `exp`, `log`, `abs`, `pow`, `min`, `max`.
+ *
+ * @code
+ * formula shear = compile_formula(reg, "mat:G = mat:E / (2*(1+mat:nu))");
+ * shear.apply();                       // writes mat:G
+ * double G = shear.value();            // or evaluate without writing
+ *
+ * formula energy = compile_formula(reg, "0.5 * field:rho * field:v^2");
+ * energy.evaluate(std::span(out));     // element-wise over the fields
+ * @endcode
+ *
+ * Handles are node pointers: recompile after erasing a key or after
+ * `registry::compact(compact_mode::relocate_nodes)`. Evaluation is const
+ * and works on stack scratch (up to 32 inputs and `formula_scratch`
+ * doubles of registers), so one formula may be evaluated from several
+ * threads.
+ */
+
+#ifndef PROPEX_FORMULA_H
+#define PROPEX_FORMULA_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <typeinfo>
+#include <vector>
+#include "propex_node.h"
+
+namespace numsim::propex {
+
+/// Elements per instruction dispatch.
+inline constexpr std::size_t formula_batch = 128;
+/// Doubles of stack scratch per evaluation; larger register files fall back to the heap.
+inline constexpr std::size_t formula_scratch = 4096;
+
+/**
+ * @brief How formulas read and write nodes, built on `node_base::elements()`.
+ *
+ * Numeric values are arithmetic scalars, converted to and from `double`,
+ * and fields of `double`, which are read in place where the policy allows it.
+ */
+struct numeric_access {
+    /// `size()` of values that formulas cannot read.
+    static constexpr std::size_t not_numeric = static_cast<std::size_t>(-1);
+
+    /// 1 for arithmetic scalars, the element count of fields of `double`, `not_numeric` otherwise.
+    [[nodiscard]] static std::size_t size(const node_base& n) {
+        const element_ops* ops = numeric_ops(n);
+        if (!ops) return not_numeric;
+        return ops->field ? ops->size(n) : 1;
+    }
+
+    /// The stored `double`s if the policy keeps them in place, otherwise `nullptr`.
+    [[nodiscard]] static const double* data(const node_base& n) noexcept {
+        const element_ops* ops = n.elements();
+        if (!ops || *ops->element != typeid(double)) return nullptr;
+        return static_cast<const double*>(ops->data(n));
+    }
+
+    /**
+     * @brief Copies elements `[first, first + out.size())` of a numeric value into @p out.
+     * @throws std::logic_error if the value is not numeric, std::out_of_range if the range is too long.
+     */
+    static void load(const node_base& n, std::size_t first, std::span<double> out) {
+        const element_ops& ops = checked_ops(n);
+        if (*ops.element == typeid(double)) return ops.load(n, first, out.data(), out.size());
+        detail::check_field_range(1, first, out.size());
+        if (out.empty()) return;
+        visit_arithmetic(*ops.element, [&]<class A>(A*) {
+            A v;
+            ops.load(n, 0, &v, 1);
+            out[0] = static_cast<double>(v);
+        });
+    }
+
+    /**
+     * @brief Writes @p in into elements `[first, first + in.size())` of a numeric value.
+     *
+     * Does not publish the change (see `element_ops::store`).
+     * @throws std::logic_error if the value is not numeric or read-only, std::out_of_range if the range is too long.
+     */
+    static void store(node_base& n, std::size_t first, std::span<const double> in) {
+        const element_ops& ops = checked_ops(n);
+        if (!ops.store) throw std::logic_error("formula: value is read-only");
+        if (*ops.element == typeid(double)) return ops.store(n, first, in.data(), in.size());
+        detail::check_field_range(1, first, in.size());
+        if (in.empty()) return;
+        visit_arithmetic(*ops.element, [&]<class A>(A*) {
+            const A v = static_cast<A>(in[0]);
+            ops.store(n, 0, &v, 1);
+        });
+    }
+
+private:
+    using arithmetic_types =
+        std::tuple<bool, char, signed char, unsigned char, wchar_t, char8_t, char16_t, char32_t, short,
+                   unsigned short, int, unsigned, long, unsigned long, long long, unsigned long long, float,
+                   double, long double>;
+
+    /// Calls `fn(static_cast<A*>(nullptr))` for the arithmetic type `A` named by @p type.
+    template <class F>
+    static bool visit_arithmetic(const std::type_info& type, F&& fn) {
+        return [&]<class... A>(std::tuple<A...>*) {
+            return ((type == typeid(A) ? (fn(static_cast<A*>(nullptr)), true) : false) || ...);
+        }(static_cast<arithmetic_types*>(nullptr));
+    }
+
+    static const element_ops* numeric_ops(const node_base& n) noexcept {
+        const element_ops* ops = n.elements();
+        if (!ops || (ops->field && *ops->element != typeid(double))) return nullptr;
+        return ops;
+    }
+
+    static const element_ops& checked_ops(const node_base& n) {
+        const element_ops* ops = numeric_ops(n);
+        if (!ops) throw std::logic_error("formula: value is not numeric");
+        return *ops;
+    }
+};
+
+/// Bytecode operations.
+enum class formula_op : std::uint8_t { add, sub, mul, div, pow, min, max, neg, abs, sqrt, exp, log };
+
+/// `dst = op(a, b)`; unary operations ignore `b`.
+struct formula_instruction {
+    formula_op op;
+    std::uint32_t dst, a, b;
+};
+
+/**
+ * @brief A compiled formula: resolved inputs, constants and bytecode.
+ *
+ * Registers `[0, constants)` hold constants, the next `inputs().size()`
+ * registers the inputs, the rest are temporaries.
+ */
+class formula {
+public:
+    /// Keys read by the formula, in register order.
+    [[nodiscard]] const std::vector<std::string>& inputs() const noexcept { return input_keys_; }
+    /// Key written by `apply()`, empty if the formula has no target.
+    [[nodiscard]] const std::string& target() const noexcept { return target_key_; }
+    /// The bytecode.
+    [[nodiscard]] std::span<const formula_instruction> instructions() const noexcept { return code_; }
+    /// Constants after folding.
+    [[nodiscard]] std::span<const double> constants() const noexcept { return constants_; }
+    /// Total number of registers (constants, inputs and temporaries).
+    [[nodiscard]] std::size_t registers() const noexcept { return registers_; }
+
+    /**
+     * @brief Number of elements the formula produces: the common size of its field inputs, 1 without fields.
+     *
+     * Inputs of size 1 are broadcast.
+     * @throws std::invalid_argument if field inputs differ in size.
+     */
+    [[nodiscard]] std::size_t size() const {
+        std::size_t n = 1;
+        for (const node_base* in : input_nodes_) {
+            const std::size_t m = numeric_access::size(*in);
+            if (m == 1 || m == n) continue;
+            if (n != 1) throw std::invalid_argument("formula: field inputs differ in size");
+            n = m;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Evaluates the formula into @p out.
+     * @throws std::invalid_argument if `out.size() != size()`.
+     */
+    void evaluate(std::span<double> out) const {
+        const std::size_t n = size();
+        if (out.size() != n) throw std::invalid_argument("formula: output size differs from the inputs");
+        run(n, [&](std::size_t first, const double* values, std::size_t count) {
+            std::copy_n(values, count, out.data() + first);
+        });
+    }
+
+    /// Evaluates a formula without field inputs.
+    /// @throws std::logic_error if the formula has field inputs.
+    [[nodiscard]] double value() const {
+        if (size() != 1) throw std::logic_error("formula: value() of a field formula");
+        double v;
+        evaluate(std::span(&v, 1));
+        return v;
+    }
+
+    /**
+     * @brief Evaluates the formula and writes the result into its target node.
+     *
+     * The target publishes one change (`node_base::mark_changed()`) once all
+     * elements are written.
+     * @throws std::logic_error if the formula has no target or the target is not writable.
+     */
+    void apply() const {
+        if (!target_node_) throw std::logic_error("formula: no target");
+        const std::size_t n = size();
+        if (numeric_access::size(*target_node_) != n) throw std::invalid_argument("formula: target size differs from the inputs");
+        run(n, [&](std::size_t first, const double* values, std::size_t count) {
+            numeric_access::store(*target_node_, first, std::span(values, count));
+        });
+        target_node_->mark_changed();
+    }
+
+private:
+    template <class Registry>
+    friend formula compile_formula(const Registry& reg, std::string_view source);
+    friend class formula_compiler;
+    friend class sensitivity_pass;
+
+    /// Runs the bytecode over @p n elements in batches and passes each batch to @p sink.
+    template <class Sink>
+    void run(std::size_t n, Sink&& sink) const {
+        if (n == 0) return;  // empty fields: nothing to broadcast into, nothing to produce
+        const std::size_t regs = registers_;
+        std::size_t width = std::min(formula_batch, n);
+        if (regs * width > formula_scratch) width = std::max<std::size_t>(1, formula_scratch / regs / 8 * 8);
+
+        std::array<double, formula_scratch> stack_scratch;
+        std::vector<double> heap_scratch;
+        double* scratch = stack_scratch.data();
+        if (regs * width > formula_scratch) {
+            heap_scratch.resize(regs * width);
+            scratch = heap_scratch.data();
+        }
+        const auto reg = [&](std::uint32_t r) { return scratch + std::size_t{r} * width; };
+
+        // Constants and scalar inputs are broadcast once; fields are read in place where
+        // the policy allows it, otherwise copied into their register per batch.
+        struct source {
+            const double* in_place;  ///< field storage, or nullptr
+            bool reload;             ///< copy the batch into the register
+        };
+        const std::size_t inputs = input_nodes_.size();
+        const std::size_t first_input = constants_.size();
+        std::array<source, 32> stack_sources;
+        std::vector<source> heap_sources;
+        source* sources = stack_sources.data();
+        if (inputs > stack_sources.size()) {
+            heap_sources.resize(inputs);
+            sources = heap_sources.data();
+        }
+        for (std::size_t c = 0; c < first_input; ++c) std::fill_n(reg(c), width, constants_[c]);
+        for (std::size_t i = 0; i < inputs; ++i) {
+            const node_base* in = input_nodes_[i];
+            sources[i] = {nullptr, false};
+            if (n > 1 && numeric_access::size(*in) == n) {
+                const double* in_place = numeric_access::data(*in);
+                sources[i] = {in_place, in_place == nullptr};
+                continue;
+            }
+            double v;
+            numeric_access::load(*in, 0, std::span(&v, 1));
+            std::fill_n(reg(first_input + i), width, v);
+        }
+
+        for (std::size_t first = 0; first < n; first += width) {
+            const std::size_t count = std::min(width, n - first);
+            for (std::size_t i = 0; i < inputs; ++i)
+                if (sources[i].reload) numeric_access::load(*input_nodes_[i], first, std::span(reg(first_input + i), count));
+            const auto operand = [&](std::uint32_t r) -> const double* {
+                const std::size_t i = r - first_input;
+                if (r >= first_input && i < inputs && sources[i].in_place) return sources[i].in_place + first;
+                return reg(r);
+            };
+            for (const formula_instruction& ins : code_)
+                execute(ins.op, reg(ins.dst), operand(ins.a), operand(ins.b), count);
+            sink(first, operand(result_), count);
+        }
+    }
+
+    static void execute(formula_op op, double* d, const double* a, const double* b, std::size_t n) noexcept {
+        switch (op) {
+            case formula_op::add: for (std::size_t k = 0; k < n; ++k) d[k] = a[k] + b[k]; break;
+            case formula_op::sub: for (std::size_t k = 0; k < n; ++k) d[k] = a[k] - b[k]; break;
+            case formula_op::mul: for (std::size_t k = 0; k < n; ++k) d[k] = a[k] * b[k]; break;
+            case formula_op::div: for (std::size_t k = 0; k < n; ++k) d[k] = a[k] / b[k]; break;
+            case formula_op::pow: for (std::size_t k = 0; k < n; ++k) d[k] = std::pow(a[k], b[k]); break;
+            case formula_op::min: for (std::size_t k = 0; k < n; ++k) d[k] = std::min(a[k], b[k]); break;
+            case formula_op::max: for (std::size_t k = 0; k < n; ++k) d[k] = std::max(a[k], b[k]); break;
+            case formula_op::neg: for (std::size_t k = 0; k < n; ++k) d[k] = -a[k]; break;
+            case formula_op::abs: for (std::size_t k = 0; k < n; ++k) d[k] = std::abs(a[k]); break;
+            case formula_op::sqrt: for (std::size_t k = 0; k < n; ++k) d[k] = std::sqrt(a[k]); break;
+            case formula_op::exp: for (std::size_t k = 0; k < n; ++k) d[k] = std::exp(a[k]); break;
+            case formula_op::log: for (std::size_t k = 0; k < n; ++k) d[k] = std::log(a[k]); break;
+        }
+    }
+
+    std::vector<double> constants_;
+    std::vector<std::string> input_keys_;
+    std::vector<const node_base*> input_nodes_;
+    std::string target_key_;
+    node_base* target_node_{nullptr};
+    std::vector<formula_instruction> code_;
+    std::uint32_t result_{0};
+    std::size_t registers_{0};
+};
+
+/**
+ * @brief Parser and code generator behind `compile_formula()`.
+ *
+ * Keys are passed to a resolver returning the node (or `nullptr`), so the
+ * compiler does not depend on the registry type.
+ */
+class formula_compiler {
+public:
+    template <class Resolve>
+    static formula compile(std::string_view source, Resolve&& resolve) {
+        formula_compiler c(source);
+        formula f;
+
+        // Optional "target =" prefix.
+        if (const auto eq = source.find('='); eq != std::string_view::npos) {
+            formula_compiler lhs(source.substr(0, eq));
+            lhs.skip_space();
+            const std::string_view key = lhs.identifier();
+            lhs.skip_space();
+            if (key.empty() || !lhs.at_end()) throw std::invalid_argument("formula: invalid assignment target");
+            f.target_key_ = std::string(key);
+            f.target_node_ = resolve(key);
+            if (!f.target_node_) throw std::out_of_range("formula: unknown key '" + f.target_key_ + "'");
+            c.pos_ = eq + 1;
+        }
+
+        const std::uint32_t root = c.expression();
+        c.skip_space();
+        if (!c.at_end()) c.fail("unexpected character");
+
+        for (const std::string& key : c.keys_) {
+            node_base* n = resolve(key);
+            if (!n) throw std::out_of_range("formula: unknown key '" + key + "'");
+            if (numeric_access::size(*n) == numeric_access::not_numeric)
+                throw std::invalid_argument("formula: '" + key + "' is not numeric");
+            f.input_nodes_.push_back(n);
+        }
+        c.lower(root, f);
+        return f;
+    }
+
+private:
+    enum class kind : std::uint8_t { constant, input, op };
+
+    struct dag_node {
+        kind k;
+        formula_op op{};
+        std::uint32_t a{}, b{};
+        double value{};
+        std::uint32_t input{};
+    };
+
+    explicit formula_compiler(std::string_view src) : src_(src) {}
+
+    // ---- DAG construction: CSE and constant folding -------------------------------------------
+
+    std::uint32_t intern(const dag_node& n) {
+        std::uint64_t payload = 0;
+        if (n.k == kind::constant) payload = std::bit_cast<std::uint64_t>(n.value);
+        if (n.k == kind::input) payload = n.input;
+        const auto key = std::make_tuple(static_cast<int>(n.k), static_cast<int>(n.op), n.a, n.b, payload);
+        const auto [it, inserted] = index_.try_emplace(key, static_cast<std::uint32_t>(nodes_.size()));
+        if (inserted) nodes_.push_back(n);
+        return it->second;
+    }
+
+    std::uint32_t constant(double v) { return intern({kind::constant, {}, 0, 0, v, 0}); }
+
+    std::uint32_t input(std::string_view key) {
+        const auto it = std::find(keys_.begin(), keys_.end(), key);
+        const auto i = static_cast<std::uint32_t>(it - keys_.begin());
+        if (it == keys_.end()) keys_.emplace_back(key);
+        return intern({kind::input, {}, 0, 0, 0.0, i});
+    }
+
+    bool is_constant(std::uint32_t n, double v) const {
+        return nodes_[n].k == kind::constant && nodes_[n].value == v;
+    }
+
+    static bool unary(formula_op op) noexcept { return op >= formula_op::neg; }
+    static bool commutative(formula_op op) noexcept {
+        return op == formula_op::add || op == formula_op::mul || op == formula_op::min || op == formula_op::max;
+    }
+
+    std::uint32_t op(formula_op o, std::uint32_t a, std::uint32_t b = 0) {
+        const bool folded = nodes_[a].k == kind::constant && (unary(o) || nodes_[b].k == kind::constant);
+        if (folded) {
+            double r;
+            formula::execute(o, &r, &nodes_[a].value, &nodes_[unary(o) ? a : b].value, 1);
+            return constant(r);
+        }
+        if (!unary(o)) {
+            if ((o == formula_op::add || o == formula_op::sub) && is_constant(b, 0.0)) return a;
+            if ((o == formula_op::mul || o == formula_op::div) && is_constant(b, 1.0)) return a;
+            if (o == formula_op::add && is_constant(a, 0.0)) return b;
+            if (o == formula_op::mul && is_constant(a, 1.0)) return b;
+            if (o == formula_op::pow && is_constant(b, 1.0)) return a;
+            if (o == formula_op::pow && is_constant(b, 2.0)) return op(formula_op::mul, a, a);  // exact, no pow()
+            if (commutative(o) && b < a) std::swap(a, b);
+        } else {
+            if (o == formula_op::neg && nodes_[a].k == kind::op && nodes_[a].op == formula_op::neg) return nodes_[a].a;
+            b = 0;
+        }
+        return intern({kind::op, o, a, b, 0.0, 0});
+    }
+
+    // ---- Recursive descent parser -------------------------------------------------------------
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::invalid_argument("formula: " + std::string(what) + " at position " + std::to_string(pos_)
+                                    + " in '" + std::string(src_) + "'");
+    }
+
+    void skip_space() {
+        while (pos_ < src_.size() && (src_[pos_] == ' ' || src_[pos_] == '\t')) ++pos_;
+    }
+    [[nodiscard]] bool at_end() const { return pos_ >= src_.size(); }
+    bool accept(char ch) {
+        skip_space();
+        if (pos_ < src_.size() && src_[pos_] == ch) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+    void expect(char ch) {
+        if (!accept(ch)) fail(ch == ')' ? "expected ')'" : "expected ','");
+    }
+
+    static bool ident_start(char ch) { return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_'; }
+    static bool ident_char(char ch) { return ident_start(ch) || (ch >= '0' && ch <= '9') || ch == ':' || ch == '.'; }
+
+    std::string_view identifier() {
+        const std::size_t start = pos_;
+        if (pos_ < src_.size() && ident_start(src_[pos_]))
+            while (pos_ < src_.size() && ident_char(src_[pos_])) ++pos_;
+        return src_.substr(start, pos_ - start);
+    }
+
+    std::uint32_t expression() {
+        std::uint32_t lhs = term();
+        for (;;) {
+            if (accept('+')) lhs = op(formula_op::add, lhs, term());
+            else if (accept('-')) lhs = op(formula_op::sub, lhs, term());
+            else return lhs;
+        }
+    }
+
+    std::uint32_t term() {
+        std::uint32_t lhs = factor();
+        for (;;) {
+            if (accept('*')) lhs = op(formula_op::mul, lhs, factor());
+            else if (accept('/')) lhs = op(formula_op::div, lhs, factor());
+            else return lhs;
+        }
+    }
+
+    std::uint32_t factor() {
+        if (accept('-')) return op(formula_op::neg, factor());
+        if (accept('+')) return factor();
+        const std::uint32_t base = primary();
+        if (accept('^')) return op(formula_op::pow, base, factor());  // right-associative
+        return base;
+    }
+
+    std::uint32_t primary() {
+        skip_space();
+        if (at_end()) fail("unexpected end");
+        if (accept('(')) {
+            const std::uint32_t e = expression();
+            expect(')');
+            return e;
+        }
+        const char ch = src_[pos_];
+        if ((ch >= '0' && ch <= '9') || ch == '.') {
+            double v;
+            const auto [end, ec] = std::from_chars(src_.data() + pos_, src_.data() + src_.size(), v);
+            if (ec != std::errc{}) fail("invalid number");
+            pos_ = static_cast<std::size_t>(end - src_.data());
+            return constant(v);
+        }
+        const std::size_t start = pos_;
+        const std::string_view name = identifier();
+        if (name.empty()) fail("unexpected character");
+        if (accept('(')) return call(name, start);
+        return input(name);
+    }
+
+    std::uint32_t call(std::string_view name, std::size_t start) {
+        static constexpr std::array<std::pair<std::string_view, formula_op>, 4> unary_fns{
+            {{"sqrt", formula_op::sqrt}, {"exp", formula_op::exp}, {"log", formula_op::log}, {"abs", formula_op::abs}}};
+        static constexpr std::array<std::pair<std::string_view, formula_op>, 3> binary_fns{
+            {{"pow", formula_op::pow}, {"min", formula_op::min}, {"max", formula_op::max}}};
+        for (const auto& [fn, o] : unary_fns)
+            if (name == fn) {
+                const std::uint32_t a = expression();
+                expect(')');
+                return op(o, a);
+            }
+        for (const auto& [fn, o] : binary_fns)
+            if (name == fn) {
+                const std::uint32_t a = expression();
+                expect(',');
+                const std::uint32_t b = expression();
+                expect(')');
+                return op(o, a, b);
+            }
+        pos_ = start;
+        fail("unknown function");
+    }
+
+    // ---- Lowering to register bytecode --------------------------------------------------------
+
+    void lower(std::uint32_t root, formula& f) const {
+        // Nodes reachable from the root; folding leaves the replaced ones behind.
+        std::vector<bool> live(nodes_.size(), false);
+        live[root] = true;
+        for (std::size_t n = nodes_.size(); n-- > 0;)
+            if (live[n] && nodes_[n].k == kind::op) {
+                live[nodes_[n].a] = true;
+                if (!unary(nodes_[n].op)) live[nodes_[n].b] = true;
+            }
+
+        std::vector<std::uint32_t> reg(nodes_.size(), 0);
+        for (std::size_t n = 0; n < nodes_.size(); ++n)
+            if (live[n] && nodes_[n].k == kind::constant) {
+                reg[n] = static_cast<std::uint32_t>(f.constants_.size());
+                f.constants_.push_back(nodes_[n].value);
+            }
+        const auto first_input = static_cast<std::uint32_t>(f.constants_.size());
+        for (std::size_t n = 0; n < nodes_.size(); ++n)
+            if (nodes_[n].k == kind::input) reg[n] = first_input + nodes_[n].input;
+        for (std::size_t i = 0; i < keys_.size(); ++i) f.input_keys_.push_back(keys_[i]);
+
+        // Last use of every operation, so its register can be recycled afterwards.
+        std::vector<std::size_t> last_use(nodes_.size(), 0);
+        for (std::size_t n = 0; n < nodes_.size(); ++n)
+            if (live[n] && nodes_[n].k == kind::op) {
+                last_use[nodes_[n].a] = n;
+                if (!unary(nodes_[n].op)) last_use[nodes_[n].b] = n;
+            }
+
+        const auto first_temp = static_cast<std::uint32_t>(first_input + keys_.size());
+        std::uint32_t next_temp = first_temp;
+        std::vector<std::uint32_t> free_regs;
+        for (std::size_t n = 0; n < nodes_.size(); ++n) {
+            if (!live[n] || nodes_[n].k != kind::op) continue;
+            const dag_node& d = nodes_[n];
+            for (const std::uint32_t operand : {d.a, d.b}) {
+                if (unary(d.op) && operand == d.b) continue;
+                if (nodes_[operand].k == kind::op && last_use[operand] == n
+                    && std::find(free_regs.begin(), free_regs.end(), reg[operand]) == free_regs.end())
+                    free_regs.push_back(reg[operand]);
+            }
+            if (!free_regs.empty()) {
+                reg[n] = free_regs.back();
+                free_regs.pop_back();
+            } else {
+                reg[n] = next_temp++;
+            }
+            f.code_.push_back({d.op, reg[n], reg[d.a], unary(d.op) ? reg[d.a] : reg[d.b]});
+        }
+        f.result_ = reg[root];
+        f.registers_ = next_temp;
+    }
+
+    std::string_view src_;
+    std::size_t pos_{0};
+    std::vector<dag_node> nodes_;
+    std::map<std::tuple<int, int, std::uint32_t, std::uint32_t, std::uint64_t>, std::uint32_t> index_;
+    std::vector<std::string> keys_;
+};
+
+/**
+ * @brief Compiles @p source, resolving its keys in @p reg.
+ * @throws std::invalid_argument on syntax errors or non-numeric inputs,
+ *         std::out_of_range for unknown keys.
+ */
+template <class Registry>
+[[nodiscard]] formula compile_formula(const Registry& reg, std::string_view source) {
+    return formula_compiler::compile(source, [&](std::string_view key) -> node_base* {
+        return reg.find(typename Registry::key_type(key));
+    });
+}
+
+} // namespace numsim::propex
+
+#endif // PROPEX_FORMULA_H
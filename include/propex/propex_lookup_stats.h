@@ -0,0 +1,282 @@
+/**
+ * @file propex_lookup_stats.h
+ * @brief Lookup-path statistics and key-distribution diagnostics for registries.
+ *
+ * @details
+ * Two independent tools:
+ *
+ * - **Lookup instrumentation** (`PROPEX_ENABLE_LOOKUP_STATS`): every
+ *   `find()`/`contains()`/`at()` records hit or miss. For hashed maps, every
+ *   `lookup_counters::chain_sample_period`-th hit and miss also records its
+ *   probe length: the entries of the bucket compared until the key was found
+ *   (all of them for a miss). Measuring it walks the bucket a second time, so
+ *   doing it for every lookup would double the cost being measured. Every
+ *   `add()` records the load factor after insertion and whether the table
+ *   was rehashed since the previous insertion. Query with
+ *   `registry::lookup_stats()`. Counters are relaxed atomics, so concurrent
+ *   readers stay race-free. Without the macro the hooks expand to
+ *   `((void)0)` and the registry carries no extra state.
+ *
+ * - **Key diagnostics** (always available): `diagnose_keys(reg)` inspects the
+ *   current keys and table. It reports families of keys that differ only in a
+ *   trailing index (`"elem:0"`, `"elem:1"`, ... as produced by
+ *   `key_traits::merge(prefix, std::to_string(i))`), which are usually better
+ *   stored as one field property, and flags poor hash spread by comparing the
+ *   observed bucket occupancy against the Poisson distribution expected from
+ *   a good hash.
+ */
+
+#ifndef PROPEX_LOOKUP_STATS_H
+#define PROPEX_LOOKUP_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace numsim::propex {
+
+/**
+ * @brief Plain snapshot of the lookup counters of one registry.
+ */
+struct lookup_statistics {
+    /// Probe lengths >= `chain_bins - 1` share the last bin.
+    static constexpr std::size_t chain_bins = 16;
+    /// Load factor bins of width 0.1; values >= 1.0 share the last bin.
+    static constexpr std::size_t load_bins = 11;
+
+    std::uint64_t hits{};
+    std::uint64_t misses{};
+    /// Lookups whose probe length was measured (hashed maps only).
+    std::uint64_t chain_samples{};
+    /// Sum of the measured probe lengths.
+    std::uint64_t chain_total{};
+    std::uint64_t rehashes{};
+    std::array<std::uint64_t, chain_bins> chain_histogram{};
+    std::array<std::uint64_t, load_bins> load_factor_histogram{};
+
+    [[nodiscard]] constexpr std::uint64_t lookups() const noexcept { return hits + misses; }
+
+    [[nodiscard]] constexpr double hit_rate() const noexcept {
+        return lookups() ? static_cast<double>(hits) / static_cast<double>(lookups()) : 0.0;
+    }
+
+    /// Mean probe length of the sampled lookups.
+    [[nodiscard]] constexpr double mean_chain_length() const noexcept {
+        return chain_samples ? static_cast<double>(chain_total) / static_cast<double>(chain_samples) : 0.0;
+    }
+};
+
+/**
+ * @brief Live lookup counters embedded in a registry when instrumentation is enabled.
+ *
+ * Copy and move transfer a snapshot of the counts, so the owning registry
+ * stays movable.
+ */
+class lookup_counters {
+public:
+    lookup_counters() = default;
+    lookup_counters(const lookup_counters& other) noexcept { assign(other.snapshot()); }
+    lookup_counters& operator=(const lookup_counters& other) noexcept {
+        if (this != &other) assign(other.snapshot());
+        return *this;
+    }
+
+    /// The first and then every n-th hit, and likewise miss, has its probe length measured.
+    static constexpr std::uint64_t chain_sample_period = 16;
+
+    /// Records one lookup of @p key in @p map.
+    template <class Map, class Key>
+    void record_lookup(const Map& map, const Key& key, bool hit) noexcept {
+        const auto n = (hit ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+        if constexpr (requires { map.bucket(key); map.begin(std::size_t{}); map.key_eq(); }) {
+            if (n % chain_sample_period == 0) [[unlikely]] record_probes(map, key);
+        }
+    }
+
+    /// Records the state of @p map after an insertion.
+    template <class Map>
+    void record_insert(const Map& map) noexcept {
+        if constexpr (requires { map.bucket_count(); map.load_factor(); }) {
+            const auto buckets = map.bucket_count();
+            if (buckets_.exchange(buckets, std::memory_order_relaxed) != buckets)
+                rehashes_.fetch_add(1, std::memory_order_relaxed);
+            const auto bin = static_cast<std::size_t>(map.load_factor() * 10.0);
+            load_[std::min(bin, lookup_statistics::load_bins - 1)].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] lookup_statistics snapshot() const noexcept {
+        lookup_statistics s;
+        s.hits = hits_.load(std::memory_order_relaxed);
+        s.misses = misses_.load(std::memory_order_relaxed);
+        s.chain_samples = chain_samples_.load(std::memory_order_relaxed);
+        s.chain_total = chain_total_.load(std::memory_order_relaxed);
+        s.rehashes = rehashes_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < chain_.size(); ++i) s.chain_histogram[i] = chain_[i].load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < load_.size(); ++i) s.load_factor_histogram[i] = load_[i].load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void reset() noexcept { assign(lookup_statistics{}); }
+
+private:
+    /// Walks the bucket of @p key like the lookup did and records the entries compared.
+    template <class Map, class Key>
+    [[gnu::noinline]] void record_probes(const Map& map, const Key& key) noexcept {
+        if (map.bucket_count() == 0) return;
+        const auto b = map.bucket(key);
+        std::size_t probes{0};
+        for (auto it = map.begin(b); it != map.end(b); ++it) {
+            ++probes;
+            if (map.key_eq()(it->first, key)) break;
+        }
+        chain_samples_.fetch_add(1, std::memory_order_relaxed);
+        chain_total_.fetch_add(probes, std::memory_order_relaxed);
+        chain_[std::min(probes, lookup_statistics::chain_bins - 1)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void assign(const lookup_statistics& s) noexcept {
+        hits_.store(s.hits, std::memory_order_relaxed);
+        misses_.store(s.misses, std::memory_order_relaxed);
+        chain_samples_.store(s.chain_samples, std::memory_order_relaxed);
+        chain_total_.store(s.chain_total, std::memory_order_relaxed);
+        rehashes_.store(s.rehashes, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < chain_.size(); ++i) chain_[i].store(s.chain_histogram[i], std::memory_order_relaxed);
+        for (std::size_t i = 0; i < load_.size(); ++i) load_[i].store(s.load_factor_histogram[i], std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+    std::atomic<std::uint64_t> chain_samples_{0};
+    std::atomic<std::uint64_t> chain_total_{0};
+    std::atomic<std::uint64_t> rehashes_{0};
+    /// Bucket count seen at the last insertion; a change means the table was rehashed.
+    std::atomic<std::size_t> buckets_{0};
+    std::array<std::atomic<std::uint64_t>, lookup_statistics::chain_bins> chain_{};
+    std::array<std::atomic<std::uint64_t>, lookup_statistics::load_bins> load_{};
+};
+
+// -----------------------------------------------------------------------------
+// Key-distribution diagnostics
+// -----------------------------------------------------------------------------
+
+/// Keys that are identical up to a trailing decimal index.
+struct key_family {
+    /// The shared key with the index replaced by `#` (e.g. `"elem:#"`).
+    std::string pattern;
+    std::size_t count{};
+};
+
+/**
+ * @brief Result of `diagnose_keys()`.
+ */
+struct key_distribution_report {
+    std::size_t keys{};
+    /// Families with at least `min_family` members, largest first.
+    std::vector<key_family> indexed_families;
+    /// Fraction of all keys that belong to one of `indexed_families`.
+    double indexed_fraction{};
+
+    /// Hash-table shape (hashed maps only; zero otherwise).
+    std::size_t buckets{};
+    double load_factor{};
+    std::size_t max_chain{};
+    double empty_bucket_fraction{};
+    /// Fraction of empty buckets a uniform hash would leave: `exp(-load_factor)`.
+    double expected_empty_fraction{};
+
+    /// Human-readable findings; empty if nothing looks pathological.
+    std::vector<std::string> warnings;
+
+    [[nodiscard]] bool pathological() const noexcept { return !warnings.empty(); }
+};
+
+/**
+ * @brief Returns @p key with a trailing run of digits replaced by `#`, or an
+ *        empty string if the key does not end in a digit.
+ */
+[[nodiscard]] inline std::string index_pattern(std::string_view key) {
+    std::size_t end = key.size();
+    while (end > 0 && std::isdigit(static_cast<unsigned char>(key[end - 1]))) --end;
+    if (end == key.size()) return {};
+    return std::string(key.substr(0, end)) + '#';
+}
+
+/**
+ * @brief Analyzes the keys and, for hashed maps, the bucket layout of @p reg.
+ *
+ * @param reg         Registry to inspect.
+ * @param min_family  Smallest family size worth reporting.
+ */
+template <class Registry>
+[[nodiscard]] key_distribution_report diagnose_keys(const Registry& reg, std::size_t min_family = 64) {
+    const auto& map = reg.data();
+    key_distribution_report report;
+    report.keys = map.size();
+
+    std::unordered_map<std::string, std::size_t> families;
+    for (const auto& entry : map) {
+        auto pattern = index_pattern(std::string_view(entry.first));
+        if (!pattern.empty()) ++families[std::move(pattern)];
+    }
+    std::size_t indexed{0};
+    for (auto& [pattern, count] : families) {
+        if (count < min_family) continue;
+        indexed += count;
+        report.indexed_families.push_back({pattern, count});
+    }
+    std::sort(report.indexed_families.begin(), report.indexed_families.end(),
+              [](const auto& a, const auto& b) { return a.count > b.count; });
+    report.indexed_fraction = report.keys ? double(indexed) / double(report.keys) : 0.0;
+
+    for (const auto& f : report.indexed_families) {
+        report.warnings.push_back(std::to_string(f.count) + " keys differ only in a trailing index ('"
+                                  + f.pattern + "'); consider one field property instead");
+    }
+
+    if constexpr (requires { map.bucket_count(); map.bucket_size(0); }) {
+        report.buckets = map.bucket_count();
+        report.load_factor = map.load_factor();
+        std::size_t empty{0};
+        for (std::size_t b = 0; b < report.buckets; ++b) {
+            const auto size = map.bucket_size(b);
+            report.max_chain = std::max(report.max_chain, size);
+            if (size == 0) ++empty;
+        }
+        if (report.buckets > 0) {
+            report.empty_bucket_fraction = double(empty) / double(report.buckets);
+            report.expected_empty_fraction = std::exp(-report.load_factor);
+        }
+        // A uniform hash keeps chains short and the empty-bucket fraction close
+        // to the Poisson expectation; large tables with clustered keys do not.
+        if (report.keys >= 64 && (report.max_chain > 8
+                || report.empty_bucket_fraction > report.expected_empty_fraction + 0.15)) {
+            report.warnings.push_back("keys cluster in few buckets (max chain "
+                                      + std::to_string(report.max_chain) + ", "
+                                      + std::to_string(int(report.empty_bucket_fraction * 100.0))
+                                      + "% empty buckets vs. "
+                                      + std::to_string(int(report.expected_empty_fraction * 100.0))
+                                      + "% expected); check the key hash");
+        }
+    }
+    return report;
+}
+
+} // namespace numsim::propex
+
+#if defined(PROPEX_ENABLE_LOOKUP_STATS)
+#define PROPEX_LOOKUP_RECORD(map, key, hit) lookup_counters_.record_lookup(map, key, hit)
+#define PROPEX_INSERT_RECORD(map) lookup_counters_.record_insert(map)
+#else
+#define PROPEX_LOOKUP_RECORD(map, key, hit) ((void)0)
+#define PROPEX_INSERT_RECORD(map) ((void)0)
+#endif
+
+#endif // PROPEX_LOOKUP_STATS_H
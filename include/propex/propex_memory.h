@@ -0,0 +1,299 @@
+/**
+ * @file propex_memory.h
+ * @brief Memory accounting helpers for property values, storages and registries.
+ *
+ * @details
+ * `memory_traits<T>::heap_bytes(v)` reports the dynamically allocated bytes a
+ * value owns *in addition to* `sizeof(T)`. It is specialized for strings
+ * (respecting the small-string optimization) and vectors, and can be
+ * specialized for user types such as tensors or sparse matrices.
+ *
+ * `ownership::storage_memory<Storage>` applies this to the ownership policies:
+ * referenced values are not owned and therefore not counted, shared values are
+ * split evenly between their owners.
+ *
+ * Container overheads (map nodes, bucket arrays, control blocks) are derived
+ * from the layout of the standard library implementations and are estimates;
+ * value and key sizes are exact for the types specialized here, but ignore
+ * allocator headers and rounding.
+ *
+ * Where the memory really comes from an allocator propex can see, it is
+ * measured instead: a registry whose `std::pmr` allocator draws from an
+ * `accounting_resource` reports the bytes that resource handed out in
+ * `memory_footprint::measured_bytes`.
+ *
+ * @see registry::memory_usage()
+ */
+
+#ifndef PROPEX_MEMORY_H
+#define PROPEX_MEMORY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <typeindex>
+#include <vector>
+#include "ownership_policies.h"
+
+namespace numsim::propex {
+
+/**
+ * @brief Heap bytes owned by a value beyond its own `sizeof`.
+ *
+ * The primary template assumes the value owns no dynamic memory.
+ */
+template <class T>
+struct memory_traits {
+    static constexpr std::size_t heap_bytes(const T&) noexcept { return 0; }
+};
+
+/// Strings own heap memory only when they outgrow the small-string buffer.
+template <class CharT, class Traits, class Alloc>
+struct memory_traits<std::basic_string<CharT, Traits, Alloc>> {
+    using string_type = std::basic_string<CharT, Traits, Alloc>;
+
+    /// @return `true` if the characters are stored inside the string object (SSO).
+    static bool is_inline(const string_type& s) noexcept {
+        const auto* data = reinterpret_cast<const unsigned char*>(s.data());
+        const auto* self = reinterpret_cast<const unsigned char*>(&s);
+        return data >= self && data < self + sizeof(string_type);
+    }
+
+    static std::size_t heap_bytes(const string_type& s) noexcept {
+        return is_inline(s) ? 0 : (s.capacity() + 1) * sizeof(CharT);
+    }
+};
+
+/// Vectors own their capacity plus whatever the elements own.
+template <class T, class Alloc>
+struct memory_traits<std::vector<T, Alloc>> {
+    static std::size_t heap_bytes(const std::vector<T, Alloc>& v) noexcept {
+        std::size_t bytes = v.capacity() * sizeof(T);
+        for (const auto& e : v) bytes += memory_traits<T>::heap_bytes(e);
+        return bytes;
+    }
+};
+
+/// Convenience wrapper around `memory_traits<T>::heap_bytes`.
+template <class T>
+[[nodiscard]] inline std::size_t heap_bytes(const T& v) noexcept {
+    return memory_traits<T>::heap_bytes(v);
+}
+
+/// Estimated size of a `std::shared_ptr` control block: vtable pointer, use/weak counts and the owned pointer.
+inline constexpr std::size_t shared_control_block_bytes = 2 * sizeof(int) + 2 * sizeof(void*);
+
+/**
+ * @brief Estimated per-element overhead of the registry's index container.
+ *
+ * Node-based maps allocate one node per element holding the `value_type` plus
+ * links; hashed maps additionally cache the hash and own a bucket array.
+ */
+template <class Map>
+struct index_memory {
+    static constexpr bool hashed = requires(const Map& m) { m.bucket_count(); };
+
+    /// Bytes of one allocated element node, including the embedded `value_type`.
+    static constexpr std::size_t node_bytes() noexcept {
+        if constexpr (hashed)
+            return sizeof(typename Map::value_type) + 2 * sizeof(void*);   // next link + cached hash
+        else
+            return sizeof(typename Map::value_type) + 4 * sizeof(void*);   // color + parent/left/right
+    }
+
+    /// Bytes of the bucket array (hashed maps only).
+    static std::size_t bucket_bytes(const Map& m) noexcept {
+        if constexpr (hashed) return m.bucket_count() * sizeof(void*);
+        else return 0;
+    }
+};
+
+/**
+ * @brief Memory resource that forwards to @p upstream and counts the bytes in use.
+ *
+ * Give it to a `pmr::registry` (and to `pmr::make_unique` and `std::pmr`
+ * values) to have `registry::memory_usage()` report measured instead of
+ * estimated bytes. Thread-safe if the upstream resource is.
+ *
+ * @code
+ * accounting_resource counted(&arena);
+ * pmr::registry<node_base> reg(&counted);
+ * reg.add(pmr::make_unique<node<double>>(&counted, 1.0), "mat", "E");
+ * reg.memory_usage().measured_bytes;   // index, keys and node, as allocated
+ * @endcode
+ */
+class accounting_resource final : public std::pmr::memory_resource {
+public:
+    explicit accounting_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : upstream_(upstream) {}
+
+    accounting_resource(const accounting_resource&) = delete;
+    accounting_resource& operator=(const accounting_resource&) = delete;
+
+    /// Bytes allocated and not yet deallocated.
+    [[nodiscard]] std::size_t bytes_in_use() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+    /// Number of allocations so far (cumulative).
+    [[nodiscard]] std::size_t allocations() const noexcept { return allocations_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = upstream_->allocate(bytes, alignment);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+        bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::atomic<std::size_t> bytes_{0};
+    std::atomic<std::size_t> allocations_{0};
+};
+
+/**
+ * @brief Memory breakdown of a registry, as returned by `registry::memory_usage()`.
+ *
+ * All fields but `measured_bytes` are computed from the entries and partly
+ * estimated (see propex_memory.h).
+ */
+struct memory_footprint {
+    /// Number of properties.
+    std::size_t properties{};
+    /// `sizeof` the registry object itself.
+    std::size_t registry_object{};
+    /// Map element nodes, excluding the key/pointer bytes accounted below.
+    std::size_t index_nodes{};
+    /// Bucket array of hashed maps.
+    std::size_t index_buckets{};
+    /// Key objects stored inside the map nodes.
+    std::size_t key_objects{};
+    /// Heap bytes of keys that exceed the small-string buffer.
+    std::size_t key_heap{};
+    /// Number of keys stored inline (SSO) / on the heap.
+    std::size_t keys_inline{};
+    std::size_t keys_on_heap{};
+    /// Node pointers stored in the map plus smart-pointer control blocks.
+    std::size_t node_pointers{};
+    /// Concrete node objects (including values stored inline, e.g. `by_value`).
+    std::size_t node_objects{};
+    /// Heap memory owned by the stored values.
+    std::size_t payload_heap{};
+    /// `node_objects + payload_heap` grouped by the stored value type.
+    std::map<std::type_index, std::size_t> by_type;
+    /// Whether `measured_bytes` is available: the registry allocates from an `accounting_resource`.
+    bool measured{false};
+    /// Bytes in use in that resource: the index and keys, plus whatever else was allocated from it.
+    std::size_t measured_bytes{};
+
+    /// Total bytes attributed to the registry.
+    [[nodiscard]] constexpr std::size_t total() const noexcept {
+        return registry_object + index_nodes + index_buckets + key_objects + key_heap
+             + node_pointers + node_objects + payload_heap;
+    }
+
+    /// Average bytes per property (0 for an empty registry).
+    [[nodiscard]] constexpr double bytes_per_property() const noexcept {
+        return properties ? static_cast<double>(total()) / static_cast<double>(properties) : 0.0;
+    }
+};
+
+} // namespace numsim::propex
+
+namespace ownership {
+
+/**
+ * @brief Heap bytes owned by an ownership storage, excluding `sizeof(Storage)`.
+ *
+ * The primary template counts nothing (e.g. `by_atomic` of a trivially
+ * copyable type).
+ */
+template <class Storage>
+struct storage_memory {
+    static constexpr std::size_t heap_bytes(const Storage&) noexcept { return 0; }
+};
+
+template <class T>
+struct storage_memory<by_value<T>> {
+    static std::size_t heap_bytes(const by_value<T>& s) noexcept {
+        return numsim::propex::heap_bytes(s.value);
+    }
+};
+
+/// Referenced values are owned elsewhere and are not counted.
+template <class T>
+struct storage_memory<by_reference<T>> {
+    static constexpr std::size_t heap_bytes(const by_reference<T>&) noexcept { return 0; }
+};
+
+/// The shared value and its control block, split evenly between all owners.
+template <class T>
+struct storage_memory<by_shared<T>> {
+    static std::size_t heap_bytes(const by_shared<T>& s) noexcept {
+        if (!s.ptr) return 0;
+        const std::size_t owned = sizeof(T) + numsim::propex::shared_control_block_bytes
+                                + numsim::propex::heap_bytes(*s.ptr);
+        return owned / static_cast<std::size_t>(s.ptr.use_count());
+    }
+};
+
+/// The published value and its control block, split evenly between all owners.
+template <class T>
+struct storage_memory<by_atomic_shared<T>> {
+    static std::size_t heap_bytes(const by_atomic_shared<T>& s) noexcept {
+        const auto p = s.get();
+        if (!p) return 0;
+        const std::size_t owned = sizeof(T) + numsim::propex::shared_control_block_bytes
+                                + numsim::propex::heap_bytes(*p);
+        // The snapshot taken here holds one extra reference. If a concurrent
+        // publish() dropped the stored one meanwhile, it is the only one left.
+        return owned / static_cast<std::size_t>(std::max<long>(1, p.use_count() - 1));
+    }
+};
+
+/// Every slot of the history ring.
+template <class T, std::size_t K>
+struct storage_memory<by_history<T, K>> {
+    static std::size_t heap_bytes(const by_history<T, K>& s) noexcept {
+        std::size_t bytes{0};
+        for (const auto& v : s.values) bytes += numsim::propex::heap_bytes(v);
+        return bytes;
+    }
+};
+
+/// Lazily constructed values own nothing until they are built.
+template <class T>
+struct storage_memory<by_lazy<T>> {
+    static std::size_t heap_bytes(const by_lazy<T>& s) noexcept {
+        return s.initialized() ? numsim::propex::heap_bytes(s.get()) : 0;
+    }
+};
+
+template <class T>
+struct storage_memory<by_spinlock<T>> {
+    static std::size_t heap_bytes(const by_spinlock<T>& s) noexcept {
+        return s.with_lock([](const T& v) { return numsim::propex::heap_bytes(v); });
+    }
+};
+
+/// @throws std::system_error if the shared lock cannot be taken.
+template <class T>
+struct storage_memory<by_rwlock<T>> {
+    static std::size_t heap_bytes(const by_rwlock<T>& s) {
+        return s.with_lock([](const T& v) { return numsim::propex::heap_bytes(v); });
+    }
+};
+
+} // namespace ownership
+
+#endif // PROPEX_MEMORY_H
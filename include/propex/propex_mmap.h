@@ -0,0 +1,270 @@
+/**
+ * @file propex_mmap.h
+ * @brief `by_mmap<T>`: array properties backed by a memory-mapped file.
+ *
+ * @details
+ * Precomputed kernels and lookup tables can be many gigabytes. Mapping them
+ * instead of reading them into the heap lets the kernel page them in on
+ * demand and drop clean pages under memory pressure, so they do not compete
+ * with the solver's working set.
+ *
+ * A node with the `by_mmap` policy stores an array of trivially copyable
+ * `T`. Reads hand out a `std::span<const T>` into the mapping (zero copy);
+ * writable mappings also expose `span()` for in-place updates.
+ *
+ * | `mmap_mode`      | Mapping        | Writes reach the file |
+ * |------------------|----------------|-----------------------|
+ * | `read_only`      | `MAP_SHARED`, read-only | —            |
+ * | `read_write`     | `MAP_SHARED`   | yes (`flush()` forces it, or `flush_on_close`) |
+ * | `copy_on_write`  | `MAP_PRIVATE`  | never                 |
+ *
+ * `mmap_advice` is passed to `madvise()` so the kernel can read ahead for
+ * sequential sweeps or avoid it for random lookups.
+ *
+ * @code
+ * node<double, ownership::by_mmap> kernel(ownership::mmap_file{
+ *     "kernel.bin", 0, ownership::mmap_mode::read_only, ownership::mmap_advice::random});
+ * property_view<double, node, ownership::by_mmap> k(&kernel);
+ * std::span<const double> values = k.get();   // no copy
+ * @endcode
+ *
+ * Only available on POSIX systems; elsewhere construction throws
+ * `std::system_error`.
+ */
+
+#ifndef PROPEX_MMAP_H
+#define PROPEX_MMAP_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "ownership_policies.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PROPEX_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ownership {
+
+/// How a `by_mmap` property maps its file.
+enum class mmap_mode {
+    read_only,      ///< Shared, read-only mapping of an existing file.
+    read_write,     ///< Shared, writable mapping; the file is created/extended to `count` elements.
+    copy_on_write,  ///< Private, writable mapping; modifications are never written back.
+};
+
+/// Access pattern hint passed to `madvise()`.
+enum class mmap_advice {
+    normal,      ///< Kernel default read-ahead.
+    sequential,  ///< Aggressive read-ahead, pages freed soon after use.
+    random,      ///< No read-ahead.
+    will_need,   ///< Start reading the whole mapping now.
+    huge_pages,  ///< Transparent huge pages (Linux, anonymous/tmpfs-backed only).
+};
+
+/// Describes the file behind a `by_mmap` property; passed to the node constructor.
+struct mmap_file {
+    std::filesystem::path path;
+    /// Number of elements; 0 derives it from the current file size.
+    std::size_t count{0};
+    mmap_mode mode{mmap_mode::read_only};
+    mmap_advice advice{mmap_advice::normal};
+    /// For `read_write`: `msync()` the mapping when the property is destroyed.
+    bool flush_on_close{false};
+};
+
+/**
+ * @brief Owns a memory mapping of a file holding an array of `T`.
+ *
+ * Move-only. `get()` returns a read-only span into the mapping, `span()` a
+ * writable one (throws for `read_only` mappings).
+ *
+ * @tparam T Trivially copyable element type.
+ *
+ * @throws std::system_error from the constructor if the file cannot be opened,
+ *         resized or mapped, and std::invalid_argument if its size is not a
+ *         multiple of `sizeof(T)`.
+ */
+template <class T>
+class by_mmap {
+    static_assert(std::is_trivially_copyable_v<T>, "by_mmap requires a trivially copyable element type");
+
+public:
+    explicit by_mmap(const mmap_file& file) : mode_(file.mode), flush_on_close_(file.flush_on_close) {
+#ifdef PROPEX_HAS_MMAP
+        const bool create = file.mode == mmap_mode::read_write;
+        const int fd = ::open(file.path.c_str(), create ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+        if (fd < 0) fail("open");
+
+        struct ::stat st{};
+        if (::fstat(fd, &st) != 0) fail("fstat", fd);
+        const auto file_bytes = static_cast<std::size_t>(st.st_size);
+
+        std::size_t count = file.count;
+        if (count == 0) {
+            if (file_bytes % sizeof(T) != 0) {
+                ::close(fd);
+                throw std::invalid_argument("by_mmap: file size is not a multiple of the element size");
+            }
+            count = file_bytes / sizeof(T);
+        }
+        bytes_ = count * sizeof(T);
+        if (create && file_bytes < bytes_ && ::ftruncate(fd, static_cast<::off_t>(bytes_)) != 0)
+            fail("ftruncate", fd);
+        if (!create && file_bytes < bytes_) {
+            ::close(fd);
+            throw std::invalid_argument("by_mmap: file is smaller than the requested element count");
+        }
+
+        if (bytes_ > 0) {
+            const int prot = file.mode == mmap_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            const int flags = file.mode == mmap_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+            void* p = ::mmap(nullptr, bytes_, prot, flags, fd, 0);
+            if (p == MAP_FAILED) fail("mmap", fd);
+            data_ = static_cast<T*>(p);
+            advise(file.advice);
+        }
+        // The mapping keeps the file referenced.
+        ::close(fd);
+        count_ = count;
+#else
+        (void)file;
+        throw std::system_error(std::make_error_code(std::errc::function_not_supported), "by_mmap");
+#endif
+    }
+
+    by_mmap(by_mmap&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), count_(std::exchange(other.count_, 0)),
+          bytes_(std::exchange(other.bytes_, 0)), mode_(other.mode_), flush_on_close_(other.flush_on_close_) {}
+
+    by_mmap& operator=(by_mmap&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            count_ = std::exchange(other.count_, 0);
+            bytes_ = std::exchange(other.bytes_, 0);
+            mode_ = other.mode_;
+            flush_on_close_ = other.flush_on_close_;
+        }
+        return *this;
+    }
+
+    by_mmap(const by_mmap&) = delete;
+    by_mmap& operator=(const by_mmap&) = delete;
+
+    ~by_mmap() { unmap(); }
+
+    /// Number of elements.
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+
+    /// Mapping mode.
+    [[nodiscard]] mmap_mode mode() const noexcept { return mode_; }
+
+    /// Read-only view of the mapped elements.
+    [[nodiscard]] std::span<const T> get() const noexcept { return {data_, count_}; }
+
+    /// Writable view of the mapped elements.
+    /// @throws std::logic_error for `read_only` mappings.
+    [[nodiscard]] std::span<T> span() const {
+        if (mode_ == mmap_mode::read_only) throw std::logic_error("by_mmap: mapping is read-only");
+        return {data_, count_};
+    }
+
+    /// Copies @p src (exactly `size()` elements) into the mapping.
+    /// @throws std::invalid_argument on a size mismatch, std::logic_error for `read_only` mappings.
+    void set(std::span<const T> src) const {
+        if (src.size() != count_) throw std::invalid_argument("by_mmap: size mismatch");
+        if (count_ != 0) std::memcpy(span().data(), src.data(), bytes_);
+    }
+
+    /// Passes @p advice for the whole mapping to `madvise()`; unsupported hints are ignored.
+    void advise(mmap_advice advice) const noexcept {
+#ifdef PROPEX_HAS_MMAP
+        if (!data_) return;
+        int hint = MADV_NORMAL;
+        switch (advice) {
+            case mmap_advice::normal:     hint = MADV_NORMAL; break;
+            case mmap_advice::sequential: hint = MADV_SEQUENTIAL; break;
+            case mmap_advice::random:     hint = MADV_RANDOM; break;
+            case mmap_advice::will_need:  hint = MADV_WILLNEED; break;
+            case mmap_advice::huge_pages:
+#ifdef MADV_HUGEPAGE
+                hint = MADV_HUGEPAGE;
+#endif
+                break;
+        }
+        ::madvise(static_cast<void*>(data_), bytes_, hint);
+#else
+        (void)advice;
+#endif
+    }
+
+    /// Writes modified pages of a `read_write` mapping to the file (`msync(MS_SYNC)`).
+    /// @throws std::system_error if `msync()` fails.
+    void flush() const {
+#ifdef PROPEX_HAS_MMAP
+        if (mode_ == mmap_mode::read_write && data_ && ::msync(static_cast<void*>(data_), bytes_, MS_SYNC) != 0)
+            throw std::system_error(errno, std::generic_category(), "by_mmap: msync");
+#endif
+    }
+
+private:
+#ifdef PROPEX_HAS_MMAP
+    [[noreturn]] static void fail(const char* what, int fd = -1) {
+        const int error = errno;
+        if (fd >= 0) ::close(fd);
+        throw std::system_error(error, std::generic_category(), std::string("by_mmap: ") + what);
+    }
+#endif
+
+    void unmap() noexcept {
+#ifdef PROPEX_HAS_MMAP
+        if (!data_) return;
+        if (flush_on_close_ && mode_ == mmap_mode::read_write)
+            ::msync(static_cast<void*>(data_), bytes_, MS_SYNC);
+        ::munmap(static_cast<void*>(data_), bytes_);
+        data_ = nullptr;
+#endif
+    }
+
+    T* data_{nullptr};
+    std::size_t count_{0};
+    std::size_t bytes_{0};
+    mmap_mode mode_;
+    bool flush_on_close_;
+};
+
+template<typename T>
+struct returns_reference<by_mmap<T>> : std::false_type{};
+
+/**
+ * @brief Specialized factory for `by_mmap<T>`.
+ */
+template<class T>
+struct make_storage<by_mmap<T>> {
+    static inline auto make(const mmap_file& file) {
+        return by_mmap<T>(file);
+    }
+};
+
+// by_mmap<T>
+template<class T>
+struct storage_traits<by_mmap<T>> {
+    static inline std::span<const T> get(const by_mmap<T>& s) noexcept { return s.get(); }
+    static inline void set(by_mmap<T>& s, std::span<const T> v) { s.set(v); }
+};
+
+} // namespace ownership
+
+#endif // PROPEX_MMAP_H
@@ -30,30 +30,196 @@
  */
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <typeindex>
 #include <typeinfo>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include "ownership_policies.h"
+#include "propex_field.h"
+#include "propex_memory.h"
 
 namespace numsim::propex {
 
+class node_base;
+
+/**
+ * @brief Registered with `node_base::subscribe()` and woken once by the node's next change.
+ * @see propex_async.h for the coroutine awaitables built on it.
+ */
+class change_waiter {
+public:
+    /**
+     * @brief Called after the node changed, outside any lock.
+     * @param destroyed `true` if the node is being destroyed rather than changed.
+     */
+    virtual void wake(bool destroyed) noexcept = 0;
+
+    /**
+     * @brief Called when the node is moved to @p node (`registry::compact()`), under the waiter table's lock.
+     *
+     * Waiters that keep a pointer to the node repoint it here. @p node is
+     * still being constructed: only its address may be stored.
+     */
+    virtual void rebind(node_base& /*node*/) noexcept {}
+
+protected:
+    ~change_waiter() = default;
+};
+
+namespace detail {
+
+/// Waiters of all nodes, keyed by node address. Nodes without waiters have no entry.
+struct change_waiters {
+    std::mutex mutex;
+    std::unordered_map<const void*, std::vector<change_waiter*>> waiting;
+
+    static change_waiters& instance() {
+        static change_waiters table;
+        return table;
+    }
+
+    /// Removes @p w if it is still registered for @p node.
+    void remove(const void* node, change_waiter& w) noexcept {
+        const std::lock_guard lock(mutex);
+        const auto it = waiting.find(node);
+        if (it == waiting.end()) return;
+        std::erase(it->second, &w);
+        if (it->second.empty()) waiting.erase(it);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Untyped element access to a node's value (`node_base::elements()`).
+ *
+ * Provided for arithmetic values, which have one element, and for fields
+ * (propex_field.h), whatever the policy. One static table exists per node
+ * type. Elements are passed as untyped memory holding `*element` objects.
+ * Formulas (propex_formula.h) are built on it.
+ */
+struct element_ops {
+    const std::type_info* element;  ///< Element type (the value type for arithmetic values).
+    bool field;                     ///< `false` for arithmetic values.
+
+    /// Number of elements.
+    std::size_t (*size)(const node_base& node);
+
+    /**
+     * @brief The elements in place, `nullptr` if the policy only hands out copies or the read failed.
+     *
+     * Valid until the value is resized, replaced, or the node is compressed or relocated.
+     */
+    const void* (*data)(const node_base& node) noexcept;
+
+    /// Copies @p count elements, starting at @p first, into @p out. @throws std::out_of_range
+    void (*load)(const node_base& node, std::size_t first, void* out, std::size_t count);
+
+    /**
+     * @brief Writes @p count elements from @p in, starting at element @p first; `nullptr` for read-only values.
+     *
+     * Does not publish the change, so a value written in several ranges is
+     * not seen half-written by waiters: call `mark_changed()` once it is complete.
+     * @throws std::out_of_range
+     */
+    void (*store)(node_base& node, std::size_t first, const void* in, std::size_t count);
+};
+
 /**
  * @class node_base
  * @brief Abstract base for all property nodes (type erasure anchor).
  *
- * Provides a virtual destructor and a runtime query of the underlying
- * stored *value type* via @ref underlying_type().
+ * Lets heterogeneous containers (e.g. a registry) hold nodes of different
+ * `T` and ownership policy. Besides the virtual destructor it provides:
  *
- * This enables heterogeneous containers (e.g., a registry) to hold nodes
- * of different `T` while still allowing RTTI-based inspection.
+ *  - `underlying_type()` — the stored value type, for RTTI-based inspection;
+ *  - versioning — `version()` counts the changes published with
+ *    `mark_changed()`, and `subscribe()` registers `change_waiter`s that the
+ *    next change wakes (propex_async.h). Waiters live in one global table,
+ *    so a node without waiters costs a single atomic counter;
+ *  - relocation — `relocate_to()` moves the concrete node into new memory
+ *    for `registry::compact()`, taking its version and waiters along;
+ *  - `object_bytes()`, `object_alignment()` and `payload_bytes()` for
+ *    `registry::memory_usage()`;
+ *  - `advance()`, which rotates history policies (`registry::advance()`);
+ *  - `elements()` — untyped element access to arithmetic and field values,
+ *    on which formulas (propex_formula.h) are built.
  */
 class node_base {
 public:
     /// Defaulted constructor.
     node_base() = default;
 
-    /// Virtual destructor to allow polymorphic deletion.
-    virtual ~node_base() = default;
+    /// Copies keep the version but not the waiters.
+    node_base(const node_base& other) noexcept
+        : version_(other.version_.load(std::memory_order_acquire) & ~waiting_bit) {}
+
+    /// Moves take the version and the waiters along (see `take_changes_from()`).
+    node_base(node_base&& other) noexcept { take_changes_from(other); }
+
+    /// Whole nodes are not assigned; values change through the concrete node's setters.
+    node_base& operator=(const node_base&) = delete;
+
+    /// Virtual destructor to allow polymorphic deletion. Pending waiters are woken with `destroyed == true`.
+    virtual ~node_base() {
+        if (version_.load(std::memory_order_acquire) & waiting_bit) release_waiters(true);
+    }
+
+    /**
+     * @brief Number of changes published so far (`set()`, `set_from()`, `store()`, `mark_changed()`).
+     * @see propex_async.h
+     */
+    [[nodiscard]] std::uint64_t version() const noexcept {
+        return version_.load(std::memory_order_acquire) >> 1;
+    }
+
+    /**
+     * @brief Publishes a change: increments `version()` and wakes the waiters.
+     *
+     * Call it after writing through `span()`, `operator[]` or a reference
+     * obtained otherwise; the setters of `node` publish for you. Without
+     * waiters this is a single atomic increment. It is atomic for every
+     * policy, so a `subscribe()` racing with it cannot lose its waiter.
+     */
+    void mark_changed() noexcept {
+        if (version_.fetch_add(2, std::memory_order_acq_rel) & waiting_bit) release_waiters(false);
+    }
+
+    /**
+     * @brief Registers @p w to be woken by the next change after version @p seen.
+     * @return `false` (and @p w is not registered) if the version already differs from @p seen.
+     *
+     * @p w must stay alive until it is woken or removed with `unsubscribe()`.
+     */
+    bool subscribe(change_waiter& w, std::uint64_t seen) const {
+        auto& table = detail::change_waiters::instance();
+        const std::lock_guard lock(table.mutex);
+        if ((version_.fetch_or(waiting_bit, std::memory_order_acq_rel) >> 1) != seen) return false;
+        table.waiting[this].push_back(&w);
+        return true;
+    }
+
+    /// Removes @p w if it was not woken yet.
+    void unsubscribe(change_waiter& w) const noexcept { detail::change_waiters::instance().remove(this, w); }
+
+    /// Number of registered waiters (takes the waiter table's lock).
+    [[nodiscard]] std::size_t waiters() const {
+        auto& table = detail::change_waiters::instance();
+        const std::lock_guard lock(table.mutex);
+        const auto it = table.waiting.find(this);
+        return it == table.waiting.end() ? 0 : it->second.size();
+    }
 
     /**
      * @brief Returns the `std::type_index` of the underlying stored value type `T`.
@@ -61,9 +227,110 @@ public:
      * @return The type index of the `T` used by the concrete node.
      */
     [[nodiscard]] virtual std::type_index underlying_type() const noexcept = 0;
+
+    /**
+     * @brief Returns the size of the concrete node object (`sizeof` the most derived type).
+     */
+    [[nodiscard]] virtual std::size_t object_bytes() const noexcept { return sizeof(node_base); }
+
+    /**
+     * @brief Returns the heap memory owned by the stored value.
+     *
+     * Values held by reference are not owned and report zero.
+     * @throws std::system_error if a `by_rwlock` value cannot be locked for reading.
+     */
+    [[nodiscard]] virtual std::size_t payload_bytes() const { return 0; }
+
+    /**
+     * @brief Returns the alignment of the concrete node object.
+     */
+    [[nodiscard]] virtual std::size_t object_alignment() const noexcept { return alignof(node_base); }
+
+    /**
+     * @brief Moves the concrete node into @p storage and returns the new object.
+     *
+     * @p storage must provide `object_bytes()` bytes aligned to
+     * `object_alignment()`. The original is left in a moved-from state and must
+     * still be destroyed by its owner.
+     *
+     * @return The relocated node, or `nullptr` if the node cannot be moved
+     *         without the risk of throwing (the original is then untouched).
+     * @see node_relocator, registry::compact()
+     */
+    [[nodiscard]] virtual node_base* relocate_to(void* /*storage*/) noexcept { return nullptr; }
+
+    /**
+     * @brief Starts a new time step for history-keeping nodes.
+     * @return `true` if the node keeps a history and was rotated.
+     * @see ownership::by_history, registry::advance()
+     */
+    virtual bool advance() noexcept { return false; }
+
+    /**
+     * @brief Element-wise access to the value for code that handles nodes of any type.
+     * @return The operations for arithmetic values and fields, `nullptr` for other values.
+     * @see element_ops
+     */
+    [[nodiscard]] virtual const element_ops* elements() const noexcept { return nullptr; }
+
+protected:
+    /**
+     * @brief Takes over the version and the waiters of @p other, which is about to be destroyed.
+     *
+     * Used when a node is relocated (`registry::compact()`), whether it is
+     * moved or re-created from its value, so pending awaitables follow it
+     * (see `change_waiter::rebind()`). Must not race with changes of @p other.
+     */
+    void take_changes_from(node_base& other) noexcept {
+        version_.store(other.version_.load(std::memory_order_acquire) & ~waiting_bit, std::memory_order_relaxed);
+        if (!(other.version_.load(std::memory_order_acquire) & waiting_bit)) return;
+        auto& table = detail::change_waiters::instance();
+        const std::lock_guard lock(table.mutex);
+        other.version_.fetch_and(~waiting_bit, std::memory_order_acq_rel);
+        if (auto entry = table.waiting.extract(&other)) {
+            entry.key() = this;
+            for (change_waiter* w : entry.mapped()) w->rebind(*this);
+            table.waiting.insert(std::move(entry));
+            version_.fetch_or(waiting_bit, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    /// Set in `version_` while the node has entries in the waiter table.
+    static constexpr std::uint64_t waiting_bit = 1;
+
+    // Out of line: keeps the setters' fast path (no waiters) small.
+    [[gnu::noinline]] void release_waiters(bool destroyed) noexcept {
+        std::vector<change_waiter*> woken;
+        {
+            auto& table = detail::change_waiters::instance();
+            const std::lock_guard lock(table.mutex);
+            if (const auto it = table.waiting.find(this); it != table.waiting.end()) {
+                woken.swap(it->second);
+                table.waiting.erase(it);
+            }
+            version_.fetch_and(~waiting_bit, std::memory_order_acq_rel);
+        }
+        for (change_waiter* w : woken) w->wake(destroyed);
+    }
+
+    /// Change count shifted left by one; bit 0 is `waiting_bit`.
+    mutable std::atomic<std::uint64_t> version_{0};
 };
 
 
+/**
+ * @brief Additional base class of `node<T, Ownership>` for the policy @p Policy; empty by default.
+ *
+ * A header defining a policy may specialize it next to the policy to give
+ * those nodes an interface of their own, instead of adding virtuals to
+ * `node_base` (e.g. `compressible_node` for `ownership::by_compressed`, see
+ * propex_cold.h). @p Node is the concrete node, which grants the
+ * specialization access to its storage (`storage_`).
+ */
+template <class Policy, class Node>
+struct node_policy_base {};
+
 /**
  * @class node
  * @brief Concrete property node storing a `T` with an ownership policy.
@@ -93,7 +360,9 @@ public:
  * @endcode
  */
 template <class T, template <class> class Ownership = ownership::by_value>
-class node final : public node_base {
+class node final : public node_base, public node_policy_base<Ownership<T>, node<T, Ownership>> {
+    friend struct node_policy_base<Ownership<T>, node>;
+
 public:
     /// Helper alias to construct the policy storage.
     using make_storage   = ownership::make_storage<Ownership<T>>;
@@ -101,20 +370,23 @@ public:
     using storage_traits = ownership::storage_traits<Ownership<T>>;
     /// Whether this policy returns `const T&` (`true`) or `T` by value (`false`).
     static constexpr inline auto returns_reference_v = ownership::returns_reference_v<Ownership<T>>;
+    /// Whether `T` is a field whose storage can hand out a stable span (see propex_field.h).
+    static constexpr inline bool stable_field_v = contiguous_field<T>
+        && requires(Ownership<T>& s) { { storage_traits::get_mutable(s) } -> std::same_as<T&>; };
 
     /// Deleted default constructor (node must be initialized with a value/reference).
     node() = delete;
 
     /**
-     * @brief Constructs the node from a const lvalue (value-like policies).
-     * @param v Initial value.
+     * @brief Constructs the node from any argument accepted by the policy's factory.
+     * @param v Initial value, or e.g. a `std::shared_ptr<T>` for `by_shared`.
      *
-     * Uses `make_storage::make(v)` so policies can customize construction
-     * (e.g. `by_shared` will create a `std::shared_ptr<T>`).
+     * Forwards @p v to `make_storage::make`, so rvalues are moved through.
      */
     template<typename V>
-    explicit node(const V& v)
-        : storage_(make_storage::make(v)) {}
+        requires (!std::is_same_v<std::remove_cvref_t<V>, node>)
+    explicit node(V&& v)
+        : storage_(make_storage::make(std::forward<V>(v))) {}
 
     /**
      * @brief Constructs the node from a const lvalue (value-like policies).
@@ -136,6 +408,13 @@ public:
     explicit node(T& v)
         : storage_(make_storage::make(v)) {}
 
+    /**
+     * @brief Constructs the node from an rvalue (value-like policies).
+     * @param v Initial value, moved into the storage (for `by_shared`, into the shared object).
+     */
+    explicit node(T&& v)
+        : storage_(make_storage::make(std::move(v))) {}
+
     /**
      * @brief Returns the `std::type_index` of the underlying stored type `T`.
      */
@@ -143,14 +422,61 @@ public:
         return type_index;
     }
 
+    /**
+     * @brief Returns `sizeof(node)`, which includes values stored inline.
+     */
+    [[nodiscard]] std::size_t object_bytes() const noexcept override {
+        return sizeof(node);
+    }
+
+    /**
+     * @brief Returns the heap memory owned by the policy storage.
+     * @see ownership::storage_memory
+     */
+    [[nodiscard]] std::size_t payload_bytes() const override {
+        return ownership::storage_memory<Ownership<T>>::heap_bytes(storage_);
+    }
+
+    /**
+     * @brief Returns `alignof(node)`.
+     */
+    [[nodiscard]] std::size_t object_alignment() const noexcept override {
+        return alignof(node);
+    }
+
+    /**
+     * @brief Move-constructs this node into @p storage.
+     *
+     * Policies whose storage is not movable (`by_atomic`, `by_spinlock`, ...)
+     * are re-created from the current value; the new node then takes over
+     * the version and the waiters like a moved one.
+     */
+    [[nodiscard]] node_base* relocate_to(void* storage) noexcept override {
+        if constexpr (std::is_nothrow_move_constructible_v<Ownership<T>>) {
+            return ::new (storage) node(std::move(*this));
+        } else if constexpr (!returns_reference_v
+                             && std::is_nothrow_copy_constructible_v<decltype(storage_traits::get(storage_))>) {
+            try {
+                node* relocated = ::new (storage) node(get());
+                relocated->take_changes_from(*this);
+                return relocated;
+            } catch (...) {
+                return nullptr;  // the read failed (e.g. locking by_rwlock); the original is untouched
+            }
+        } else {
+            return nullptr;
+        }
+    }
+
     /**
      * @brief Read access — reference-returning policies.
      * @return `const T&`
      *
      * Only available when `returns_reference_v == true`. The reference remains
      * valid as long as the node and, for `by_reference`, the referred object live.
+     * `noexcept` unless the policy's read can throw (e.g. the factory of `by_lazy`).
      */
-    [[nodiscard]] constexpr inline auto& get() const noexcept
+    [[nodiscard]] constexpr inline auto& get() const noexcept(noexcept(storage_traits::get(storage_)))
         requires (returns_reference_v)
     {
         return storage_traits::get(storage_);
@@ -160,14 +486,148 @@ public:
      * @brief Read access — value-returning policies (e.g., atomic).
      * @return `T` by value (e.g., atomic load)
      *
-     * Only available when `returns_reference_v == false`.
+     * Only available when `returns_reference_v == false`. `noexcept` unless
+     * the policy's read can throw (e.g. copying under `by_spinlock`).
      */
-    [[nodiscard]] constexpr inline auto get() noexcept
+    [[nodiscard]] constexpr inline auto get() noexcept(noexcept(storage_traits::get(storage_)))
         requires (!returns_reference_v)
     {
         return storage_traits::get(storage_);
     }
 
+    /**
+     * @brief Read access to the value @p lag steps back — history policies only.
+     * @throws std::out_of_range if @p lag exceeds the history depth.
+     */
+    [[nodiscard]] constexpr inline const T& get(std::size_t lag) const
+        requires requires(const Ownership<T>& s) { s.get(lag); }
+    {
+        return storage_.get(lag);
+    }
+
+    /**
+     * @brief Rotates the history of history policies (O(1)); a no-op otherwise.
+     */
+    bool advance() noexcept override {
+        if constexpr (requires { storage_.advance(); }) {
+            storage_.advance();
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * @brief Runs @p fn on the value under the policy's lock — locking policies only.
+     * @return Whatever @p fn returns.
+     *
+     * Counts as a change (`mark_changed()`); use the const overload to only read.
+     */
+    template<class F>
+    decltype(auto) with_lock(F&& fn)
+        requires requires(Ownership<T>& s) { s.with_lock(std::forward<F>(fn)); }
+    {
+        // Counts as a change once the lock is released (also if fn throws, it may have written).
+        struct publish {
+            node* self;
+            ~publish() { self->mark_changed(); }
+        } on_exit{this};
+        return storage_.with_lock(std::forward<F>(fn));
+    }
+
+    /// @copydoc with_lock
+    template<class F>
+    decltype(auto) with_lock(F&& fn) const
+        requires requires(const Ownership<T>& s) { s.with_lock(std::forward<F>(fn)); }
+    {
+        return storage_.with_lock(std::forward<F>(fn));
+    }
+
+    /**
+     * @brief Writable span into the stored array — array policies (`by_mmap`) only.
+     */
+    [[nodiscard]] auto span() const
+        requires requires(const Ownership<T>& s) { s.span(); }
+    {
+        return storage_.span();
+    }
+
+    /// @copydoc node_base::elements
+    [[nodiscard]] const element_ops* elements() const noexcept override {
+        if constexpr (element_shape == shape::none)
+            return nullptr;
+        else
+            return &element_table;
+    }
+
+    /**
+     * @brief Writable span over the elements of a field — policies with stable storage only.
+     *
+     * Valid until the container is resized or replaced.
+     */
+    [[nodiscard]] auto span()
+        requires (stable_field_v)
+    {
+        return std::span(storage_traits::get_mutable(storage_));
+    }
+
+    /// Read-only span over the elements of a field — policies with stable storage only.
+    [[nodiscard]] auto span() const
+        requires (stable_field_v)
+    {
+        return std::span(storage_traits::get(storage_));
+    }
+
+    /**
+     * @brief Copies `out.size()` elements of a field, starting at @p first, into @p out.
+     *
+     * Stable storage is read in place; other policies copy the range under
+     * their own synchronization (`storage_traits::load`).
+     * @throws std::out_of_range if the range exceeds the stored size.
+     */
+    template<class U = T>
+        requires contiguous_field<U>
+                 && (stable_field_v
+                     || requires(const Ownership<U>& s, std::span<field_element_t<U>> o) {
+                            storage_traits::load(s, std::size_t{}, o);
+                        })
+    void load(std::size_t first, std::span<field_element_t<U>> out) const {
+        if constexpr (stable_field_v)
+            detail::copy_range_out(storage_traits::get(storage_), first, out);
+        else
+            storage_traits::load(storage_, first, out);
+    }
+
+    /**
+     * @brief Copies @p in into a field, starting at element @p first.
+     *
+     * Atomic policies use a compare-and-swap loop, locking policies hold
+     * their exclusive lock.
+     * @throws std::out_of_range if the range exceeds the stored size.
+     */
+    template<class U = T>
+        requires contiguous_field<U>
+                 && (stable_field_v
+                     || requires(Ownership<U>& s, std::span<const field_element_t<U>> i) {
+                            storage_traits::store(s, std::size_t{}, i);
+                        })
+    void store(std::size_t first, std::span<const field_element_t<U>> in) {
+        if constexpr (stable_field_v)
+            detail::copy_range_in(storage_traits::get_mutable(storage_), first, in);
+        else
+            storage_traits::store(storage_, first, in);
+        publish();
+    }
+
+    /**
+     * @brief Writes pending modifications to the backing file — `by_mmap` only.
+     */
+    void flush() const
+        requires requires(const Ownership<T>& s) { s.flush(); }
+    {
+        storage_.flush();
+    }
+
     /**
      * @brief Write access — forwards to the policy’s setter.
      * @tparam U Value-compatible type.
@@ -175,13 +635,153 @@ public:
      *
      * - For `by_value`/`by_shared`/`by_reference`, this typically writes through.
      * - For `by_atomic`, this performs an atomic store.
+     *
+     * `noexcept` unless the policy's write can throw; then the error (e.g. a
+     * size mismatch for `by_mmap`) propagates and no change is published.
      */
     template<class U>
-    constexpr inline void set(U&& v) noexcept {
+    constexpr inline void set(U&& v) noexcept(noexcept(storage_traits::set(storage_, std::forward<U>(v)))) {
         storage_traits::set(storage_, std::forward<U>(v));
+        publish();
+    }
+
+    /**
+     * @brief Rebuilds the value in place: calls `fn(T&)` on the stored value.
+     *
+     * Unlike `set(make_value())`, the existing value and its capacity are
+     * reused, so a `std::vector` that keeps its size is refilled without
+     * allocating. Locking policies run @p fn under their (exclusive) lock.
+     * Not available for policies that cannot be written in place
+     * (`by_atomic`, `by_atomic_ref`, `by_atomic_shared`, `by_mmap`).
+     */
+    template<class F>
+    void set_from(F&& fn)
+        requires requires(Ownership<T>& s) { storage_traits::set_from(s, std::forward<F>(fn)); }
+    {
+        storage_traits::set_from(storage_, std::forward<F>(fn));
+        publish();
     }
 
 private:
+    /// Publishes a write (`mark_changed()`).
+    void publish() noexcept { mark_changed(); }
+
+    /// What `get()` hands out, with snapshot pointers (`by_atomic_shared`) dereferenced.
+    template<class V>
+    struct pointee { using type = V; };
+    template<class V>
+    struct pointee<std::shared_ptr<const V>> { using type = V; };
+    using value_type_seen = typename pointee<std::remove_cvref_t<decltype(storage_traits::get(
+        std::declval<const Ownership<T>&>()))>>::type;
+
+    enum class shape { none, scalar, field };
+
+    static constexpr shape value_shape() {
+        if constexpr (std::is_arithmetic_v<value_type_seen>) return shape::scalar;
+        else if constexpr (contiguous_field<value_type_seen>) return shape::field;
+        else return shape::none;
+    }
+    static constexpr shape element_shape = value_shape();
+
+    template<class V>
+    struct element_of { using type = V; };
+    template<contiguous_field V>
+    struct element_of<V> { using type = field_element_t<V>; };
+    using element_type = typename element_of<value_type_seen>::type;
+
+    // ---- element_ops of this node type ----------------------------------------------------------
+
+    static std::size_t element_count(const node_base& b) {
+        if constexpr (element_shape == shape::scalar)
+            return 1;
+        else
+            return static_cast<const node&>(b).visit_value([](const auto& v) -> std::size_t { return std::ranges::size(v); });
+    }
+
+    static const void* element_data(const node_base& b) noexcept {
+        const node& n = static_cast<const node&>(b);
+        if constexpr (noexcept(storage_traits::get(n.storage_))) {
+            return n.data_in_place();
+        } else {
+            // Reads that may throw (by_lazy, by_compressed): report "not in place" and let
+            // element_load() raise the error.
+            try {
+                return n.data_in_place();
+            } catch (...) {
+                return nullptr;
+            }
+        }
+    }
+
+    static void element_load(const node_base& b, std::size_t first, void* out, std::size_t count) {
+        const node& n = static_cast<const node&>(b);
+        const std::span o(static_cast<element_type*>(out), count);
+        if constexpr (element_shape == shape::scalar) {
+            detail::check_field_range(1, first, count);
+            if (count) o[0] = n.visit_value([](const auto& v) -> element_type { return v; });
+        } else {
+            n.visit_value([&](const auto& v) { detail::copy_range_out(v, first, o); });
+        }
+    }
+
+    static void element_store(node_base& b, std::size_t first, const void* in, std::size_t count) {
+        node& n = static_cast<node&>(b);
+        const std::span i(static_cast<const element_type*>(in), count);
+        if constexpr (element_shape == shape::scalar) {
+            detail::check_field_range(1, first, count);
+            if (count) storage_traits::set(n.storage_, i[0]);
+        } else if constexpr (stable_field_v) {
+            detail::copy_range_in(storage_traits::get_mutable(n.storage_), first, i);
+        } else if constexpr (requires { storage_traits::store(n.storage_, first, i); }) {
+            storage_traits::store(n.storage_, first, i);
+        } else {
+            auto s = n.storage_.span();
+            detail::copy_range_in(s, first, i);
+        }
+    }
+
+    static constexpr bool element_writable() {
+        using in_type = std::span<const element_type>;
+        if constexpr (element_shape == shape::scalar)
+            return requires(Ownership<T>& s, element_type v) { storage_traits::set(s, v); };
+        else
+            return stable_field_v
+                   || requires(Ownership<T>& s, in_type i) { storage_traits::store(s, std::size_t{}, i); }
+                   || requires(const Ownership<T>& s) { s.span(); };
+    }
+
+    static constexpr auto element_store_or_null() {
+        if constexpr (element_writable()) return &element_store;
+        else return static_cast<decltype(&element_store)>(nullptr);
+    }
+
+    static inline const element_ops element_table{
+        &typeid(element_type), element_shape == shape::field, &element_count, &element_data, &element_load,
+        element_store_or_null()};
+
+    const void* data_in_place() const {
+        using get_type = decltype(storage_traits::get(storage_));
+        if constexpr (std::is_lvalue_reference_v<get_type> && element_shape == shape::scalar)
+            return &storage_traits::get(storage_);
+        else if constexpr (std::is_lvalue_reference_v<get_type>
+                           || std::is_same_v<get_type, std::span<const element_type>>)
+            return std::ranges::data(storage_traits::get(storage_));  // in place, or a mapping
+        else
+            return nullptr;
+    }
+
+    /// Calls @p fn with the value without copying it where the policy allows (under the lock for locking policies).
+    template<class F>
+    decltype(auto) visit_value(F&& fn) const {
+        if constexpr (requires { storage_.with_lock(fn); })
+            return storage_.with_lock(std::forward<F>(fn));
+        else if constexpr (!std::is_same_v<value_type_seen,
+                                           std::remove_cvref_t<decltype(storage_traits::get(storage_))>>)
+            return std::forward<F>(fn)(*storage_traits::get(storage_));
+        else
+            return std::forward<F>(fn)(storage_traits::get(storage_));
+    }
+
     /// Policy storage for the value (e.g., raw `T`, `T*`, `std::shared_ptr<T>`, or `std::atomic<T>`).
     Ownership<T> storage_;
 
@@ -189,4 +789,52 @@ private:
     static inline std::type_index type_index{typeid(T)};
 };
 
+/**
+ * @brief Moves the node owned by a smart pointer into freshly allocated memory.
+ *
+ * Used by `registry::compact()` to place nodes next to each other. The
+ * primary template refuses relocation: with shared ownership other owners
+ * would keep pointing at the old object. Specializations provide
+ *
+ *  - `static constexpr bool supported`,
+ *  - `static bool relocate(Ptr& p)` — replaces the pointee with a relocated
+ *    copy, returns `false` (leaving @p p untouched) if the node cannot be
+ *    moved. May throw `std::bad_alloc`, in which case @p p is unchanged.
+ *
+ * `propex_pmr.h` adds a specialization that allocates from the node's memory
+ * resource.
+ */
+template <class Ptr>
+struct node_relocator {
+    static constexpr bool supported = false;
+    static constexpr bool relocate(Ptr&) noexcept { return false; }
+};
+
+/// Relocation for exclusively owned nodes allocated with `new`.
+template <class T>
+struct node_relocator<std::unique_ptr<T>> {
+    static constexpr bool supported = true;
+
+    static bool relocate(std::unique_ptr<T>& p) {
+        if (!p) return false;
+        if constexpr (std::is_base_of_v<node_base, T>) {
+            node_base& old = *p;
+            if (old.object_alignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return false;
+            void* storage = ::operator new(old.object_bytes());
+            node_base* moved = old.relocate_to(storage);
+            if (!moved) {
+                ::operator delete(storage);
+                return false;
+            }
+            p.reset(static_cast<T*>(moved));
+            return true;
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> && !std::is_polymorphic_v<T>) {
+            p.reset(new T(std::move(*p)));
+            return true;
+        } else {
+            return false;
+        }
+    }
+};
+
 } // namespace numsim::propex
@@ -0,0 +1,188 @@
+/**
+ * @file propex_pmr.h
+ * @brief `std::pmr` building blocks for placing a whole registry in one memory resource.
+ *
+ * @details
+ * A registry becomes allocator-aware end to end when
+ *
+ *  - its map is a `std::pmr` map (buckets and element nodes),
+ *  - its keys are `std::pmr::string` (built with the map's allocator by
+ *    `registry::add()` and `key_traits::merge(std::allocator_arg, ...)`), and
+ *  - its nodes are created with `pmr::make_unique()`, whose deleter returns
+ *    the memory to the resource the node came from.
+ *
+ * Both map aliases hash and compare string keys transparently, so
+ * `reg.find("E")` or a lookup with a `std::string_view` does not build a
+ * temporary `std::pmr::string` on the default resource.
+ *
+ * `pmr::registry<Node>` bundles these choices. Combined with a
+ * `std::pmr::monotonic_buffer_resource`, all allocations of a simulation phase
+ * come from one arena: destroying the registry only runs destructors (the
+ * arena ignores individual deallocations), and `release()` on the arena then
+ * returns the memory in one step.
+ *
+ * ### Example
+ * @code
+ * std::pmr::monotonic_buffer_resource arena(1 << 20);
+ * {
+ *     pmr::registry<node_base> reg(&arena);
+ *     reg.add(pmr::make_unique<node<double>>(&arena, 1.0), "mat", "E");
+ *     run_phase(reg);
+ * }
+ * arena.release();
+ * @endcode
+ */
+
+#ifndef PROPEX_PMR_H
+#define PROPEX_PMR_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include "key_traits.h"
+#include "propex_registry.h"
+
+namespace numsim::propex::pmr {
+
+/**
+ * @brief Deleter that destroys an object and returns its storage to a memory resource.
+ *
+ * The allocation size and alignment of the most derived type are captured at
+ * creation, so a `unique_ptr<node_base, node_deleter>` can release a
+ * `node<T, ...>` correctly.
+ */
+struct node_deleter {
+    std::pmr::memory_resource* resource{};
+    std::size_t bytes{};
+    std::size_t alignment{};
+
+    template <class T>
+    void operator()(T* p) const noexcept {
+        if (!p) return;
+        // Deallocate the most-derived object, whose address may differ from p.
+        void* storage = dynamic_cast_to_storage(p);
+        std::destroy_at(p);
+        resource->deallocate(storage, bytes, alignment);
+    }
+
+private:
+    template <class T>
+    static void* dynamic_cast_to_storage(T* p) noexcept {
+        if constexpr (std::is_polymorphic_v<T>) return dynamic_cast<void*>(p);
+        else return static_cast<void*>(p);
+    }
+};
+
+/// Node pointer for `registry`'s `NodePtr` parameter.
+template <class T>
+using unique_ptr = std::unique_ptr<T, node_deleter>;
+
+/**
+ * @brief Allocates and constructs a `T` from @p resource.
+ * @throws Whatever the resource or the constructor of `T` throws; no memory is leaked.
+ */
+template <class T, class... Args>
+[[nodiscard]] unique_ptr<T> make_unique(std::pmr::memory_resource* resource, Args&&... args) {
+    void* storage = resource->allocate(sizeof(T), alignof(T));
+    try {
+        T* p = ::new (storage) T(std::forward<Args>(args)...);
+        return unique_ptr<T>(p, node_deleter{resource, sizeof(T), alignof(T)});
+    } catch (...) {
+        resource->deallocate(storage, sizeof(T), alignof(T));
+        throw;
+    }
+}
+
+} // namespace numsim::propex::pmr
+
+namespace numsim::propex {
+
+/// Relocation of `pmr::make_unique` nodes within their memory resource (see `registry::compact()`).
+template <class T>
+struct node_relocator<pmr::unique_ptr<T>> {
+    static constexpr bool supported = std::is_base_of_v<node_base, T>;
+
+    static bool relocate(pmr::unique_ptr<T>& p) {
+        if constexpr (supported) {
+            if (!p) return false;
+            node_base& old = *p;
+            const auto deleter = p.get_deleter();
+            void* storage = deleter.resource->allocate(deleter.bytes, deleter.alignment);
+            node_base* moved = old.relocate_to(storage);
+            if (!moved) {
+                deleter.resource->deallocate(storage, deleter.bytes, deleter.alignment);
+                return false;
+            }
+            p = pmr::unique_ptr<T>(static_cast<T*>(moved), deleter);
+            return true;
+        } else {
+            return false;
+        }
+    }
+};
+
+} // namespace numsim::propex
+
+namespace numsim::propex::pmr {
+
+/// Transparent hash of string-like keys: `find("E")` needs no temporary `std::pmr::string`.
+struct string_hash {
+    using is_transparent = void;
+    [[nodiscard]] std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+/// Transparent equality of string-like keys, companion of `string_hash`.
+struct string_equal {
+    using is_transparent = void;
+    [[nodiscard]] bool operator()(std::string_view a, std::string_view b) const noexcept { return a == b; }
+};
+
+/// Transparent ordering of string-like keys.
+struct string_less {
+    using is_transparent = void;
+    [[nodiscard]] bool operator()(std::string_view a, std::string_view b) const noexcept { return a < b; }
+};
+
+namespace detail {
+template <class K>
+inline constexpr bool string_like = std::is_convertible_v<const K&, std::string_view>;
+} // namespace detail
+
+/// Hashed `std::pmr` map usable as `registry`'s `Map` parameter; transparent for string keys.
+template <class K, class V>
+using unordered_map = std::pmr::unordered_map<K, V,
+    std::conditional_t<detail::string_like<K>, string_hash, std::hash<K>>,
+    std::conditional_t<detail::string_like<K>, string_equal, std::equal_to<K>>>;
+
+/// Ordered `std::pmr` map usable as `registry`'s `Map` parameter; transparent for string keys.
+template <class K, class V>
+using map = std::pmr::map<K, V, std::conditional_t<detail::string_like<K>, string_less, std::less<K>>>;
+
+/**
+ * @brief Registry whose index, keys and nodes all come from one memory resource.
+ *
+ * Construct it with the resource (implicitly converted to the allocator):
+ * `pmr::registry<node_base> reg(&arena);`
+ */
+template <class NodeType,
+          template<class...> class Map = unordered_map,
+          template<class> class KeyTraits = key_traits>
+using registry = propex::registry<std::pmr::string, NodeType, unique_ptr, Map, KeyTraits>;
+
+/// @return The memory resource backing @p reg.
+template <class Registry>
+[[nodiscard]] std::pmr::memory_resource* resource_of(const Registry& reg) noexcept {
+    return reg.get_allocator().resource();
+}
+
+} // namespace numsim::propex::pmr
+
+#endif // PROPEX_PMR_H
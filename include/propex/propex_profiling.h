@@ -0,0 +1,247 @@
+/**
+ * @file propex_profiling.h
+ * @brief Opt-in per-node access profiling for registries and property views.
+ *
+ * @details
+ * When compiled with `PROPEX_ENABLE_PROFILING`, `registry::find()`/`at()` (on a hit),
+ * `property_view::get()` and `property_view::set()` record one access per call
+ * against the address of the node involved. Without the macro every hook
+ * expands to `((void)0)` and nothing in this header is compiled.
+ *
+ * Counting is per thread: each thread owns a table that only it writes, so the
+ * hot path never performs an atomic read-modify-write on shared memory. The
+ * table is guarded by a per-thread mutex that is only contended while a report
+ * is being assembled. On average only one in `sample_period()` accesses of a
+ * thread takes that lock and the hash lookup (weighted by the period); the
+ * others only decrement a thread-local countdown. The countdown is redrawn
+ * from a geometric distribution after every sample, so periodic access
+ * patterns (e.g. round-robin over as many nodes as the period) do not alias
+ * onto one node. Counts are therefore unbiased estimates whose relative error
+ * shrinks like one over the square root of a node's samples. The default
+ * period is `default_sample_period`; call `set_sample_period(1)` to count
+ * exactly.
+ *
+ * Counts are keyed by node address. `hot_keys()` maps them back to registry
+ * keys, so nodes that are no longer in the registry do not show up. Erasing and
+ * re-adding nodes may reuse addresses — call `reset()` between phases.
+ *
+ * ### Example
+ * @code
+ * #define PROPEX_ENABLE_PROFILING
+ * #include "propex/propex_registry.h"
+ *
+ * profiling::reset();
+ * run_solver(reg);
+ * for (const auto& h : profiling::hot_keys(reg, 10))
+ *     std::cout << h.key << ' ' << h.counts.total() << '\n';
+ * @endcode
+ */
+
+#ifndef PROPEX_PROFILING_H
+#define PROPEX_PROFILING_H
+
+#if defined(PROPEX_ENABLE_PROFILING)
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace numsim::propex::profiling {
+
+/// Kind of access being counted.
+enum class access : unsigned char { find, get, set };
+
+/// Accesses folded into one recorded sample unless `set_sample_period()` says otherwise.
+inline constexpr std::uint32_t default_sample_period = 64;
+
+/// Accumulated (sample-weighted) access counts of one node.
+struct access_counts {
+    std::uint64_t find{};
+    std::uint64_t get{};
+    std::uint64_t set{};
+
+    [[nodiscard]] constexpr std::uint64_t total() const noexcept { return find + get + set; }
+
+    constexpr access_counts& operator+=(const access_counts& other) noexcept {
+        find += other.find;
+        get += other.get;
+        set += other.set;
+        return *this;
+    }
+};
+
+/// A registry key together with its counts, as returned by `hot_keys()`.
+template <class Key>
+struct hot_key {
+    Key key;
+    access_counts counts;
+};
+
+namespace detail {
+
+/// Counts written by exactly one thread.
+struct thread_table {
+    std::mutex mutex;
+    std::unordered_map<const void*, access_counts> counts;
+};
+
+/// Owns all thread tables so that counts survive thread exit.
+struct profiler {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<thread_table>> tables;
+    std::atomic<std::uint32_t> sample_period{default_sample_period};
+
+    static profiler& instance() {
+        static profiler p;
+        return p;
+    }
+};
+
+inline thread_table& local_table() {
+    thread_local std::shared_ptr<thread_table> table = [] {
+        auto t = std::make_shared<thread_table>();
+        auto& p = profiler::instance();
+        std::lock_guard lock(p.mutex);
+        p.tables.push_back(t);
+        return t;
+    }();
+    return *table;
+}
+
+inline void record_slow(access kind, const void* node, std::uint32_t weight) noexcept {
+    try {
+        auto& t = local_table();
+        std::lock_guard lock(t.mutex);
+        auto& c = t.counts[node];
+        switch (kind) {
+        case access::find: c.find += weight; break;
+        case access::get:  c.get += weight; break;
+        case access::set:  c.set += weight; break;
+        }
+    } catch (...) {
+        // Profiling must never change program behavior; drop the sample.
+    }
+}
+
+/// Accesses until the next sample: geometric with mean @p period (exactly 1 for period 1).
+inline std::uint32_t next_countdown(std::uint32_t period) noexcept {
+    if (period <= 1) return 1;
+    thread_local std::uint64_t state = (0x9e3779b97f4a7c15ull ^ reinterpret_cast<std::uintptr_t>(&state)) | 1;
+    state ^= state << 13;  // xorshift64
+    state ^= state >> 7;
+    state ^= state << 17;
+    const double u = (static_cast<double>(state >> 11) + 0.5) * 0x1.0p-53;  // uniform in (0, 1)
+    const double n = std::ceil(std::log(u) / std::log1p(-1.0 / period));
+    return static_cast<std::uint32_t>(std::clamp(n, 1.0, 4294967295.0));
+}
+
+inline void sample(access kind, const void* node) noexcept {
+    thread_local std::uint32_t countdown{1};
+    if (--countdown != 0) return;
+    const auto period = profiler::instance().sample_period.load(std::memory_order_relaxed);
+    countdown = next_countdown(period);
+    record_slow(kind, node, period);
+}
+
+} // namespace detail
+
+/**
+ * @brief Records one access of @p node. Called by the `PROPEX_PROFILE_ACCESS` hook.
+ */
+constexpr inline void record(access kind, const void* node) noexcept {
+    if (std::is_constant_evaluated() || node == nullptr) return;
+    detail::sample(kind, node);
+}
+
+/**
+ * @brief Sets how many accesses per thread are folded into one recorded sample on average (minimum 1).
+ *
+ * A thread picks up the new period at its next sample, i.e. after the
+ * countdown drawn with the old period has expired.
+ */
+inline void set_sample_period(std::uint32_t period) noexcept {
+    detail::profiler::instance().sample_period.store(std::max<std::uint32_t>(period, 1),
+                                                     std::memory_order_relaxed);
+}
+
+/// @return The current sample period.
+[[nodiscard]] inline std::uint32_t sample_period() noexcept {
+    return detail::profiler::instance().sample_period.load(std::memory_order_relaxed);
+}
+
+/// Merges the tables of all threads into a single per-node map.
+[[nodiscard]] inline std::unordered_map<const void*, access_counts> snapshot() {
+    auto& p = detail::profiler::instance();
+    std::unordered_map<const void*, access_counts> merged;
+    std::lock_guard lock(p.mutex);
+    for (const auto& table : p.tables) {
+        std::lock_guard table_lock(table->mutex);
+        for (const auto& [node, counts] : table->counts) merged[node] += counts;
+    }
+    return merged;
+}
+
+/// Discards all counts recorded so far.
+inline void reset() {
+    auto& p = detail::profiler::instance();
+    std::lock_guard lock(p.mutex);
+    for (const auto& table : p.tables) {
+        std::lock_guard table_lock(table->mutex);
+        table->counts.clear();
+    }
+}
+
+/**
+ * @brief Returns the @p n most accessed keys of @p reg, hottest first.
+ *
+ * @tparam Registry A `propex::registry` (anything exposing `data()` as a map
+ *                  from keys to node pointers).
+ */
+template <class Registry>
+[[nodiscard]] auto hot_keys(const Registry& reg, std::size_t n) {
+    using key_type = typename Registry::key_type;
+    const auto counts = snapshot();
+
+    std::vector<hot_key<key_type>> result;
+    for (const auto& [key, ptr] : reg.data()) {
+        const auto it = counts.find(static_cast<const void*>(ptr.get()));
+        if (it != counts.end()) result.push_back({key, it->second});
+    }
+    const auto hotter = [](const auto& a, const auto& b) { return a.counts.total() > b.counts.total(); };
+    const auto top = std::min(n, result.size());
+    std::partial_sort(result.begin(), result.begin() + top, result.end(), hotter);
+    result.resize(top);
+    return result;
+}
+
+/// Writes a plain-text top-@p n report for @p reg.
+template <class Registry>
+void write_report(std::ostream& os, const Registry& reg, std::size_t n) {
+    os << "propex hot keys (sample period " << sample_period() << ")\n";
+    for (const auto& h : hot_keys(reg, n)) {
+        os << h.key << "\ttotal=" << h.counts.total() << " find=" << h.counts.find
+           << " get=" << h.counts.get << " set=" << h.counts.set << '\n';
+    }
+}
+
+} // namespace numsim::propex::profiling
+
+/// Records an access of the given kind (`find`, `get`, `set`) on a node pointer.
+#define PROPEX_PROFILE_ACCESS(kind, node_ptr) \
+    ::numsim::propex::profiling::record(::numsim::propex::profiling::access::kind, \
+                                        static_cast<const void*>(node_ptr))
+
+#else
+
+#define PROPEX_PROFILE_ACCESS(kind, node_ptr) ((void)0)
+
+#endif // PROPEX_ENABLE_PROFILING
+
+#endif // PROPEX_PROFILING_H
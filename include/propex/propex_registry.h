@@ -15,14 +15,52 @@
 #ifndef PROPEX_REGISTRY_HPP
 #define PROPEX_REGISTRY_HPP
 
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
 #include <unordered_map>
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
 #include <utility>
+#include <vector>
 #include "key_traits.h"
+#include "propex_async.h"
+#include "propex_lookup_stats.h"
+#include "propex_memory.h"
+#include "propex_node.h"
+#include "propex_profiling.h"
+#include "propex_trace.h"
 
 namespace numsim::propex {
 
+namespace detail {
+/// True if @p Map finds keys of other types without converting them to its key type.
+template <class Map>
+concept transparent_map = requires { typename Map::key_compare::is_transparent; }
+    || requires {
+           typename Map::hasher::is_transparent;
+           typename Map::key_equal::is_transparent;
+       };
+} // namespace detail
+
+/// What `registry::compact()` rebuilds.
+enum class compact_mode {
+    /// Rebuild the index only; node objects stay where they are.
+    index,
+    /// Additionally move every node next to its index entry (see `node_relocator`).
+    relocate_nodes,
+};
+
+/// Outcome of `registry::compact()`.
+struct compaction_result {
+    std::size_t entries{};
+    std::size_t buckets_before{};
+    std::size_t buckets_after{};
+    std::size_t relocated_nodes{};
+};
+
 /**
  * @brief Generic, flat registry for mapping keys to `node_base` instances.
  *
@@ -57,10 +95,19 @@ public:
     using node_pointer = NodePtr<NodeType>;
     using map_type     = Map<key_type, node_pointer>;
     using key_traits   = KeyTraits<Key>;
+    using allocator_type = typename map_type::allocator_type;
 
     /// Default constructor.
     constexpr registry() noexcept = default;
 
+    /**
+     * @brief Constructs an empty registry whose index uses @p alloc.
+     *
+     * With a `std::pmr::polymorphic_allocator`, the map nodes, buckets and
+     * (allocator-aware) keys are all taken from the same memory resource.
+     */
+    explicit registry(const allocator_type& alloc) : data_(alloc) {}
+
     /// Non-copyable.
     registry(const registry&) = delete;
     registry& operator=(const registry&) = delete;
@@ -85,8 +132,10 @@ public:
     template<typename... Args>
     constexpr inline void add(node_pointer&& node, Args&&... args) {
         static_assert(sizeof...(Args) >= 1, "At least one key argument is required");
-        const auto key = make_key(std::forward<Args>(args)...);
-        data_[key] = std::move(node);
+        PROPEX_TRACE_SCOPE("registry", "add");
+        auto key = make_key(std::forward<Args>(args)...);
+        data_[std::move(key)] = std::move(node);
+        PROPEX_INSERT_RECORD(data_);
     }
 
     // -------------------------------------------------------------------------
@@ -100,8 +149,30 @@ public:
      */
     [[nodiscard]]
     constexpr inline NodeType* find(const key_type& key) const noexcept {
+        PROPEX_TRACE_SCOPE("registry", "find");
         const auto it = data_.find(key);
-        return (it != data_.end()) ? it->second.get() : nullptr;
+        PROPEX_LOOKUP_RECORD(data_, key, it != data_.end());
+        if (it == data_.end()) return nullptr;
+        PROPEX_PROFILE_ACCESS(find, it->second.get());
+        return it->second.get();
+    }
+
+    /**
+     * @brief Finds a node by a key of another type (e.g. `std::string_view`) without converting it.
+     *
+     * Only available when the map hashes and compares transparently, like
+     * `pmr::unordered_map` and `pmr::map`.
+     */
+    template<class K>
+        requires detail::transparent_map<map_type>
+    [[nodiscard]]
+    constexpr inline NodeType* find(const K& key) const noexcept {
+        PROPEX_TRACE_SCOPE("registry", "find");
+        const auto it = data_.find(key);
+        PROPEX_LOOKUP_RECORD(data_, key, it != data_.end());
+        if (it == data_.end()) return nullptr;
+        PROPEX_PROFILE_ACCESS(find, it->second.get());
+        return it->second.get();
     }
 
     /**
@@ -109,7 +180,19 @@ public:
      */
     [[nodiscard]]
     constexpr inline bool contains(const key_type& key) const noexcept {
-        return data_.find(key) != data_.end();
+        const bool hit = data_.find(key) != data_.end();
+        PROPEX_LOOKUP_RECORD(data_, key, hit);
+        return hit;
+    }
+
+    /// `contains()` for a key of another type on a transparent map (see the `find()` overload).
+    template<class K>
+        requires detail::transparent_map<map_type>
+    [[nodiscard]]
+    constexpr inline bool contains(const K& key) const noexcept {
+        const bool hit = data_.find(key) != data_.end();
+        PROPEX_LOOKUP_RECORD(data_, key, hit);
+        return hit;
     }
 
     // -------------------------------------------------------------------------
@@ -124,9 +207,26 @@ public:
      */
     [[nodiscard]]
     constexpr inline NodeType& at(const key_type& key) const {
+        PROPEX_TRACE_SCOPE("registry", "at");
+        const auto it = data_.find(key);
+        PROPEX_LOOKUP_RECORD(data_, key, it != data_.end());
+        if (it == data_.end())
+            throw std::out_of_range("registry::at(): key not found");
+        PROPEX_PROFILE_ACCESS(find, it->second.get());
+        return *it->second;
+    }
+
+    /// `at()` for a key of another type on a transparent map (see the `find()` overload).
+    template<class K>
+        requires detail::transparent_map<map_type>
+    [[nodiscard]]
+    constexpr inline NodeType& at(const K& key) const {
+        PROPEX_TRACE_SCOPE("registry", "at");
         const auto it = data_.find(key);
+        PROPEX_LOOKUP_RECORD(data_, key, it != data_.end());
         if (it == data_.end())
             throw std::out_of_range("registry::at(): key not found");
+        PROPEX_PROFILE_ACCESS(find, it->second.get());
         return *it->second;
     }
 
@@ -140,6 +240,7 @@ public:
      * @return True if an element was erased.
      */
     constexpr inline bool erase(const key_type& key) noexcept {
+        PROPEX_TRACE_SCOPE("registry", "erase");
         return data_.erase(key) > 0;
     }
 
@@ -148,10 +249,209 @@ public:
      */
     constexpr inline void clear() noexcept { data_.clear(); }
 
+    // -------------------------------------------------------------------------
+    // Change Notification
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Awaitable completing at the next change of @p node (`co_await` yields its new version).
+     * @param node A node of this registry (as returned by `find()`); must not be null.
+     * @param scheduler Where the coroutine is resumed (see propex_async.h).
+     */
+    template<resume_scheduler S = inline_scheduler>
+    [[nodiscard]] change_awaitable<S> changed(const NodeType* node, S& scheduler = resume_inline) const noexcept
+        requires std::derived_from<NodeType, node_base>
+    {
+        return change_awaitable<S>(*node, scheduler);
+    }
+
+    /**
+     * @brief Awaitable completing at the next change of the node stored under @p key.
+     * @throws std::out_of_range if the key is not found.
+     */
+    template<resume_scheduler S = inline_scheduler>
+    [[nodiscard]] change_awaitable<S> changed(const key_type& key, S& scheduler = resume_inline) const
+        requires std::derived_from<NodeType, node_base>
+    {
+        return change_awaitable<S>(at(key), scheduler);
+    }
+
+    // -------------------------------------------------------------------------
+    // Time Stepping
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Starts a new time step for every history property in one pass.
+     *
+     * Rotates the ring index of each `ownership::by_history` node (O(1) per
+     * node, no values are copied); other nodes are left untouched.
+     *
+     * @return The number of history nodes rotated.
+     */
+    std::size_t advance() noexcept
+        requires requires(NodeType& n) { { n.advance() } -> std::convertible_to<bool>; }
+    {
+        PROPEX_TRACE_SCOPE("registry", "advance");
+        std::size_t rotated{0};
+        for (auto& entry : data_)
+            if (entry.second && entry.second->advance()) ++rotated;
+        return rotated;
+    }
+
+    // -------------------------------------------------------------------------
+    // Compaction
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Rebuilds the registry in key order after many add/erase cycles.
+     *
+     * A new index sized for the current number of entries replaces the old
+     * one, and entries are re-inserted in key order. Keys sharing a prefix
+     * (`"elem7:..."`) are therefore allocated next to each other. With
+     * `compact_mode::relocate_nodes`, each node is also moved into fresh
+     * memory right before its index entry, so with an arena such as
+     * `huge_page_arena` nodes of neighbouring keys share cache lines and
+     * pages. Iteration still follows the map's own order, which for hashed
+     * maps is bucket order rather than allocation order.
+     *
+     * **Contract for handles**
+     *  - `compact_mode::index` keeps every node in place: pointers returned by
+     *    `find()`/`at()` and `property_view`s bound to them stay valid. Only
+     *    map iterators and references to keys are invalidated.
+     *  - `compact_mode::relocate_nodes` invalidates all node pointers and
+     *    views. It increments `generation()`, so callers that cache views can
+     *    detect this and re-bind them with `find()`. Nodes whose pointer type
+     *    cannot relocate them stay in place (shared ownership, or nodes that
+     *    are not nothrow-movable).
+     *
+     * If an allocation fails, the registry stays unchanged except for nodes
+     * already relocated, which remain valid under their keys.
+     */
+    compaction_result compact(compact_mode mode = compact_mode::index) {
+        PROPEX_TRACE_SCOPE("registry", "compact");
+        using relocator = node_relocator<node_pointer>;
+
+        compaction_result result;
+        result.entries = data_.size();
+        result.buckets_before = bucket_count(data_);
+
+        std::vector<typename map_type::value_type*> order;
+        order.reserve(data_.size());
+        for (auto& entry : data_) order.push_back(&entry);
+        if constexpr (requires { data_.bucket_count(); order.front()->first < order.front()->first; })
+            std::sort(order.begin(), order.end(),
+                      [](const auto* a, const auto* b) { return a->first < b->first; });
+
+        if (mode == compact_mode::relocate_nodes && relocator::supported && !order.empty())
+            ++generation_;
+
+        map_type fresh(data_.get_allocator());
+        if constexpr (requires { fresh.reserve(order.size()); }) fresh.reserve(order.size());
+        std::vector<node_pointer*> slots;
+        slots.reserve(order.size());
+        for (auto* entry : order) {
+            if constexpr (relocator::supported) {
+                if (mode == compact_mode::relocate_nodes && relocator::relocate(entry->second))
+                    ++result.relocated_nodes;
+            }
+            slots.push_back(&fresh.emplace_hint(fresh.end(), entry->first, nullptr)->second);
+        }
+        for (std::size_t i = 0; i < order.size(); ++i) *slots[i] = std::move(order[i]->second);
+        data_.swap(fresh);
+
+        result.buckets_after = bucket_count(data_);
+        return result;
+    }
+
+    /**
+     * @brief Number of `compact(compact_mode::relocate_nodes)` calls that may have moved nodes.
+     *
+     * Node pointers and views obtained at an older generation must be
+     * re-acquired with `find()`.
+     */
+    [[nodiscard]]
+    constexpr std::uint64_t generation() const noexcept { return generation_; }
+
+    // -------------------------------------------------------------------------
+    // Memory Accounting
+    // -------------------------------------------------------------------------
+
+    /**
+     * @brief Computes the memory attributed to this registry.
+     *
+     * Walks all entries once. Keys and values are measured via
+     * `memory_traits`; map nodes, buckets and control blocks are estimated
+     * from the container layout (see `index_memory`). If the allocator draws
+     * from an `accounting_resource`, its byte count is reported as well
+     * (`memory_footprint::measured_bytes`).
+     *
+     * @return A breakdown whose `total()` is the overall footprint.
+     */
+    [[nodiscard]]
+    memory_footprint memory_usage() const {
+        using index = index_memory<map_type>;
+        constexpr bool shared_ownership = requires(const node_pointer& p) { p.use_count(); };
+
+        memory_footprint f;
+        f.properties      = data_.size();
+        f.registry_object = sizeof(*this);
+        f.index_buckets   = index::bucket_bytes(data_);
+        f.index_nodes     = data_.size() * (index::node_bytes() - sizeof(key_type) - sizeof(node_pointer));
+        f.key_objects     = data_.size() * sizeof(key_type);
+        f.node_pointers   = data_.size() * sizeof(node_pointer);
+
+        for (const auto& [key, ptr] : data_) {
+            const auto key_heap = heap_bytes(key);
+            f.key_heap += key_heap;
+            ++(key_heap ? f.keys_on_heap : f.keys_inline);
+            if (!ptr) continue;
+
+            if constexpr (shared_ownership)
+                f.node_pointers += shared_control_block_bytes / static_cast<std::size_t>(ptr.use_count());
+
+            if constexpr (std::is_base_of_v<node_base, NodeType>) {
+                const auto object = ptr->object_bytes();
+                const auto payload = ptr->payload_bytes();
+                f.node_objects += object;
+                f.payload_heap += payload;
+                f.by_type[ptr->underlying_type()] += object + payload;
+            } else {
+                const auto payload = heap_bytes(*ptr);
+                f.node_objects += sizeof(NodeType);
+                f.payload_heap += payload;
+                f.by_type[std::type_index(typeid(NodeType))] += sizeof(NodeType) + payload;
+            }
+        }
+        if constexpr (requires { data_.get_allocator().resource(); }) {
+            if (const auto* counted = dynamic_cast<const accounting_resource*>(data_.get_allocator().resource())) {
+                f.measured = true;
+                f.measured_bytes = counted->bytes_in_use();
+            }
+        }
+        return f;
+    }
+
+#if defined(PROPEX_ENABLE_LOOKUP_STATS)
+    // -------------------------------------------------------------------------
+    // Lookup Statistics
+    // -------------------------------------------------------------------------
+
+    /// @return A snapshot of the lookup counters (see propex_lookup_stats.h).
+    [[nodiscard]]
+    lookup_statistics lookup_stats() const noexcept { return lookup_counters_.snapshot(); }
+
+    /// Resets all lookup counters to zero.
+    void reset_lookup_stats() noexcept { lookup_counters_.reset(); }
+#endif
+
     // -------------------------------------------------------------------------
     // Iteration / View
     // -------------------------------------------------------------------------
 
+    /// @return A copy of the allocator used by the underlying map.
+    [[nodiscard]]
+    allocator_type get_allocator() const noexcept { return data_.get_allocator(); }
+
     /// @return A const reference to the underlying map container.
     [[nodiscard]]
     constexpr inline const map_type& data() const noexcept { return data_; }
@@ -161,16 +461,37 @@ public:
     constexpr inline map_type& data() noexcept { return data_; }
 
 private:
-    // Utility — merges key fragments using traits
+    // Utility — merges key fragments using traits. Allocator-aware keys are
+    // built with the map's allocator so they never leave its memory resource.
     template<typename... Args>
-    static constexpr key_type make_key(Args&&... args) {
-        if constexpr (sizeof...(Args) == 1)
-            return key_type(std::forward<Args>(args)...);
-        else
-            return key_traits::merge(std::forward<Args>(args)...);
+    constexpr key_type make_key(Args&&... args) const {
+        if constexpr (requires { typename key_type::allocator_type; }
+                      && std::is_constructible_v<typename key_type::allocator_type, allocator_type>) {
+            const typename key_type::allocator_type alloc(data_.get_allocator());
+            if constexpr (sizeof...(Args) == 1)
+                return key_type(std::forward<Args>(args)..., alloc);
+            else if constexpr (requires { key_traits::merge(std::allocator_arg, alloc, args...); })
+                return key_traits::merge(std::allocator_arg, alloc, std::forward<Args>(args)...);
+            else
+                return key_type(key_traits::merge(std::forward<Args>(args)...), alloc);
+        } else {
+            if constexpr (sizeof...(Args) == 1)
+                return key_type(std::forward<Args>(args)...);
+            else
+                return key_traits::merge(std::forward<Args>(args)...);
+        }
+    }
+
+    static std::size_t bucket_count(const map_type& map) noexcept {
+        if constexpr (requires { map.bucket_count(); }) return map.bucket_count();
+        else return 0;
     }
 
     map_type data_;
+    std::uint64_t generation_{0};
+#if defined(PROPEX_ENABLE_LOOKUP_STATS)
+    mutable lookup_counters lookup_counters_;
+#endif
 };
 
 } // namespace propex
@@ -0,0 +1,561 @@
+/**
+ * @file propex_scheduler.h
+ * @brief Work-stealing task scheduler shared by propex's parallel features.
+ *
+ * @details
+ * Parallel operations (`parallel_for()`, `parallel_assign()` in
+ * propex_expr.h, coroutine resumption from propex_async.h) run on an
+ * `executor`. The concept is small, so an application's own thread pool can
+ * be used instead:
+ *
+ * @code
+ * template <class E>
+ * concept executor = requires(E& e, task t, task_group& g) {
+ *     e.submit(std::move(t));  // run t exactly once, on any thread
+ *     e.wait(g);               // return once g has no pending tasks, rethrow its first exception
+ *     { e.concurrency() } -> std::convertible_to<std::size_t>;
+ * };
+ * @endcode
+ *
+ * `work_stealing_scheduler` is propex's own executor:
+ *  - every worker owns a deque; it pushes and pops at the back (LIFO, cache
+ *    friendly), idle workers steal from the front of the others;
+ *  - `wait()` is cooperative: the waiting thread runs queued tasks instead of
+ *    blocking, so nested parallel loops cannot starve the pool;
+ *  - workers sleep on an atomic (no polling) when there is nothing to do;
+ *  - `pinning::cores` pins worker i to the i-th allowed CPU,
+ *    `pinning::numa_nodes` spreads workers over the NUMA nodes (Linux
+ *    `/sys/devices/system/node`) and lets them steal from their own node
+ *    first. Pinning is best effort (`pinned_workers()` reports the result)
+ *    and a no-op outside Linux.
+ *
+ * `shared_scheduler()` is the process-wide instance the propex features use
+ * by default, created on first use.
+ *
+ * @code
+ * task_group g;
+ * auto& pool = shared_scheduler();
+ * pool.run(g, [&] { update(a); });
+ * pool.run(g, [&] { update(b); });
+ * pool.wait(g);
+ *
+ * parallel_for(pool, n, [&](std::size_t first, std::size_t last) { ... });
+ * @endcode
+ */
+
+#ifndef PROPEX_SCHEDULER_H
+#define PROPEX_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ownership_policies.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace numsim::propex {
+
+/**
+ * @brief Counts the pending tasks of a batch and keeps the first exception one of them threw.
+ *
+ * Must outlive its tasks: wait for it before it goes out of scope.
+ */
+class task_group {
+public:
+    task_group() = default;
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    /// Tasks created for this group that have not finished.
+    [[nodiscard]] std::size_t pending() const noexcept { return pending_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Blocks until no task is pending, then rethrows the first exception (once).
+     *
+     * For executors that cannot help; `work_stealing_scheduler::wait()` runs tasks meanwhile.
+     */
+    void wait() {
+        for (std::size_t p = pending(); p != 0; p = pending()) pending_.wait(p, std::memory_order_acquire);
+        rethrow();
+    }
+
+    /// Rethrows and clears the first exception a task of this group threw.
+    void rethrow() {
+        std::exception_ptr error;
+        {
+            const std::lock_guard lock(error_lock_);
+            error = std::exchange(error_, nullptr);
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    friend class task;
+    friend class work_stealing_scheduler;
+
+    void started() noexcept { pending_.fetch_add(1, std::memory_order_relaxed); }
+
+    void finished() noexcept {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) pending_.notify_all();
+    }
+
+    void failed(std::exception_ptr e) noexcept {
+        const std::lock_guard lock(error_lock_);
+        if (!error_) error_ = std::move(e);
+    }
+
+    std::atomic<std::size_t> pending_{0};
+    ownership::spinlock error_lock_;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief Move-only unit of work, optionally counted by a `task_group`.
+ *
+ * Callables up to `inline_size` bytes are stored in place (no allocation).
+ * An exception is recorded in the group; without a group it calls `std::terminate()`.
+ */
+class task {
+public:
+    /// Bytes available for callables stored without allocation.
+    static constexpr std::size_t inline_size = 4 * sizeof(void*);
+
+    task() noexcept = default;
+
+    /// Wraps @p fn; counts as pending in @p group (if any) until it has run.
+    template <class F>
+        requires std::invocable<std::decay_t<F>&> && (!std::is_same_v<std::decay_t<F>, task>)
+    explicit task(F&& fn, task_group* group = nullptr) : group_(group) {
+        using D = std::decay_t<F>;
+        if constexpr (sizeof(D) <= inline_size && alignof(D) <= alignof(std::max_align_t)
+                      && std::is_nothrow_move_constructible_v<D>) {
+            ::new (static_cast<void*>(storage_)) D(std::forward<F>(fn));
+            manage_ = &manage_inline<D>;
+        } else {
+            ::new (static_cast<void*>(storage_)) D*(new D(std::forward<F>(fn)));
+            manage_ = &manage_heap<D>;
+        }
+        if (group_) group_->started();
+    }
+
+    task(task&& other) noexcept : manage_(other.manage_), group_(std::exchange(other.group_, nullptr)) {
+        if (manage_) manage_(action::move, *this, &other);
+        other.manage_ = nullptr;
+    }
+
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            abandon();
+            manage_ = std::exchange(other.manage_, nullptr);
+            group_ = std::exchange(other.group_, nullptr);
+            if (manage_) manage_(action::move, *this, &other);
+        }
+        return *this;
+    }
+
+    ~task() { abandon(); }
+
+    /// `true` if the task holds work that has not run.
+    explicit operator bool() const noexcept { return manage_ != nullptr; }
+
+    /// Runs the work once, then releases it and signals the group.
+    void operator()() noexcept {
+        if (!manage_) return;
+        try {
+            manage_(action::run, *this, nullptr);
+        } catch (...) {
+            if (!group_) std::terminate();
+            group_->failed(std::current_exception());
+        }
+        manage_(action::destroy, *this, nullptr);
+        manage_ = nullptr;
+        if (group_) std::exchange(group_, nullptr)->finished();
+    }
+
+private:
+    enum class action { run, move, destroy };
+    using manager = void (*)(action, task&, task*);
+
+    template <class D>
+    static D* stored(task& t) noexcept { return std::launder(reinterpret_cast<D*>(t.storage_)); }
+
+    template <class D>
+    static void manage_inline(action a, task& self, task* other) {
+        switch (a) {
+            case action::run: (*stored<D>(self))(); break;
+            case action::move:
+                ::new (static_cast<void*>(self.storage_)) D(std::move(*stored<D>(*other)));
+                stored<D>(*other)->~D();
+                break;
+            case action::destroy: stored<D>(self)->~D(); break;
+        }
+    }
+
+    template <class D>
+    static void manage_heap(action a, task& self, task* other) {
+        switch (a) {
+            case action::run: (**stored<D*>(self))(); break;
+            case action::move: ::new (static_cast<void*>(self.storage_)) D*(*stored<D*>(*other)); break;
+            case action::destroy: delete *stored<D*>(self); break;
+        }
+    }
+
+    /// Drops work that never ran (the executor shut down); the group still sees it finish.
+    void abandon() noexcept {
+        if (manage_) manage_(action::destroy, *this, nullptr);
+        manage_ = nullptr;
+        if (group_) std::exchange(group_, nullptr)->finished();
+    }
+
+    alignas(std::max_align_t) std::byte storage_[inline_size];
+    manager manage_{nullptr};
+    task_group* group_{nullptr};
+};
+
+/// What propex's parallel features need from a thread pool.
+template <class E>
+concept executor = requires(E& e, task t, task_group& g) {
+    e.submit(std::move(t));
+    e.wait(g);
+    { e.concurrency() } -> std::convertible_to<std::size_t>;
+};
+
+/// Runs every task immediately on the submitting thread (deterministic debugging, single-threaded builds).
+struct sequential_executor {
+    void submit(task t) const noexcept { t(); }
+    void wait(task_group& g) const { g.wait(); }
+    [[nodiscard]] static constexpr std::size_t concurrency() noexcept { return 1; }
+};
+
+/// Thread placement of `work_stealing_scheduler` workers.
+enum class pinning {
+    none,        ///< Let the OS place the workers.
+    cores,       ///< Worker i on the i-th CPU the process may use (wrapping around).
+    numa_nodes,  ///< Workers round-robin over NUMA nodes, each allowed on all CPUs of its node.
+};
+
+/// Configuration of a `work_stealing_scheduler`.
+struct scheduler_options {
+    /// Worker threads; 0 uses `hardware_concurrency() - 1` (the waiting thread helps), at least 1.
+    std::size_t workers = 0;
+    pinning pin = pinning::none;
+};
+
+namespace detail {
+
+/// Parses a Linux cpulist such as `"0-3,8,10-11"`.
+inline std::vector<int> parse_cpulist(const std::string& text) {
+    std::vector<int> cpus;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        std::size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        const std::string item = text.substr(pos, end - pos);
+        if (const std::size_t dash = item.find('-'); dash != std::string::npos) {
+            for (int c = std::stoi(item.substr(0, dash)), last = std::stoi(item.substr(dash + 1)); c <= last; ++c)
+                cpus.push_back(c);
+        } else if (!item.empty() && item != "\n") {
+            cpus.push_back(std::stoi(item));
+        }
+        pos = end + 1;
+    }
+    return cpus;
+}
+
+/// CPUs this process may run on, grouped by NUMA node (one group if the topology is unknown).
+inline std::vector<std::vector<int>> allowed_cpus_by_node() {
+    std::vector<int> allowed;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) allowed.push_back(c);
+#endif
+    std::vector<std::vector<int>> nodes;
+#if defined(__linux__)
+    for (int n = 0;; ++n) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+        if (!in) break;
+        std::string text;
+        std::getline(in, text);
+        std::vector<int> cpus;
+        try {
+            cpus = parse_cpulist(text);
+        } catch (const std::exception&) {
+            continue;
+        }
+        std::erase_if(cpus, [&](int c) { return std::find(allowed.begin(), allowed.end(), c) == allowed.end(); });
+        if (!cpus.empty()) nodes.push_back(std::move(cpus));
+    }
+#endif
+    if (nodes.empty() && !allowed.empty()) nodes.push_back(std::move(allowed));
+    return nodes;
+}
+
+/// Restricts @p thread to @p cpus; `false` if unsupported or refused.
+inline bool pin_thread([[maybe_unused]] std::thread& thread, [[maybe_unused]] const std::vector<int>& cpus) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int c : cpus) CPU_SET(c, &set);
+    return !cpus.empty() && pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+/// Scheduler and worker index of the calling thread, if it is a worker.
+inline thread_local const void* current_pool = nullptr;
+inline thread_local std::size_t current_worker = 0;
+
+} // namespace detail
+
+/**
+ * @brief Thread pool with per-worker deques, work stealing and cooperative waiting.
+ *
+ * Satisfies `executor` and `resume_scheduler` (propex_async.h). The
+ * destructor runs the remaining tasks, then joins the workers.
+ */
+class work_stealing_scheduler {
+public:
+    explicit work_stealing_scheduler(scheduler_options options = {}) {
+        std::size_t n = options.workers;
+        if (n == 0) n = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        queues_ = std::make_unique<queue[]>(n);
+        workers_count_ = n;
+
+        // Placement and steal order: own NUMA node first, then the others.
+        const std::vector<std::vector<int>> nodes =
+            options.pin == pinning::none ? std::vector<std::vector<int>>{} : detail::allowed_cpus_by_node();
+        std::vector<std::size_t> node_of(n, 0);
+        if (options.pin == pinning::numa_nodes && !nodes.empty())
+            for (std::size_t i = 0; i < n; ++i) node_of[i] = i % nodes.size();
+        steal_order_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t d = 1; d < n; ++d)
+                if (node_of[(i + d) % n] == node_of[i]) steal_order_[i].push_back((i + d) % n);
+            for (std::size_t d = 1; d < n; ++d)
+                if (node_of[(i + d) % n] != node_of[i]) steal_order_[i].push_back((i + d) % n);
+        }
+
+        std::vector<int> all_cpus;
+        for (const auto& cpus : nodes) all_cpus.insert(all_cpus.end(), cpus.begin(), cpus.end());
+        threads_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            threads_.emplace_back([this, i] { work(i); });
+            bool pinned = false;
+            if (options.pin == pinning::cores && !all_cpus.empty())
+                pinned = detail::pin_thread(threads_.back(), {all_cpus[i % all_cpus.size()]});
+            else if (options.pin == pinning::numa_nodes && !nodes.empty())
+                pinned = detail::pin_thread(threads_.back(), nodes[node_of[i]]);
+            pinned_ += pinned;
+        }
+    }
+
+    work_stealing_scheduler(const work_stealing_scheduler&) = delete;
+    work_stealing_scheduler& operator=(const work_stealing_scheduler&) = delete;
+
+    ~work_stealing_scheduler() {
+        stop_.store(true, std::memory_order_release);
+        wake(true);
+        for (std::thread& t : threads_) t.join();
+    }
+
+    /// Worker threads plus the thread that waits.
+    [[nodiscard]] std::size_t concurrency() const noexcept { return workers_count_ + 1; }
+    /// Number of worker threads.
+    [[nodiscard]] std::size_t workers() const noexcept { return workers_count_; }
+    /// Workers whose affinity was set as requested.
+    [[nodiscard]] std::size_t pinned_workers() const noexcept { return pinned_; }
+    /// Tasks a worker took from another worker's deque (cumulative).
+    [[nodiscard]] std::uint64_t steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+    /// Queues @p t: on the calling worker's own deque, else round-robin.
+    void submit(task t) {
+        const std::size_t target = detail::current_pool == this
+            ? detail::current_worker
+            : next_.fetch_add(1, std::memory_order_relaxed) % workers_count_;
+        queued_.fetch_add(1, std::memory_order_seq_cst);  // before the push, so the count never underflows
+        {
+            const std::lock_guard lock(queues_[target].lock);
+            queues_[target].tasks.push_back(std::move(t));
+        }
+        wake(false);
+    }
+
+    /// Queues @p fn as a task of @p group.
+    template <class F>
+    void run(task_group& group, F&& fn) {
+        submit(task(std::forward<F>(fn), &group));
+    }
+
+    /// Queues @p fn without a group; an exception escaping it terminates.
+    template <class F>
+    void post(F&& fn) {
+        submit(task(std::forward<F>(fn)));
+    }
+
+    /// Resumes @p h on a worker (`resume_scheduler`).
+    void schedule(std::coroutine_handle<> h) {
+        post([h] { h.resume(); });
+    }
+
+    /**
+     * @brief Runs queued tasks until @p group has none pending, then rethrows its first exception.
+     *
+     * Blocks only while nothing is runnable and tasks of @p group are still running elsewhere.
+     */
+    void wait(task_group& group) {
+        const bool worker = detail::current_pool == this;
+        while (group.pending() != 0) {
+            if (std::optional<task> t = take(worker ? detail::current_worker : workers_count_)) {
+                (*t)();
+                continue;
+            }
+            if (const std::size_t p = group.pending(); p != 0 && queued_.load(std::memory_order_acquire) == 0)
+                group.pending_.wait(p, std::memory_order_acquire);
+        }
+        group.rethrow();
+    }
+
+private:
+    struct alignas(64) queue {
+        ownership::spinlock lock;
+        std::deque<task> tasks;
+    };
+
+    /// Own deque from the back, then steal from the front of the others. @p self == workers() for outside threads.
+    std::optional<task> take(std::size_t self) {
+        if (queued_.load(std::memory_order_acquire) == 0) return std::nullopt;
+        if (self < workers_count_) {
+            if (std::optional<task> t = pop(self, true)) return t;
+            for (const std::size_t victim : steal_order_[self])
+                if (std::optional<task> t = pop(victim, false)) {
+                    steals_.fetch_add(1, std::memory_order_relaxed);
+                    return t;
+                }
+            return std::nullopt;
+        }
+        for (std::size_t victim = 0; victim < workers_count_; ++victim)
+            if (std::optional<task> t = pop(victim, false)) return t;
+        return std::nullopt;
+    }
+
+    std::optional<task> pop(std::size_t q, bool back) {
+        queue& from = queues_[q];
+        const std::lock_guard lock(from.lock);
+        if (from.tasks.empty()) return std::nullopt;
+        std::optional<task> t;
+        if (back) {
+            t.emplace(std::move(from.tasks.back()));
+            from.tasks.pop_back();
+        } else {
+            t.emplace(std::move(from.tasks.front()));
+            from.tasks.pop_front();
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return t;
+    }
+
+    void wake(bool all) noexcept {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (all) epoch_.notify_all();
+        else if (sleepers_.load(std::memory_order_seq_cst) != 0) epoch_.notify_one();
+    }
+
+    void work(std::size_t self) {
+        detail::current_pool = this;
+        detail::current_worker = self;
+        constexpr int spins = 64;
+        for (int idle = 0;;) {
+            if (std::optional<task> t = take(self)) {
+                (*t)();
+                idle = 0;
+                continue;
+            }
+            if (stop_.load(std::memory_order_acquire) && queued_.load(std::memory_order_acquire) == 0) return;
+            if (++idle < spins) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Sleep until a submit bumps the epoch (re-checked after announcing, so no wake-up is lost).
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint64_t seen = epoch_.load(std::memory_order_seq_cst);
+            if (queued_.load(std::memory_order_seq_cst) == 0 && !stop_.load(std::memory_order_seq_cst))
+                epoch_.wait(seen, std::memory_order_seq_cst);
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+            idle = 0;
+        }
+    }
+
+    std::unique_ptr<queue[]> queues_;
+    std::size_t workers_count_{0};
+    std::vector<std::vector<std::size_t>> steal_order_;
+    std::vector<std::thread> threads_;
+    std::size_t pinned_{0};
+
+    alignas(64) std::atomic<std::size_t> queued_{0};
+    alignas(64) std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<std::size_t> sleepers_{0};
+    std::atomic<std::size_t> next_{0};
+    std::atomic<std::uint64_t> steals_{0};
+    std::atomic<bool> stop_{false};
+};
+
+/// The scheduler propex's parallel features use unless given another executor.
+inline work_stealing_scheduler& shared_scheduler() {
+    static work_stealing_scheduler pool;
+    return pool;
+}
+
+/**
+ * @brief Calls `body(first, last)` for @p chunks contiguous ranges covering `[0, n)` on @p ex.
+ *
+ * The calling thread runs the first range and then helps via `ex.wait()`.
+ * @param chunks Number of ranges; 0 uses `ex.concurrency()`.
+ * @throws The first exception thrown by @p body, after all ranges finished.
+ */
+template <executor E, class Body>
+void parallel_for(E& ex, std::size_t n, Body&& body, std::size_t chunks = 0) {
+    if (chunks == 0) chunks = ex.concurrency();
+    chunks = std::max<std::size_t>(1, std::min(chunks, n));
+    if (chunks == 1) {
+        if (n) body(std::size_t{0}, n);
+        return;
+    }
+    const std::size_t size = n / chunks, extra = n % chunks;
+    const auto bounds = [&](std::size_t c) { return c * size + std::min(c, extra); };
+    task_group group;
+    try {
+        for (std::size_t c = 1; c < chunks; ++c)
+            ex.submit(task([&body, first = bounds(c), last = bounds(c + 1)] { body(first, last); }, &group));
+        body(std::size_t{0}, bounds(1));
+    } catch (...) {
+        ex.wait(group);  // queued ranges reference group and body: let them finish first
+        throw;
+    }
+    ex.wait(group);
+}
+
+} // namespace numsim::propex
+
+#endif // PROPEX_SCHEDULER_H
@@ -0,0 +1,256 @@
+/**
+ * @file propex_sensitivity.h
+ * @brief Forward-mode derivatives of derived properties with respect to scalar parameters.
+ *
+ * @details
+ * A `sensitivity_pass` seeds N scalar parameters and applies formulas
+ * (propex_formula.h) in dual-number arithmetic: every register carries its
+ * value and N derivative planes, so one evaluation per formula yields the
+ * derivatives with respect to all parameters. Derivatives of each target
+ * are kept by the pass and picked up by later formulas reading that
+ * target, so applying a chain of formulas in dependency order propagates
+ * the sensitivities through the chain.
+ *
+ * @code
+ * sensitivity_pass pass(reg, {"mat:E", "mat:nu"});
+ * pass.apply(compile_formula(reg, "mat:G = mat:E / (2*(1+mat:nu))"));
+ * pass.apply(compile_formula(reg, "load:tau = mat:G * load:gamma"));
+ * double dtau_dnu = pass.derivative("load:tau", 1);
+ * @endcode
+ *
+ * Values are written to the targets as with `formula::apply()`. Inputs
+ * that are neither parameters nor targets of an earlier `apply()` count
+ * as constant. Derivative planes known to be zero (a register that does
+ * not depend on that parameter) are not computed.
+ */
+
+#ifndef PROPEX_SENSITIVITY_H
+#define PROPEX_SENSITIVITY_H
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "propex_formula.h"
+
+namespace numsim::propex {
+
+/**
+ * @brief Dual-number evaluation of formulas for a fixed set of scalar parameters.
+ *
+ * Derivatives of a target with `n` elements are stored parameter-major:
+ * element `i` with respect to parameter `k` is at `k * n + i`.
+ */
+class sensitivity_pass {
+public:
+    /**
+     * @brief Seeds the scalar properties @p parameters, in this order.
+     *
+     * Accepts any range of keys convertible to `std::string_view`, e.g. a
+     * `std::vector<std::string>` or `std::span<const std::string>`.
+     * @throws std::out_of_range for unknown keys, std::invalid_argument for keys that are not numeric scalars.
+     */
+    template <class Registry, std::ranges::input_range Keys>
+        requires std::convertible_to<std::ranges::range_reference_t<Keys>, std::string_view>
+    sensitivity_pass(const Registry& reg, Keys&& parameters) {
+        for (auto&& element : parameters) {
+            const std::string_view key = element;
+            const node_base* n = reg.find(typename Registry::key_type(key));
+            if (!n) throw std::out_of_range("sensitivity_pass: unknown key '" + std::string(key) + "'");
+            if (numeric_access::size(*n) != 1)
+                throw std::invalid_argument("sensitivity_pass: '" + std::string(key) + "' is not a numeric scalar");
+            parameters_.emplace_back(key);
+        }
+    }
+
+    /// @copydoc sensitivity_pass(const Registry&, Keys&&)
+    template <class Registry>
+    sensitivity_pass(const Registry& reg, std::initializer_list<std::string_view> parameters)
+        : sensitivity_pass(reg, std::span(parameters.begin(), parameters.size())) {}
+
+    /// Number of seeded parameters.
+    [[nodiscard]] std::size_t parameters() const noexcept { return parameters_.size(); }
+
+    /**
+     * @brief Evaluates @p f with derivatives, writes its target and records the target's derivatives.
+     * @throws std::logic_error if @p f has no target; std::invalid_argument if an input with
+     *         recorded derivatives was resized since; as `formula::apply()` otherwise.
+     */
+    void apply(const formula& f) {
+        if (!f.target_node_) throw std::logic_error("sensitivity_pass: formula has no target");
+        const std::size_t n = f.size();
+        if (numeric_access::size(*f.target_node_) != n)
+            throw std::invalid_argument("formula: target size differs from the inputs");
+        std::vector<double> result(parameters_.size() * n, 0.0);
+        run(f, n, result);
+        derivatives_[f.target_key_] = std::move(result);
+        f.target_node_->mark_changed();
+    }
+
+    /// All derivatives of @p key (see the class documentation), empty if @p key was not a target.
+    [[nodiscard]] std::span<const double> derivatives(std::string_view key) const {
+        const auto it = derivatives_.find(key);
+        return it == derivatives_.end() ? std::span<const double>{} : std::span<const double>(it->second);
+    }
+
+    /**
+     * @brief d key[element] / d parameters[parameter]; 1 or 0 for the parameters themselves.
+     * @throws std::out_of_range if @p key has no recorded derivatives or the indices are out of range.
+     */
+    [[nodiscard]] double derivative(std::string_view key, std::size_t parameter, std::size_t element = 0) const {
+        if (parameter >= parameters_.size()) throw std::out_of_range("sensitivity_pass: parameter index out of range");
+        const auto seed = std::find(parameters_.begin(), parameters_.end(), key);
+        if (seed != parameters_.end()) return seed - parameters_.begin() == static_cast<std::ptrdiff_t>(parameter);
+        const std::span<const double> d = derivatives(key);
+        const std::size_t n = d.size() / parameters_.size();
+        if (d.empty() || element >= n) throw std::out_of_range("sensitivity_pass: no derivative recorded");
+        return d[parameter * n + element];
+    }
+
+private:
+    /// Derivative source of input @p i: a seed, derivatives of an earlier target, or none.
+    struct input_tangent {
+        std::ptrdiff_t seed{-1};
+        const std::vector<double>* stored{nullptr};
+        std::size_t stored_size{0};
+    };
+
+    void run(const formula& f, std::size_t n, std::vector<double>& result) const {
+        if (n == 0) return;  // empty fields: no values and no derivatives
+        const std::size_t dims = parameters_.size();
+        const std::size_t regs = f.registers_;
+        const std::size_t width = std::min(formula_batch, n);
+        const std::size_t first_input = f.constants_.size();
+        const std::size_t inputs = f.input_nodes_.size();
+
+        std::vector<double> values(regs * width), tangents(regs * dims * width), scratch(width), zeros(width, 0.0);
+        const auto value = [&](std::size_t r) { return values.data() + r * width; };
+        const auto plane = [&](std::size_t r, std::size_t k) { return tangents.data() + (r * dims + k) * width; };
+
+        // Activity: which registers depend on which parameter, following register reuse in program order.
+        // Stored derivatives of earlier targets count as depending on every parameter.
+        std::vector<input_tangent> sources(inputs);
+        std::vector<std::uint8_t> depends(regs * dims, 0);
+        for (std::size_t i = 0; i < inputs; ++i) {
+            const std::string& key = f.input_keys_[i];
+            std::uint8_t* d = depends.data() + (first_input + i) * dims;
+            if (const auto seed = std::find(parameters_.begin(), parameters_.end(), key); seed != parameters_.end()) {
+                sources[i].seed = seed - parameters_.begin();
+                d[sources[i].seed] = 1;
+            } else if (const auto it = derivatives_.find(key); it != derivatives_.end() && dims > 0) {
+                sources[i].stored = &it->second;
+                sources[i].stored_size = it->second.size() / dims;
+                if (sources[i].stored_size != numeric_access::size(*f.input_nodes_[i]))
+                    throw std::invalid_argument("sensitivity_pass: '" + key
+                                                + "' was resized after its derivatives were recorded");
+                std::fill_n(d, dims, 1);
+            }
+        }
+        std::vector<std::uint8_t> operands(f.code_.size() * dims);  // per parameter, bit 0: a, bit 1: b
+        for (std::size_t j = 0; j < f.code_.size(); ++j) {
+            const formula_instruction& ins = f.code_[j];
+            for (std::size_t k = 0; k < dims; ++k) {
+                operands[j * dims + k] = static_cast<std::uint8_t>(depends[ins.a * dims + k] | depends[ins.b * dims + k] << 1);
+                depends[ins.dst * dims + k] = operands[j * dims + k] != 0;
+            }
+        }
+        const std::vector<std::uint8_t> result_depends(depends.begin() + f.result_ * dims,
+                                                       depends.begin() + (f.result_ + 1) * dims);
+
+        // Broadcast constants, scalar inputs and their derivatives once.
+        for (std::size_t c = 0; c < first_input; ++c) std::fill_n(value(c), width, f.constants_[c]);
+        for (std::size_t i = 0; i < inputs; ++i) {
+            const std::size_t r = first_input + i;
+            if (n > 1 && numeric_access::size(*f.input_nodes_[i]) == n) continue;
+            double v;
+            numeric_access::load(*f.input_nodes_[i], 0, std::span(&v, 1));
+            std::fill_n(value(r), width, v);
+            for (std::size_t k = 0; k < dims; ++k) {
+                double d = 0.0;
+                if (sources[i].seed >= 0) d = static_cast<std::size_t>(sources[i].seed) == k;
+                else if (sources[i].stored) d = (*sources[i].stored)[k * sources[i].stored_size];
+                std::fill_n(plane(r, k), width, d);
+            }
+        }
+
+        for (std::size_t first = 0; first < n; first += width) {
+            const std::size_t count = std::min(width, n - first);
+            for (std::size_t i = 0; i < inputs; ++i) {
+                const std::size_t r = first_input + i;
+                if (n == 1 || numeric_access::size(*f.input_nodes_[i]) != n) continue;
+                numeric_access::load(*f.input_nodes_[i], first, std::span(value(r), count));
+                for (std::size_t k = 0; k < dims && sources[i].stored; ++k)
+                    std::copy_n(sources[i].stored->data() + k * sources[i].stored_size + first, count, plane(r, k));
+            }
+            for (std::size_t j = 0; j < f.code_.size(); ++j) {
+                const formula_instruction& ins = f.code_[j];
+                formula::execute(ins.op, scratch.data(), value(ins.a), value(ins.b), count);
+                for (std::size_t k = 0; k < dims; ++k) {
+                    const std::uint8_t active = operands[j * dims + k];
+                    if (!active) continue;
+                    const double* da = active & 1 ? plane(ins.a, k) : zeros.data();
+                    const double* db = active & 2 ? plane(ins.b, k) : zeros.data();
+                    tangent(ins.op, plane(ins.dst, k), value(ins.a), value(ins.b), scratch.data(), da, db, active, count);
+                }
+                std::copy_n(scratch.data(), count, value(ins.dst));
+            }
+            numeric_access::store(*f.target_node_, first, std::span(value(f.result_), count));
+            for (std::size_t k = 0; k < dims; ++k)
+                if (result_depends[k]) std::copy_n(plane(f.result_, k), count, result.data() + k * n + first);
+        }
+    }
+
+    /**
+     * @brief Derivative plane of `r = op(a, b)`; runs before `r` is stored, so @p d may alias @p da or @p db.
+     *
+     * Inactive operands pass a plane of zeros; @p active tells which (bit 0: a, bit 1: b).
+     */
+    static void tangent(formula_op op, double* d, const double* a, const double* b, const double* r,
+                        const double* da, const double* db, std::uint8_t active, std::size_t n) noexcept {
+        switch (op) {
+            case formula_op::add:
+                if (active == 1) { if (d != da) std::copy_n(da, n, d); }
+                else if (active == 2) { if (d != db) std::copy_n(db, n, d); }
+                else for (std::size_t i = 0; i < n; ++i) d[i] = da[i] + db[i];
+                break;
+            case formula_op::sub: for (std::size_t i = 0; i < n; ++i) d[i] = da[i] - db[i]; break;
+            case formula_op::mul:
+                if (active == 1) for (std::size_t i = 0; i < n; ++i) d[i] = da[i] * b[i];
+                else if (active == 2) for (std::size_t i = 0; i < n; ++i) d[i] = a[i] * db[i];
+                else for (std::size_t i = 0; i < n; ++i) d[i] = da[i] * b[i] + a[i] * db[i];
+                break;
+            case formula_op::div: for (std::size_t i = 0; i < n; ++i) d[i] = (da[i] - r[i] * db[i]) / b[i]; break;
+            case formula_op::pow:
+                // The log term only where the exponent varies, so constant exponents of negative bases stay finite.
+                for (std::size_t i = 0; i < n; ++i) {
+                    const double dx = da[i] == 0.0 ? 0.0 : b[i] * std::pow(a[i], b[i] - 1.0) * da[i];
+                    d[i] = active & 2 ? dx + r[i] * std::log(a[i]) * db[i] : dx;
+                }
+                break;
+            case formula_op::min: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] <= b[i] ? da[i] : db[i]; break;
+            case formula_op::max: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] >= b[i] ? da[i] : db[i]; break;
+            case formula_op::neg: for (std::size_t i = 0; i < n; ++i) d[i] = -da[i]; break;
+            case formula_op::abs: for (std::size_t i = 0; i < n; ++i) d[i] = a[i] < 0.0 ? -da[i] : da[i]; break;
+            case formula_op::sqrt: for (std::size_t i = 0; i < n; ++i) d[i] = 0.5 * da[i] / r[i]; break;
+            case formula_op::exp: for (std::size_t i = 0; i < n; ++i) d[i] = r[i] * da[i]; break;
+            case formula_op::log: for (std::size_t i = 0; i < n; ++i) d[i] = da[i] / a[i]; break;
+        }
+    }
+
+    std::vector<std::string> parameters_;
+    std::map<std::string, std::vector<double>, std::less<>> derivatives_;
+};
+
+} // namespace numsim::propex
+
+#endif // PROPEX_SENSITIVITY_H
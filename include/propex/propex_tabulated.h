@@ -0,0 +1,280 @@
+/**
+ * @file propex_tabulated.h
+ * @brief Tabulated one-dimensional properties with precomputed search and interpolation.
+ *
+ * @details
+ * Temperature-dependent material data (`E(T)`, `alpha(T)`, ...) usually comes
+ * as a table of sample points. `tabulated` stores such a table in the form
+ * that is cheapest to evaluate:
+ *
+ *  - the interval search uses a **uniform grid** (one multiply) when the
+ *    abscissae are equidistant, and otherwise an **Eytzinger** layout
+ *    (branch-free, cache-friendly binary search of fixed depth),
+ *  - each interval keeps the coefficients of its local polynomial, so
+ *    **linear** and **cubic** (natural spline) interpolation share one
+ *    branch-free Horner kernel.
+ *
+ * Arguments outside the table are clamped to its range (the end values are
+ * held constant); a NaN argument evaluates like the lower bound.
+ *
+ * The batch overload `eval(xs, out)` hoists the search mode out of the loop
+ * and processes the Eytzinger searches in blocks so independent loads
+ * overlap; the loops are written without data-dependent branches so the
+ * compiler can vectorize them (with gathers when the target supports them).
+ *
+ * Stored in a node, the table is read through `property_view::eval()`:
+ *
+ * @code
+ * node<tabulated, ownership::by_shared> E(std::make_shared<tabulated>(
+ *     std::vector<double>{293., 473., 673.}, std::vector<double>{210e9, 195e9, 180e9},
+ *     interpolation::cubic));
+ * property_view<tabulated, node, ownership::by_shared> e(&E);
+ * double e0 = e.eval(300.0);
+ * e.eval(temperatures, youngs_moduli);   // one call for all quadrature points
+ * @endcode
+ */
+
+#ifndef PROPEX_TABULATED_H
+#define PROPEX_TABULATED_H
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace numsim::propex {
+
+/// Interpolation between the sample points of a `tabulated` property.
+enum class interpolation {
+    linear,  ///< Piecewise linear.
+    cubic,   ///< Natural cubic spline (C2, zero curvature at the ends).
+};
+
+/// Interval search used by a `tabulated` property.
+enum class table_search {
+    automatic,  ///< `uniform` if the abscissae are equidistant, `eytzinger` otherwise.
+    uniform,    ///< Index computed from the grid spacing (requires equidistant abscissae).
+    eytzinger,  ///< Branch-free search in an Eytzinger (BFS-ordered) tree.
+};
+
+/**
+ * @brief A function given by samples `(x_i, y_i)`, evaluated by interpolation.
+ *
+ * Immutable after construction and therefore safe to read from any number
+ * of threads.
+ *
+ * @throws std::invalid_argument from the constructor if fewer than two points
+ *         are given, the sizes differ, the abscissae are not strictly
+ *         increasing, or `table_search::uniform` is requested for a
+ *         non-equidistant table.
+ */
+class tabulated {
+public:
+    tabulated(std::span<const double> xs, std::span<const double> ys,
+              interpolation kind = interpolation::linear,
+              table_search search = table_search::automatic)
+        : kind_(kind) {
+        if (xs.size() != ys.size())
+            throw std::invalid_argument("tabulated: x and y sizes differ");
+        if (xs.size() < 2)
+            throw std::invalid_argument("tabulated: at least two points are required");
+        for (std::size_t i = 1; i < xs.size(); ++i)
+            if (!(xs[i] > xs[i - 1]))
+                throw std::invalid_argument("tabulated: abscissae must be strictly increasing");
+
+        lo_ = xs.front();
+        hi_ = xs.back();
+        build_segments(xs, ys);
+
+        const bool equidistant = is_equidistant(xs);
+        if (search == table_search::uniform && !equidistant)
+            throw std::invalid_argument("tabulated: uniform search requires equidistant abscissae");
+        search_ = (search == table_search::eytzinger || !equidistant) ? table_search::eytzinger
+                                                                        : table_search::uniform;
+        if (search_ == table_search::uniform)
+            inv_h_ = static_cast<double>(segments_.size()) / (hi_ - lo_);
+        else
+            build_eytzinger(xs);
+    }
+
+    /// Overload for braced lists and vectors.
+    tabulated(const std::vector<double>& xs, const std::vector<double>& ys,
+              interpolation kind = interpolation::linear,
+              table_search search = table_search::automatic)
+        : tabulated(std::span<const double>(xs), std::span<const double>(ys), kind, search) {}
+
+    /// Evaluates the table at @p x.
+    [[nodiscard]] double eval(double x) const noexcept {
+        x = clamp(x);
+        const std::size_t i = search_ == table_search::uniform ? uniform_index(x) : eytzinger_index(x);
+        return horner(segments_[i], x);
+    }
+
+    /**
+     * @brief Evaluates the table at every `xs[j]` and writes the result to `out[j]`.
+     * @throws std::invalid_argument if @p out is shorter than @p xs.
+     */
+    void eval(std::span<const double> xs, std::span<double> out) const {
+        if (out.size() < xs.size())
+            throw std::invalid_argument("tabulated: output span is shorter than input span");
+        if (search_ == table_search::uniform)
+            eval_uniform(xs, out);
+        else
+            eval_eytzinger(xs, out);
+    }
+
+    /// Number of sample points.
+    [[nodiscard]] std::size_t size() const noexcept { return segments_.size() + 1; }
+    /// Smallest abscissa.
+    [[nodiscard]] double lower() const noexcept { return lo_; }
+    /// Largest abscissa.
+    [[nodiscard]] double upper() const noexcept { return hi_; }
+    /// Interpolation between the points.
+    [[nodiscard]] interpolation kind() const noexcept { return kind_; }
+    /// Search actually used (`automatic` is resolved at construction).
+    [[nodiscard]] table_search search() const noexcept { return search_; }
+
+private:
+    /// Local polynomial `c0 + c1 u + c2 u^2 + c3 u^3` with `u = x - x0`.
+    struct segment {
+        double x0, c0, c1, c2, c3;
+    };
+
+    /// Eytzinger searches processed together by the batch overload.
+    static constexpr std::size_t block = 16;
+
+    [[nodiscard]] double clamp(double x) const noexcept {
+        x = x > lo_ ? x : lo_;  // also maps NaN to lo_
+        return x < hi_ ? x : hi_;
+    }
+
+    [[nodiscard]] static double horner(const segment& s, double x) noexcept {
+        const double u = x - s.x0;
+        return s.c0 + u * (s.c1 + u * (s.c2 + u * s.c3));
+    }
+
+    [[nodiscard]] std::size_t uniform_index(double x) const noexcept {
+        const auto i = static_cast<std::size_t>((x - lo_) * inv_h_);
+        const std::size_t last = segments_.size() - 1;
+        return i < last ? i : last;
+    }
+
+    /// Index of the interval containing @p x (already clamped).
+    [[nodiscard]] std::size_t eytzinger_index(double x) const noexcept {
+        std::size_t k = 1;
+        for (unsigned d = 0; d < depth_; ++d)
+            k = 2 * k + (tree_[k] <= x);
+        return rank_[k >> (std::countr_one(k) + 1)];
+    }
+
+    void eval_uniform(std::span<const double> xs, std::span<double> out) const noexcept {
+        const segment* seg = segments_.data();
+        for (std::size_t j = 0; j < xs.size(); ++j) {
+            const double x = clamp(xs[j]);
+            out[j] = horner(seg[uniform_index(x)], x);
+        }
+    }
+
+    void eval_eytzinger(std::span<const double> xs, std::span<double> out) const noexcept {
+        const double* tree = tree_.data();
+        std::size_t j = 0;
+        for (; j + block <= xs.size(); j += block) {
+            double x[block];
+            std::size_t k[block];
+            for (std::size_t b = 0; b < block; ++b) {
+                x[b] = clamp(xs[j + b]);
+                k[b] = 1;
+            }
+            // Level by level: the block's loads are independent and overlap.
+            for (unsigned d = 0; d < depth_; ++d)
+                for (std::size_t b = 0; b < block; ++b)
+                    k[b] = 2 * k[b] + (tree[k[b]] <= x[b]);
+            for (std::size_t b = 0; b < block; ++b)
+                out[j + b] = horner(segments_[rank_[k[b] >> (std::countr_one(k[b]) + 1)]], x[b]);
+        }
+        for (; j < xs.size(); ++j) out[j] = eval(xs[j]);
+    }
+
+    [[nodiscard]] static bool is_equidistant(std::span<const double> xs) noexcept {
+        const std::size_t m = xs.size() - 1;
+        const double h = (xs.back() - xs.front()) / static_cast<double>(m);
+        const double tol = 1e-9 * (xs.back() - xs.front());
+        for (std::size_t i = 1; i < m; ++i)
+            if (std::abs(xs[i] - (xs.front() + static_cast<double>(i) * h)) > tol) return false;
+        return true;
+    }
+
+    void build_segments(std::span<const double> xs, std::span<const double> ys) {
+        const std::size_t m = xs.size() - 1;
+        // Second derivatives of the natural spline (all zero for linear).
+        std::vector<double> M(xs.size(), 0.0);
+        if (kind_ == interpolation::cubic && m >= 2) {
+            // Thomas algorithm for the interior equations
+            // h_{i-1} M_{i-1} + 2 (h_{i-1} + h_i) M_i + h_i M_{i+1} = 6 (s_i - s_{i-1}).
+            std::vector<double> diag(m), rhs(m);
+            for (std::size_t i = 1; i < m; ++i) {
+                const double h0 = xs[i] - xs[i - 1], h1 = xs[i + 1] - xs[i];
+                diag[i] = 2.0 * (h0 + h1);
+                rhs[i] = 6.0 * ((ys[i + 1] - ys[i]) / h1 - (ys[i] - ys[i - 1]) / h0);
+                if (i > 1) {
+                    const double w = h0 / diag[i - 1];
+                    diag[i] -= w * h0;
+                    rhs[i] -= w * rhs[i - 1];
+                }
+            }
+            for (std::size_t i = m - 1; i >= 1; --i)
+                M[i] = (rhs[i] - (xs[i + 1] - xs[i]) * M[i + 1]) / diag[i];
+        }
+
+        segments_.resize(m);
+        for (std::size_t i = 0; i < m; ++i) {
+            const double h = xs[i + 1] - xs[i];
+            segments_[i] = {xs[i],
+                            ys[i],
+                            (ys[i + 1] - ys[i]) / h - h * (2.0 * M[i] + M[i + 1]) / 6.0,
+                            M[i] / 2.0,
+                            (M[i + 1] - M[i]) / (6.0 * h)};
+        }
+    }
+
+    /// Lays out the interior abscissae as a complete BFS-ordered tree padded with +inf.
+    void build_eytzinger(std::span<const double> xs) {
+        const std::size_t interior = xs.size() - 2;
+        depth_ = static_cast<unsigned>(std::bit_width(interior));
+        const std::size_t nodes = (std::size_t{1} << depth_) - 1;
+        tree_.assign(nodes + 1, std::numeric_limits<double>::infinity());
+        rank_.assign(nodes + 1, interior);  // slot 0 and padding: every interior point is <= x
+
+        std::size_t next = 0;
+        fill(1, nodes, xs.subspan(1, interior), next);
+    }
+
+    /// In-order traversal assigns the sorted values (and their ranks) to tree slots.
+    void fill(std::size_t k, std::size_t nodes, std::span<const double> sorted, std::size_t& next) {
+        if (k > nodes) return;
+        fill(2 * k, nodes, sorted, next);
+        if (next < sorted.size()) {
+            tree_[k] = sorted[next];
+            rank_[k] = next;
+        }
+        ++next;
+        fill(2 * k + 1, nodes, sorted, next);
+    }
+
+    interpolation kind_;
+    table_search search_{table_search::eytzinger};
+    double lo_{}, hi_{};
+    double inv_h_{};
+    std::vector<segment> segments_;
+    unsigned depth_{};
+    std::vector<double> tree_;
+    std::vector<std::size_t> rank_;
+};
+
+} // namespace numsim::propex
+
+#endif // PROPEX_TABULATED_H
@@ -0,0 +1,264 @@
+/**
+ * @file propex_trace.h
+ * @brief Compile-time switchable tracing hooks for registries and property views.
+ *
+ * @details
+ * With `PROPEX_ENABLE_TRACING` defined, the registry (`add`, `find`, `at`,
+ * `erase`) and `property_view` (bind, `get`, `set`) emit timed trace events,
+ * and `PROPEX_TRACE_PHASE(name)` marks user-defined phases such as checkpoint
+ * write/read or solver stages. Without the macro all hooks expand to
+ * `((void)0)` and nothing in this header is compiled.
+ *
+ * Events are delivered to a backend type selected by `PROPEX_TRACE_BACKEND`
+ * (default: `numsim::propex::tracing::chrome_trace`). A backend provides
+ *
+ *  - `static std::uint64_t now() noexcept` — a timestamp in nanoseconds,
+ *  - `static void complete(const char* category, const char* name,
+ *                          std::uint64_t begin, std::uint64_t end) noexcept`,
+ *  - `static void instant(const char* category, const char* name) noexcept`.
+ *
+ * Category and name must be string literals (or otherwise outlive the trace).
+ *
+ * The built-in `chrome_trace` backend appends events to per-thread buffers and
+ * writes them as Chrome trace-event JSON, viewable in `chrome://tracing` or
+ * Perfetto.
+ *
+ * ### Example
+ * @code
+ * #define PROPEX_ENABLE_TRACING
+ * #include "propex/propex_registry.h"
+ *
+ * {
+ *     PROPEX_TRACE_PHASE("checkpoint:write");
+ *     write_checkpoint(reg);
+ * }
+ * tracing::chrome_trace::write("propex_trace.json");
+ * @endcode
+ */
+
+#ifndef PROPEX_TRACE_H
+#define PROPEX_TRACE_H
+
+#if defined(PROPEX_ENABLE_TRACING)
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace numsim::propex::tracing {
+
+/**
+ * @brief Backend writing Chrome trace-event JSON from per-thread buffers.
+ *
+ * Each thread appends to its own buffer (guarded by a mutex that is only
+ * contended while the trace is written), buffers outlive their threads, and
+ * `write()` merges them into one `{"traceEvents": [...]}` document.
+ */
+class chrome_trace {
+public:
+    /// Nanoseconds since the first use of the backend.
+    [[nodiscard]] static std::uint64_t now() noexcept {
+        static const auto epoch = std::chrono::steady_clock::now();
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    /// Records a complete (`"ph":"X"`) event.
+    static void complete(const char* category, const char* name,
+                         std::uint64_t begin, std::uint64_t end) noexcept {
+        push({category, name, begin, end - begin, 'X'});
+    }
+
+    /// Records an instant (`"ph":"i"`) event.
+    static void instant(const char* category, const char* name) noexcept {
+        push({category, name, now(), 0, 'i'});
+    }
+
+    /// Writes all events recorded so far as Chrome trace-event JSON.
+    static void write(std::ostream& os) {
+        auto& s = state::instance();
+        std::lock_guard lock(s.mutex);
+        os << "{\"traceEvents\":[";
+        bool first = true;
+        for (const auto& buffer : s.buffers) {
+            std::lock_guard buffer_lock(buffer->mutex);
+            for (const auto& e : buffer->events) {
+                os << (first ? "\n" : ",\n");
+                first = false;
+                os << "{\"cat\":";
+                write_string(os, e.category);
+                os << ",\"name\":";
+                write_string(os, e.name);
+                os << ",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << buffer->tid
+                   << ",\"ts\":" << micros(e.begin);
+                if (e.phase == 'X') os << ",\"dur\":" << micros(e.duration);
+                else os << ",\"s\":\"t\"";
+                os << '}';
+            }
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    /// Writes the trace to the file at @p path.
+    /// @throws std::runtime_error if the file cannot be written.
+    static void write(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error("chrome_trace::write(): cannot open '" + path + "'");
+        write(out);
+    }
+
+    /// Discards all recorded events.
+    static void clear() {
+        auto& s = state::instance();
+        std::lock_guard lock(s.mutex);
+        for (const auto& buffer : s.buffers) {
+            std::lock_guard buffer_lock(buffer->mutex);
+            buffer->events.clear();
+        }
+    }
+
+private:
+    struct event {
+        const char* category;
+        const char* name;
+        std::uint64_t begin;
+        std::uint64_t duration;
+        char phase;
+    };
+
+    struct buffer {
+        std::mutex mutex;
+        std::vector<event> events;
+        std::size_t tid{};
+    };
+
+    struct state {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<buffer>> buffers;
+
+        static state& instance() {
+            static state s;
+            return s;
+        }
+    };
+
+    static buffer& local_buffer() {
+        thread_local std::shared_ptr<buffer> b = [] {
+            auto nb = std::make_shared<buffer>();
+            auto& s = state::instance();
+            std::lock_guard lock(s.mutex);
+            nb->tid = s.buffers.size() + 1;
+            s.buffers.push_back(nb);
+            return nb;
+        }();
+        return *b;
+    }
+
+    static void push(const event& e) noexcept {
+        try {
+            auto& b = local_buffer();
+            std::lock_guard lock(b.mutex);
+            b.events.push_back(e);
+        } catch (...) {
+            // Tracing must never change program behavior; drop the event.
+        }
+    }
+
+    /// Writes @p s as a quoted JSON string, escaping quotes, backslashes and control characters.
+    static void write_string(std::ostream& os, const char* s) {
+        static constexpr char hex[] = "0123456789abcdef";
+        os << '"';
+        for (; *s; ++s) {
+            const auto c = static_cast<unsigned char>(*s);
+            switch (c) {
+                case '"': os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                case '\n': os << "\\n"; break;
+                case '\r': os << "\\r"; break;
+                case '\t': os << "\\t"; break;
+                default:
+                    if (c < 0x20) os << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+                    else os << *s;
+            }
+        }
+        os << '"';
+    }
+
+    /// Chrome expects microseconds; keep nanosecond resolution as decimals.
+    static std::string micros(std::uint64_t ns) {
+        auto frac = std::to_string(ns % 1000);
+        return std::to_string(ns / 1000) + '.' + std::string(3 - frac.size(), '0') + frac;
+    }
+};
+
+/**
+ * @brief RAII scope emitting one complete event through @p Backend.
+ *
+ * A literal type, so it may be declared inside the library's `constexpr`
+ * functions; nothing is recorded during constant evaluation.
+ */
+template <class Backend>
+class trace_scope {
+public:
+    constexpr trace_scope(const char* category, const char* name) noexcept
+        : category_(category), name_(name) {
+        if (!std::is_constant_evaluated()) begin_ = Backend::now();
+    }
+
+    constexpr ~trace_scope() {
+        if (!std::is_constant_evaluated()) Backend::complete(category_, name_, begin_, Backend::now());
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+private:
+    const char* category_;
+    const char* name_;
+    std::uint64_t begin_{};
+};
+
+/// Emits one instant event through @p Backend.
+template <class Backend>
+constexpr inline void trace_instant(const char* category, const char* name) noexcept {
+    if (!std::is_constant_evaluated()) Backend::instant(category, name);
+}
+
+} // namespace numsim::propex::tracing
+
+#ifndef PROPEX_TRACE_BACKEND
+#define PROPEX_TRACE_BACKEND ::numsim::propex::tracing::chrome_trace
+#endif
+
+#define PROPEX_TRACE_CONCAT_IMPL(a, b) a##b
+#define PROPEX_TRACE_CONCAT(a, b) PROPEX_TRACE_CONCAT_IMPL(a, b)
+
+/// Times the enclosing scope as one event.
+#define PROPEX_TRACE_SCOPE(category, name) \
+    ::numsim::propex::tracing::trace_scope<PROPEX_TRACE_BACKEND> \
+        PROPEX_TRACE_CONCAT(propex_trace_scope_, __LINE__){category, name}
+
+/// Emits a zero-duration event.
+#define PROPEX_TRACE_INSTANT(category, name) \
+    ::numsim::propex::tracing::trace_instant<PROPEX_TRACE_BACKEND>(category, name)
+
+/// Times the enclosing scope as a user-defined phase (checkpointing, solver stages, ...).
+#define PROPEX_TRACE_PHASE(name) PROPEX_TRACE_SCOPE("phase", name)
+
+#else
+
+#define PROPEX_TRACE_SCOPE(category, name) ((void)0)
+#define PROPEX_TRACE_INSTANT(category, name) ((void)0)
+#define PROPEX_TRACE_PHASE(name) ((void)0)
+
+#endif // PROPEX_ENABLE_TRACING
+
+#endif // PROPEX_TRACE_H
@@ -0,0 +1,290 @@
+#ifndef ASYNC_TEST_H
+#define ASYNC_TEST_H
+
+#include <gtest/gtest.h>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_async.h"
+#include "propex/propex_formula.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+
+using namespace numsim::propex;
+
+namespace {
+detached_task wait_for_change(registry<std::string, node_base>& reg, manual_scheduler& loop,
+                              std::vector<std::uint64_t>& seen) {
+    seen.push_back(co_await reg.changed("fluid:p", loop));
+}
+
+detached_task wait_until_positive(property_view<int, node, ownership::by_atomic>& v, int& result) {
+    co_await v.until([](int x) { return x > 0; });
+    result = v.get();
+}
+
+detached_task wait_then_catch(const node_base& n, bool& threw) {
+    try {
+        co_await change_awaitable(n);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+}
+} // namespace
+
+TEST(Async, SettersBumpTheVersion) {
+    node<double> d(1.0);
+    EXPECT_EQ(d.version(), 0u);
+    d.set(2.0);
+    d.set(2.0);
+    EXPECT_EQ(d.version(), 2u);
+
+    node<std::vector<double>, ownership::by_spinlock> f(std::vector<double>(4));
+    f.set_from([](std::vector<double>& v) { v[0] = 1; });
+    f.store(1, std::vector<double>{2.0});
+    f.with_lock([](std::vector<double>& v) { v[2] = 3; });
+    std::as_const(f).with_lock([](const std::vector<double>&) {});  // reads do not count
+    EXPECT_EQ(f.version(), 3u);
+
+    node<std::vector<double>> g(std::vector<double>(4));
+    property_view<std::vector<double>, node> view(&g);
+    view[0] = 1.0;
+    EXPECT_EQ(g.version(), 0u);
+    view.mark_changed();
+    EXPECT_EQ(g.version(), 1u);
+}
+
+TEST(Async, ChangedResumesOnTheScheduler) {
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<node<double>>(1.0), "fluid", "p");
+    manual_scheduler loop;
+    std::vector<std::uint64_t> seen;
+
+    wait_for_change(reg, loop, seen);
+    wait_for_change(reg, loop, seen);
+    EXPECT_EQ(reg.at("fluid:p").waiters(), 2u);
+    EXPECT_EQ(loop.run(), 0u);
+
+    static_cast<node<double>&>(reg.at("fluid:p")).set(2.0);
+    EXPECT_EQ(reg.at("fluid:p").waiters(), 0u);
+    EXPECT_TRUE(seen.empty());  // queued, not resumed inline
+    EXPECT_EQ(loop.pending(), 2u);
+    EXPECT_EQ(loop.run(), 2u);
+    EXPECT_EQ(seen, (std::vector<std::uint64_t>{1, 1}));
+}
+
+TEST(Async, UntilChecksThePredicateAfterEachChange) {
+    node<int, ownership::by_atomic> n(-5);
+    property_view<int, node, ownership::by_atomic> v(&n);
+    int result = 0;
+
+    wait_until_positive(v, result);
+    v.set(-1);  // wakes, predicate false: waits again
+    EXPECT_EQ(result, 0);
+    EXPECT_EQ(n.waiters(), 1u);
+    v.set(7);
+    EXPECT_EQ(result, 7);
+    EXPECT_EQ(n.waiters(), 0u);
+
+    int ready = 0;
+    wait_until_positive(v, ready);  // already true: no suspension
+    EXPECT_EQ(ready, 7);
+}
+
+TEST(Async, UntilRethrowsWhatThePredicateThrowsOnWake) {
+    node<int, ownership::by_atomic> n(0);
+    property_view<int, node, ownership::by_atomic> v(&n);
+    bool threw = false;
+    const auto waiter = [&]() -> detached_task {
+        try {
+            co_await v.until([](int x) {
+                if (x < 0) throw std::domain_error("negative");
+                return x > 10;
+            });
+        } catch (const std::domain_error&) {
+            threw = true;
+        }
+    };
+    waiter();
+    EXPECT_FALSE(threw);
+    v.set(-1);  // the predicate throws on this thread; the coroutine sees it
+    EXPECT_TRUE(threw);
+    EXPECT_EQ(n.waiters(), 0u);
+}
+
+TEST(Async, SubscriptionsRacingWithPlainWritesAreNotLost) {
+    node<int> n(0);
+    std::vector<std::unique_ptr<change_awaitable<>>> waits;
+    std::thread writer([&] {
+        for (int i = 1; i <= 100000; ++i) n.set(i);
+    });
+    for (int i = 0; i < 2000; ++i) {
+        waits.push_back(std::make_unique<change_awaitable<>>(n));
+        (void)waits.back()->await_suspend(std::noop_coroutine());
+    }
+    writer.join();
+    n.set(0);  // wakes whoever is still registered
+    EXPECT_EQ(n.waiters(), 0u);
+}
+
+TEST(Async, ThousandsOfWaitsCostNoThreads) {
+    node<std::uint64_t, ownership::by_atomic> n(0);
+    property_view<std::uint64_t, node, ownership::by_atomic> v(&n);
+    manual_scheduler loop;
+    std::size_t done = 0;
+    const auto waiter = [&](std::uint64_t threshold) -> detached_task {
+        co_await v.until([threshold](std::uint64_t x) { return x >= threshold; }, loop);
+        ++done;
+    };
+    for (std::uint64_t i = 1; i <= 5000; ++i) waiter(i % 10 + 1);
+    EXPECT_EQ(n.waiters(), 5000u);
+
+    std::thread producer([&] {
+        for (std::uint64_t x = 1; x <= 10; ++x) v.set(x);
+    });
+    producer.join();
+    EXPECT_EQ(loop.run(), 5000u);
+    EXPECT_EQ(done, 5000u);
+    EXPECT_EQ(n.waiters(), 0u);
+}
+
+TEST(Async, FormulaTargetsPublishOnceWhenComplete) {
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<node<double>>(210e3), "mat", "E");
+    reg.add(std::make_unique<node<double>>(0.0), "mat", "G");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(1000, 1.0)), "f", "x");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(1000, 0.0)), "f", "y");
+
+    double shear = 0.0;
+    double sum = 0.0;
+    const auto on_shear = [&]() -> detached_task {
+        co_await reg.changed("mat:G");
+        shear = static_cast<node<double>&>(reg.at("mat:G")).get();
+    };
+    const auto on_field = [&]() -> detached_task {
+        co_await reg.changed("f:y");  // resumed inline, inside apply()
+        const auto& y = static_cast<node<std::vector<double>>&>(reg.at("f:y")).get();
+        sum = std::accumulate(y.begin(), y.end(), 0.0);
+    };
+    on_shear();
+    on_field();
+
+    compile_formula(reg, "mat:G = mat:E / 2.6").apply();
+    EXPECT_DOUBLE_EQ(shear, 210e3 / 2.6);
+    compile_formula(reg, "f:y = 2 * f:x").apply();  // several batches
+    EXPECT_DOUBLE_EQ(sum, 2000.0);
+    EXPECT_EQ(reg.at("f:y").version(), 1u);
+}
+
+TEST(Async, WaitersFollowRelocatedNodes) {
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<node<double>>(0.0), "a");
+    manual_scheduler loop;
+    bool resumed = false;
+    const auto waiter = [&]() -> detached_task {
+        co_await reg.changed("a", loop);
+        resumed = true;
+    };
+    waiter();
+
+    reg.compact(compact_mode::relocate_nodes);
+    static_cast<node<double>&>(reg.at("a")).set(1.0);
+    loop.run();
+    EXPECT_TRUE(resumed);
+}
+
+TEST(Async, WaitersFollowNodesRecreatedByRelocation) {
+    // Neither policy is movable: relocation re-creates the nodes from their values.
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<node<int, ownership::by_atomic>>(0), "a", "x");
+    reg.add(std::make_unique<node<int, ownership::by_spinlock>>(0), "a", "y");
+    for (int i = 1; i <= 3; ++i) {
+        static_cast<node<int, ownership::by_atomic>&>(reg.at("a:x")).set(i);
+        static_cast<node<int, ownership::by_spinlock>&>(reg.at("a:y")).set(i);
+    }
+    manual_scheduler loop;
+    std::vector<std::uint64_t> seen;
+    const auto waiter = [&](const char* key) -> detached_task {
+        seen.push_back(co_await reg.changed(key, loop));
+    };
+    waiter("a:x");
+    waiter("a:y");
+
+    ASSERT_EQ(reg.compact(compact_mode::relocate_nodes).relocated_nodes, 2u);
+    auto& x = static_cast<node<int, ownership::by_atomic>&>(reg.at("a:x"));
+    auto& y = static_cast<node<int, ownership::by_spinlock>&>(reg.at("a:y"));
+    EXPECT_EQ(x.get(), 3);
+    EXPECT_EQ(x.version(), 3u);
+    EXPECT_EQ(y.version(), 3u);
+    EXPECT_EQ(x.waiters(), 1u);
+    EXPECT_EQ(y.waiters(), 1u);
+
+    x.set(4);
+    y.set(4);
+    loop.run();
+    EXPECT_EQ(seen, (std::vector<std::uint64_t>{4, 4}));
+}
+
+TEST(Async, RelocationRebindsSuspendedAwaitables) {
+    auto p = std::make_unique<node<int>>(0);
+    manual_scheduler loop;
+    int seen = 0;
+    const auto waiter = [&]() -> detached_task {
+        co_await until_awaitable(*p, [](int x) { return x > 1; }, loop);
+        seen = p->get();
+    };
+    waiter();
+    {
+        change_awaitable<> cancelled(*p);
+        EXPECT_TRUE(cancelled.await_suspend(std::noop_coroutine()));
+        ASSERT_TRUE(node_relocator<std::unique_ptr<node<int>>>::relocate(p));  // frees the old node
+        EXPECT_EQ(p->waiters(), 2u);
+    }
+    EXPECT_EQ(p->waiters(), 1u);  // unregistered from the relocated node
+
+    p->set(1);  // the predicate reads the relocated node
+    EXPECT_EQ(p->waiters(), 1u);
+    p->set(2);
+    loop.run();
+    EXPECT_EQ(seen, 2);
+    EXPECT_EQ(p->waiters(), 0u);
+}
+
+TEST(Async, DestroyedNodesAndCancelledWaits) {
+    bool threw = false;
+    {
+        auto n = std::make_unique<node<double>>(0.0);
+        wait_then_catch(*n, threw);
+        EXPECT_FALSE(threw);
+    }
+    EXPECT_TRUE(threw);
+
+    // An awaitable destroyed while registered unregisters itself.
+    node<double> n(0.0);
+    {
+        change_awaitable<> wait(n);
+        EXPECT_TRUE(wait.await_suspend(std::noop_coroutine()));
+        EXPECT_EQ(n.waiters(), 1u);
+    }
+    EXPECT_EQ(n.waiters(), 0u);
+    n.set(1.0);
+
+    // Changed between construction and suspension: not suspended.
+    change_awaitable<> late(n);
+    n.set(2.0);
+    EXPECT_TRUE(late.await_ready());
+    EXPECT_FALSE(late.await_suspend(std::noop_coroutine()));
+    EXPECT_EQ(late.await_resume(), 2u);
+}
+
+#endif // ASYNC_TEST_H
@@ -0,0 +1,215 @@
+#ifndef COLD_TEST_H
+#define COLD_TEST_H
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "propex/property_view.h"
+#include "propex/propex_codec.h"
+#include "propex/propex_cold.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+
+using namespace numsim::propex;
+
+namespace {
+std::vector<std::byte> round_trip(const std::vector<std::byte>& in) {
+    const auto block = codec::compress(in);
+    EXPECT_LE(block.size(), codec::compress_bound(in.size()));
+    std::vector<std::byte> out(in.size());
+    codec::decompress(block, out);
+    return out;
+}
+
+std::vector<std::byte> bytes_of(const std::string& s) {
+    const auto b = std::as_bytes(std::span<const char>(s.data(), s.size()));
+    return {b.begin(), b.end()};
+}
+
+/// Metadata-like text: repetitive, compresses well.
+std::string metadata(std::size_t entries) {
+    std::string s = "{";
+    for (std::size_t i = 0; i < entries; ++i)
+        s += "\"material_" + std::to_string(i % 7) + "\": {\"model\": \"neo_hooke\", \"density\": 7850},";
+    return s + "}";
+}
+
+template <class T>
+using cold_node = node<T, ownership::by_compressed>;
+
+/// Allocator tag selecting the failing codec below.
+template <class T>
+struct fragile_allocator : std::allocator<T> {
+    fragile_allocator() = default;
+    template <class U>
+    fragile_allocator(const fragile_allocator<U>&) noexcept {}
+};
+using fragile_field = std::vector<double, fragile_allocator<double>>;
+bool fragile_restore_fails = false;
+} // namespace
+
+/// Codec whose restore fails on demand, as on a corrupt block.
+template <>
+struct numsim::propex::cold_codec<fragile_field> {
+    static std::span<const std::byte> bytes(const fragile_field& v) noexcept {
+        return std::as_bytes(std::span<const double>(v));
+    }
+    static fragile_field restore(std::span<const std::byte> block, std::size_t raw_size) {
+        if (fragile_restore_fails) throw std::runtime_error("corrupt block");
+        fragile_field v(raw_size / sizeof(double));
+        codec::decompress(block, std::as_writable_bytes(std::span<double>(v)));
+        return v;
+    }
+};
+
+TEST(Codec, RoundTripsTypicalInputs) {
+    std::mt19937 gen(7);
+    std::vector<std::byte> noise(10000);
+    for (auto& b : noise) b = static_cast<std::byte>(gen());
+
+    std::vector<std::byte> runs(200000);
+    for (std::size_t i = 0; i < runs.size(); ++i) runs[i] = static_cast<std::byte>((i / 1000) % 3);
+
+    for (const auto& input : {std::vector<std::byte>{}, bytes_of("a"), bytes_of("abcabcabcabcabcabc"),
+                              bytes_of(metadata(500)), noise, runs, std::vector<std::byte>(70000)})
+        EXPECT_EQ(round_trip(input), input);
+}
+
+TEST(Codec, CompressesRedundantData) {
+    const auto text = bytes_of(metadata(500));
+    EXPECT_LT(codec::compress(text).size(), text.size() / 10);
+    const std::vector<std::byte> zeros(1 << 20);
+    EXPECT_LT(codec::compress(zeros).size(), zeros.size() / 200);
+}
+
+TEST(Codec, RejectsCorruptBlocks) {
+    const auto text = bytes_of(metadata(20));
+    auto block = codec::compress(text);
+    std::vector<std::byte> out(text.size());
+
+    EXPECT_THROW(codec::decompress(std::span(block).first(block.size() / 2), out), std::runtime_error);
+    std::vector<std::byte> too_small(text.size() - 1);
+    EXPECT_THROW(codec::decompress(block, too_small), std::runtime_error);
+    EXPECT_THROW(codec::decompress({}, out), std::runtime_error);
+}
+
+TEST(ByCompressed, CompressesAfterOneIdleSweep) {
+    // Copied, so the capacity equals the size, as after decompression.
+    const std::string text = metadata(200);
+    cold_node<std::string> n(text);
+    const auto hot_bytes = n.payload_bytes();
+
+    EXPECT_EQ(n.compress_cold().compressed, 0u);  // new values survive the first sweep
+    const auto stats = n.compress_cold();
+    EXPECT_EQ(stats.compressed, 1u);
+    EXPECT_EQ(stats.bytes_before, hot_bytes);
+    EXPECT_EQ(stats.bytes_after, n.payload_bytes());
+    EXPECT_LT(n.payload_bytes(), hot_bytes / 5);
+
+    EXPECT_EQ(n.get(), metadata(200));  // transparent decompression
+    EXPECT_EQ(n.payload_bytes(), hot_bytes);
+}
+
+TEST(ByCompressed, DecompressionErrorsReachTheCaller) {
+    cold_node<fragile_field> n(fragile_field(4096, 1.0));
+    property_view<fragile_field, node, ownership::by_compressed> v(&n);
+    static_assert(!noexcept(v.get()));
+    (void)n.compress_cold();
+    ASSERT_EQ(n.compress_cold().compressed, 1u);
+
+    fragile_restore_fails = true;
+    EXPECT_THROW((void)v.get(), std::runtime_error);
+    EXPECT_THROW((void)v.get_checked(), std::runtime_error);
+    const element_ops* elements = n.elements();
+    ASSERT_NE(elements, nullptr);
+    EXPECT_EQ(elements->data(n), nullptr);  // formulas fall back to load(), which reports it
+    std::array<double, 4> out{};
+    EXPECT_THROW(elements->load(n, 0, out.data(), out.size()), std::runtime_error);
+
+    fragile_restore_fails = false;
+    EXPECT_NE(elements->data(n), nullptr);
+    EXPECT_EQ(v.get()[4095], 1.0);
+}
+
+TEST(ByCompressed, AccessesKeepNodesHot) {
+    cold_node<std::vector<double>> n(std::vector<double>(4096, 293.15));
+    for (int sweep = 0; sweep < 5; ++sweep) {
+        (void)n.get();
+        EXPECT_EQ(n.compress_cold().compressed, 0u);
+    }
+    EXPECT_EQ(n.compress_cold().compressed, 1u);
+    EXPECT_EQ(n.get(), std::vector<double>(4096, 293.15));
+}
+
+TEST(ByCompressed, SetReplacesCompressedValue) {
+    cold_node<std::vector<int>> n(std::vector<int>(1000, 1));
+    n.compress_cold();
+    ASSERT_EQ(n.compress_cold().compressed, 1u);
+    n.set(std::vector<int>{1, 2, 3});
+    EXPECT_EQ(n.get(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(ByCompressed, IncompressibleValuesStayUncompressed) {
+    std::mt19937_64 gen(3);
+    std::vector<std::uint64_t> noise(512);
+    for (auto& v : noise) v = gen();
+    cold_node<std::vector<std::uint64_t>> n(noise);
+    n.compress_cold();
+    EXPECT_EQ(n.compress_cold().compressed, 0u);
+    EXPECT_EQ(n.get(), noise);
+}
+
+TEST(ByCompressed, TriviallyCopyableValues) {
+    std::array<double, 256> initial{};
+    initial.fill(1.0);
+    cold_node<std::array<double, 256>> n(initial);
+    n.compress_cold();
+    EXPECT_EQ(n.compress_cold().compressed, 1u);
+    property_view<std::array<double, 256>, node, ownership::by_compressed> v(&n);
+    EXPECT_EQ(v.get(), initial);
+}
+
+TEST(ByCompressed, ConcurrentFirstReadsDecompressOnce) {
+    cold_node<std::string> n(metadata(1000));
+    n.compress_cold();
+    ASSERT_EQ(n.compress_cold().compressed, 1u);
+
+    const std::string expected = metadata(1000);
+    std::vector<std::thread> readers;
+    std::vector<const std::string*> seen(4);
+    for (std::size_t t = 0; t < seen.size(); ++t)
+        readers.emplace_back([&, t] { seen[t] = &n.get(); });
+    for (auto& r : readers) r.join();
+    for (const auto* p : seen) {
+        EXPECT_EQ(p, seen[0]);
+        EXPECT_EQ(*p, expected);
+    }
+}
+
+TEST(ByCompressed, RegistrySweepReportsSavedMemory) {
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<cold_node<std::string>>(metadata(300)), "run", "metadata");
+    reg.add(std::make_unique<cold_node<std::vector<double>>>(std::vector<double>(10000, 0.0)), "field", "u0");
+    reg.add(std::make_unique<node<double>>(1.0), "mat", "E");
+
+    EXPECT_EQ(compress_cold(reg).compressed, 0u);
+    (void)static_cast<cold_node<std::string>*>(reg.find("run:metadata"))->get();
+
+    const cold_stats first = compress_cold(reg);
+    EXPECT_EQ(first.compressed, 1u);  // metadata was read in between
+    EXPECT_GT(first.saved(), 70000u);
+
+    const cold_stats second = compress_cold(reg);
+    EXPECT_EQ(second.compressed, 1u);
+    EXPECT_GT(second.saved(), second.bytes_after);
+}
+
+#endif // COLD_TEST_H
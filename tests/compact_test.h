@@ -0,0 +1,120 @@
+#ifndef COMPACT_TEST_H
+#define COMPACT_TEST_H
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "propex/property_view.h"
+#include "propex/propex_node.h"
+#include "propex/propex_pmr.h"
+#include "propex/propex_registry.h"
+
+using namespace numsim::propex;
+
+namespace {
+
+/// Adds `n` properties and erases all but every `keep`-th one.
+template <class Reg, class Make>
+void churn(Reg& reg, int n, int keep, Make make) {
+    for (int i = 0; i < n; ++i) reg.add(make(i), "elem" + std::to_string(i), "u");
+    for (int i = 0; i < n; ++i)
+        if (i % keep != 0) reg.erase(typename Reg::key_type("elem" + std::to_string(i) + ":u", reg.get_allocator()));
+}
+
+} // namespace
+
+TEST(RegistryCompact, IndexModeKeepsNodesAndViews) {
+    registry<std::string, node<double>> reg;
+    churn(reg, 4096, 64, [](int i) { return std::make_unique<node<double>>(double(i)); });
+
+    auto* before = reg.find("elem64:u");
+    property_view<double, node> view(before);
+
+    const auto result = reg.compact();
+    EXPECT_EQ(result.entries, 64u);
+    EXPECT_LT(result.buckets_after, result.buckets_before);
+    EXPECT_EQ(result.relocated_nodes, 0u);
+    EXPECT_EQ(reg.generation(), 0u);
+
+    EXPECT_EQ(reg.find("elem64:u"), before);
+    EXPECT_EQ(view.get(), 64.0);
+    EXPECT_EQ(reg.data().size(), 64u);
+}
+
+TEST(RegistryCompact, RelocationMovesNodesAndBumpsGeneration) {
+    registry<std::string, node_base> reg;
+    churn(reg, 256, 4, [](int i) { return std::make_unique<node<double>>(double(i)); });
+    reg.add(std::make_unique<node<int, ownership::by_atomic>>(7), "counter");
+
+    std::map<std::string, const node_base*> before;
+    for (const auto& [key, ptr] : reg.data()) before[key] = ptr.get();
+
+    const auto result = reg.compact(compact_mode::relocate_nodes);
+    EXPECT_EQ(result.relocated_nodes, reg.data().size());
+    EXPECT_EQ(reg.generation(), 1u);
+
+    for (const auto& [key, old] : before) {
+        const auto* n = reg.find(key);
+        ASSERT_NE(n, nullptr);
+        EXPECT_NE(n, old);
+    }
+    // Views are re-bound after a generation change.
+    property_view<double, node> view(dynamic_cast<node<double>*>(reg.find("elem12:u")));
+    EXPECT_EQ(view.get(), 12.0);
+    auto& counter = dynamic_cast<node<int, ownership::by_atomic>&>(reg.at("counter"));
+    EXPECT_EQ(counter.get(), 7);
+}
+
+TEST(RegistryCompact, SharedOwnershipIsNeverRelocated) {
+    registry<std::string, node<double>, std::shared_ptr> reg;
+    churn(reg, 64, 2, [](int i) { return std::make_shared<node<double>>(double(i)); });
+    auto* before = reg.find("elem2:u");
+
+    const auto result = reg.compact(compact_mode::relocate_nodes);
+    EXPECT_EQ(result.relocated_nodes, 0u);
+    EXPECT_EQ(reg.generation(), 0u);
+    EXPECT_EQ(reg.find("elem2:u"), before);
+}
+
+TEST(RegistryCompact, OrderedMapKeepsKeyOrder) {
+    registry<std::string, node<int>, std::unique_ptr, std::map> reg;
+    churn(reg, 100, 3, [](int i) { return std::make_unique<node<int>>(i); });
+    const auto keys_before = [&] {
+        std::vector<std::string> k;
+        for (const auto& e : reg.data()) k.push_back(e.first);
+        return k;
+    }();
+
+    reg.compact(compact_mode::relocate_nodes);
+    std::vector<std::string> keys_after;
+    for (const auto& [key, ptr] : reg.data()) {
+        keys_after.push_back(key);
+        EXPECT_EQ("elem" + std::to_string(ptr->get()) + ":u", key);
+    }
+    EXPECT_EQ(keys_after, keys_before);
+}
+
+TEST(RegistryCompact, ArenaNodesEndUpContiguousInKeyOrder) {
+    std::pmr::monotonic_buffer_resource arena(1 << 20);
+    pmr::registry<node_base> reg(&arena);
+    churn(reg, 512, 8, [&](int i) { return pmr::make_unique<node<double>>(&arena, double(i)); });
+
+    reg.compact(compact_mode::relocate_nodes);
+
+    std::vector<std::pair<std::pmr::string, const node_base*>> entries;
+    for (const auto& [key, ptr] : reg.data()) entries.emplace_back(key, ptr.get());
+    std::sort(entries.begin(), entries.end());
+    for (std::size_t i = 1; i < entries.size(); ++i)
+        EXPECT_LT(entries[i - 1].second, entries[i].second) << entries[i].first;
+
+    const auto span = entries.back().second - entries.front().second;
+    EXPECT_LT(std::size_t(span), 64 * 256u);  // one entry (node + map node + key) every < 256 bytes
+}
+
+#endif // COMPACT_TEST_H
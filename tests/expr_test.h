@@ -0,0 +1,125 @@
+#ifndef EXPR_TEST_H
+#define EXPR_TEST_H
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "propex/property_view.h"
+#include "propex/propex_expr.h"
+#include "propex/propex_field.h"
+#include "propex/propex_node.h"
+
+using namespace numsim::propex;
+
+namespace {
+using field = std::vector<double>;
+using field_property = property_view<field, node, ownership::by_value>;
+
+field ramp(std::size_t n, double scale) {
+    field f(n);
+    for (std::size_t i = 0; i < n; ++i) f[i] = scale * static_cast<double>(i);
+    return f;
+}
+} // namespace
+
+TEST(FieldExpr, FusedUpdateWritesInPlace) {
+    node<field> un(ramp(100, 1.0)), vn(ramp(100, 2.0)), wn(field(100, 1.0));
+    field_property u(&un), v(&vn), w(&wn);
+    const double* storage = un.get().data();
+    const double dt = 0.5, c = 3.0;
+
+    assign(u, u + dt * v - c * w);
+
+    EXPECT_EQ(un.get().data(), storage);
+    for (std::size_t i = 0; i < 100; ++i)
+        EXPECT_DOUBLE_EQ(un.get()[i], double(i) + dt * 2.0 * double(i) - c);
+}
+
+TEST(FieldExpr, OperatorsAndOperands) {
+    node<field> an(field{1, 2, 3, 4}), bn(field{4, 3, 2, 1}), out(field(4));
+    field_property a(&an), b(&bn), r(&out);
+
+    assign(r, -a / 2.0 + a * b);
+    EXPECT_EQ(out.get(), (field{3.5, 5, 4.5, 2}));
+
+    assign(r, 7.0);
+    EXPECT_EQ(out.get(), (field{7, 7, 7, 7}));
+
+    const std::array<double, 4> plain{10, 20, 30, 40};
+    assign(r, field_ref{std::span(plain)} - a);
+    EXPECT_EQ(out.get(), (field{9, 18, 27, 36}));
+
+    std::array<double, 4> target{};
+    assign(std::span(target), 2.0 * b);
+    EXPECT_EQ(target, (std::array<double, 4>{8, 6, 4, 2}));
+}
+
+TEST(FieldExpr, WorksOnArraysAndAlignedVectors) {
+    using vec3 = std::array<double, 3>;
+    node<vec3> xn(vec3{1, 2, 3}), yn(vec3{});
+    property_view<vec3, node, ownership::by_value> x(&xn), y(&yn);
+    assign(y, 2.0 * x + 1.0);
+    EXPECT_EQ(yn.get(), (vec3{3, 5, 7}));
+
+    node<aligned_vector<float>> fn(aligned_vector<float>(8, 1.0f));
+    property_view<aligned_vector<float>, node, ownership::by_value> f(&fn);
+    assign(f, f * 3.0f);
+    EXPECT_EQ(fn.get()[7], 3.0f);
+}
+
+TEST(FieldExpr, SizeMismatchThrows) {
+    node<field> an(field(4)), bn(field(5));
+    field_property a(&an), b(&bn);
+    EXPECT_THROW((void)(a + b), std::invalid_argument);
+    EXPECT_THROW(assign(a, b * 2.0), std::invalid_argument);
+    EXPECT_EQ(an.get(), field(4));
+}
+
+TEST(FieldExpr, ParallelAssignMatchesSerial) {
+    const std::size_t n = 100003;  // not a multiple of the chunk size
+    node<field> un(ramp(n, 1.0)), vn(ramp(n, -0.5)), serial{field(n)}, parallel{field(n)};
+    field_property u(&un), v(&vn), s(&serial), p(&parallel);
+
+    assign(s, u + 0.1 * v);
+    for (std::size_t threads : {1u, 2u, 3u, 8u}) {
+        assign(p, 0.0);
+        parallel_assign(p, u + 0.1 * v, threads);
+        EXPECT_EQ(parallel.get(), serial.get()) << threads << " threads";
+    }
+
+    parallel_assign(u, u - u);  // target on the right-hand side
+    EXPECT_EQ(un.get(), field(n, 0.0));
+}
+
+TEST(FieldExpr, ParallelAssignHandlesTargetsOffCacheLineBoundaries) {
+    const std::size_t n = 100003;
+    aligned_vector<double> out(n + 3);
+    const std::span<double> target = std::span(out).subspan(3);
+    EXPECT_EQ(detail::elements_to_cache_line(target.data()), 5u);
+    EXPECT_EQ(detail::elements_to_cache_line(out.data()), 0u);
+
+    node<field> src(ramp(n, 1.0));
+    field_property v(&src);
+    for (std::size_t threads : {2u, 3u, 8u}) {
+        std::fill(out.begin(), out.end(), -1.0);
+        parallel_assign(target, 2.0 * v, threads);
+        EXPECT_EQ(out[2], -1.0);
+        for (std::size_t i = 0; i < n; ++i) ASSERT_EQ(target[i], 2.0 * static_cast<double>(i)) << threads;
+    }
+}
+
+TEST(FieldExpr, OnlyFieldViewsAreOperands) {
+    static_assert(field_operand<field_property>);
+    static_assert(field_operand<double>);
+    static_assert(!field_operand<property_view<double, node, ownership::by_value>>);
+    static_assert(!field_operand<property_view<field, node, ownership::by_spinlock>>);
+    static_assert(!field_operand<field>);
+    SUCCEED();
+}
+
+#endif // EXPR_TEST_H
@@ -0,0 +1,142 @@
+#ifndef FIELD_TEST_H
+#define FIELD_TEST_H
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "propex/property_view.h"
+#include "propex/propex_cold.h"
+#include "propex/propex_field.h"
+#include "propex/propex_node.h"
+
+using namespace numsim::propex;
+
+namespace {
+using vec6 = std::array<double, 6>;
+// Eight bytes, so std::atomic stays lock-free and needs no libatomic.
+using short4 = std::array<std::int16_t, 4>;
+
+template <class T>
+using history2_t = ownership::history<2>::type<T>;
+
+template <class Node>
+concept has_span = requires(Node& n) { n.span(); };
+} // namespace
+
+TEST(Field, AlignedVectorIsSimdAligned) {
+    for (std::size_t n : {1u, 3u, 17u, 1000u}) {
+        aligned_vector<double> v(n);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.data()) % simd_alignment, 0u);
+    }
+    aligned_vector<float> moved(aligned_vector<float>(100, 1.0f));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(moved.data()) % simd_alignment, 0u);
+}
+
+TEST(Field, SpanAndElementAccessWriteInPlace) {
+    node<aligned_vector<double>> n(aligned_vector<double>(8, 0.0));
+    property_view<aligned_vector<double>, node, ownership::by_value> v(&n);
+    const double* data = v.get().data();
+
+    std::span<double> s = v.span();
+    EXPECT_EQ(s.data(), data);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(s.data()) % simd_alignment, 0u);
+    s[1] = 1.0;
+    v[2] = 2.0;
+    EXPECT_EQ(v.size(), 8u);
+    EXPECT_EQ(n.get()[1], 1.0);
+    EXPECT_EQ(n.get()[2], 2.0);
+
+    const auto& cv = v;
+    static_assert(std::is_same_v<decltype(cv.span()), std::span<const double>>);
+    EXPECT_EQ(cv[2], 2.0);
+}
+
+TEST(Field, StablePoliciesExposeSpans) {
+    vec6 external{};
+    node<vec6, ownership::by_reference> r(external);
+    r.span()[5] = 5.0;
+    EXPECT_EQ(external[5], 5.0);
+
+    node<std::vector<int>, ownership::by_shared> sh(std::vector<int>(4, 0));
+    sh.span()[0] = 7;
+    EXPECT_EQ(sh.get()[0], 7);
+
+    node<std::vector<int>, history2_t> h(std::vector<int>(4, 0));
+    h.advance();
+    h.span()[0] = 1;
+    EXPECT_EQ(h.get()[0], 1);
+    EXPECT_EQ(h.get(1)[0], 0);
+
+    static_assert(!has_span<node<vec6, ownership::by_atomic>>);
+    static_assert(!has_span<node<std::vector<int>, ownership::by_spinlock>>);
+    static_assert(!has_span<node<std::vector<int>, ownership::by_compressed>>);
+    static_assert(!has_span<node<double>>);
+}
+
+TEST(Field, LoadAndStoreSubRanges) {
+    node<std::vector<double>> n(std::vector<double>{0, 1, 2, 3, 4, 5});
+    property_view<std::vector<double>, node, ownership::by_value> v(&n);
+
+    std::array<double, 2> out{};
+    v.load(2, out);
+    EXPECT_EQ(out, (std::array<double, 2>{2, 3}));
+
+    v.store(4, std::array<double, 2>{40, 50});
+    EXPECT_EQ(n.get(), (std::vector<double>{0, 1, 2, 3, 40, 50}));
+
+    EXPECT_THROW(v.load(5, out), std::out_of_range);
+    EXPECT_THROW(v.store(7, std::array<double, 0>{}), std::out_of_range);
+}
+
+template <template <class> class Ownership>
+void expect_bulk_access() {
+    node<short4, Ownership> n(short4{0, 1, 2, 3});
+    property_view<short4, node, Ownership> v(&n);
+    v.store(1, std::array<std::int16_t, 2>{10, 20});
+    short4 all{};
+    v.load(0, all);
+    EXPECT_EQ(all, (short4{0, 10, 20, 3}));
+    std::array<std::int16_t, 2> out{};
+    EXPECT_THROW(v.load(3, out), std::out_of_range);
+}
+
+TEST(Field, UnstablePoliciesUseBulkLoadStore) {
+    expect_bulk_access<ownership::by_atomic>();
+    expect_bulk_access<ownership::by_spinlock>();
+    expect_bulk_access<ownership::by_rwlock>();
+    expect_bulk_access<ownership::by_atomic_shared>();
+    expect_bulk_access<ownership::by_compressed>();
+
+    alignas(8) short4 external{};
+    node<short4, ownership::by_atomic_ref> r(external);
+    r.store(2, std::array<std::int16_t, 1>{9});
+    EXPECT_EQ(external[2], 9);
+}
+
+TEST(Field, LargeAtomicFieldsLink) {
+    // 48 bytes: not lock-free, so this links only with libatomic where the toolchain needs it.
+    node<vec6, ownership::by_atomic> s(vec6{});
+    property_view<vec6, node, ownership::by_atomic> sv(&s);
+    sv.store(3, std::array{1.0, 2.0});
+    EXPECT_EQ(s.get(), (vec6{0, 0, 0, 1, 2, 0}));
+}
+
+TEST(Field, ConcurrentAtomicStoresKeepEveryElement) {
+    node<short4, ownership::by_atomic> n(short4{});
+    std::vector<std::thread> writers;
+    for (std::size_t t = 0; t < 4; ++t)
+        writers.emplace_back([&, t] {
+            for (std::int16_t k = 1; k <= 1000; ++k) n.store(t, std::array<std::int16_t, 1>{k});
+        });
+    for (auto& w : writers) w.join();
+    EXPECT_EQ(n.get(), (short4{1000, 1000, 1000, 1000}));
+}
+
+#endif // FIELD_TEST_H
@@ -0,0 +1,173 @@
+#ifndef FORMULA_TEST_H
+#define FORMULA_TEST_H
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "propex/ownership_policies.h"
+#include "propex/propex_field.h"
+#include "propex/propex_formula.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+
+using namespace numsim::propex;
+
+namespace {
+using formula_registry = registry<std::string, node_base>;
+
+formula_registry material() {
+    formula_registry reg;
+    reg.add(std::make_unique<node<double>>(210e3), "mat", "E");
+    reg.add(std::make_unique<node<double>>(0.3), "mat", "nu");
+    reg.add(std::make_unique<node<double>>(0.0), "mat", "G");
+    return reg;
+}
+} // namespace
+
+TEST(Formula, ShearModulusFromScalars) {
+    formula_registry reg = material();
+    const formula shear = compile_formula(reg, "mat:G = mat:E / (2*(1+mat:nu))");
+
+    EXPECT_EQ(shear.target(), "mat:G");
+    EXPECT_EQ(shear.inputs(), (std::vector<std::string>{"mat:E", "mat:nu"}));
+    EXPECT_DOUBLE_EQ(shear.value(), 210e3 / 2.6);
+
+    shear.apply();
+    EXPECT_DOUBLE_EQ(static_cast<node<double>*>(reg.find("mat:G"))->get(), 210e3 / 2.6);
+
+    static_cast<node<double>*>(reg.find("mat:nu"))->set(0.5);  // handles see new values
+    EXPECT_DOUBLE_EQ(shear.value(), 70e3);
+}
+
+TEST(Formula, PrecedenceAndFunctions) {
+    formula_registry reg = material();
+    const auto eval = [&](const char* text) { return compile_formula(reg, text).value(); };
+    EXPECT_DOUBLE_EQ(eval("1 + 2 * 3"), 7.0);
+    EXPECT_DOUBLE_EQ(eval("(1 + 2) * 3"), 9.0);
+    EXPECT_DOUBLE_EQ(eval("-2^2"), -4.0);
+    EXPECT_DOUBLE_EQ(eval("2^3^2"), 512.0);
+    EXPECT_DOUBLE_EQ(eval("8 / 4 / 2"), 1.0);
+    EXPECT_DOUBLE_EQ(eval("sqrt(16) + abs(-1) + max(2, 3) - min(2, 3) + pow(2, 0.5)^2"), 8.0);
+    EXPECT_DOUBLE_EQ(eval("log(exp(mat:nu))"), 0.3);
+    EXPECT_DOUBLE_EQ(eval("1.5e3 + .5"), 1500.5);
+}
+
+TEST(Formula, FoldsConstantsAndSharesSubexpressions) {
+    formula_registry reg = material();
+
+    const formula folded = compile_formula(reg, "mat:E * (2 * 3 - 5) + 0 * 4");
+    EXPECT_EQ(folded.instructions().size(), 0u);  // reduces to mat:E
+    EXPECT_DOUBLE_EQ(folded.value(), 210e3);
+
+    // (E + nu) is computed once, nu + E is the same by commutativity.
+    const formula shared = compile_formula(reg, "(mat:E + mat:nu) * (mat:nu + mat:E) - sqrt(mat:E + mat:nu)");
+    EXPECT_EQ(shared.instructions().size(), 4u);
+    EXPECT_EQ(shared.constants().size(), 0u);
+    const double s = 210e3 + 0.3;
+    EXPECT_DOUBLE_EQ(shared.value(), s * s - std::sqrt(s));
+
+    EXPECT_EQ(compile_formula(reg, "--mat:E").instructions().size(), 0u);
+    EXPECT_EQ(compile_formula(reg, "2 * 3").constants().size(), 1u);
+
+    const formula square = compile_formula(reg, "mat:nu^2 + mat:nu^1");
+    ASSERT_EQ(square.instructions().size(), 2u);
+    EXPECT_EQ(square.instructions()[0].op, formula_op::mul);
+    EXPECT_DOUBLE_EQ(square.value(), 0.09 + 0.3);
+}
+
+TEST(Formula, ReusesRegisters) {
+    formula_registry reg = material();
+    // A chain of 16 operations needs one temporary.
+    std::string text = "mat:E";
+    for (int i = 0; i < 16; ++i) text = "sqrt(" + text + ") + mat:nu";
+    const formula f = compile_formula(reg, text);
+    EXPECT_EQ(f.instructions().size(), 32u);
+    EXPECT_EQ(f.registers(), f.constants().size() + f.inputs().size() + 1);
+}
+
+TEST(Formula, EvaluatesFieldsWithBroadcastScalars) {
+    const std::size_t n = 1000;  // several batches, last one partial
+    std::vector<double> rho(n), v(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        rho[i] = 1.0 + static_cast<double>(i);
+        v[i] = 0.5 * static_cast<double>(i);
+    }
+    formula_registry reg = material();
+    reg.add(std::make_unique<node<std::vector<double>>>(rho), "field", "rho");
+    reg.add(std::make_unique<node<aligned_vector<double>>>(aligned_vector<double>(v.begin(), v.end())), "field", "v");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(n)), "field", "e");
+
+    const formula energy = compile_formula(reg, "field:e = 0.5 * field:rho * field:v^2 + mat:nu");
+    EXPECT_EQ(energy.size(), n);
+    EXPECT_THROW((void)energy.value(), std::logic_error);
+
+    std::vector<double> out(n);
+    energy.evaluate(out);
+    energy.apply();
+    const auto& stored = static_cast<node<std::vector<double>>*>(reg.find("field:e"))->get();
+    for (std::size_t i = 0; i < n; ++i) {
+        const double expected = 0.5 * rho[i] * v[i] * v[i] + 0.3;
+        EXPECT_DOUBLE_EQ(out[i], expected) << i;
+        EXPECT_DOUBLE_EQ(stored[i], expected) << i;
+    }
+    EXPECT_THROW(energy.evaluate(std::span(out).first(10)), std::invalid_argument);
+}
+
+TEST(Formula, EmptyFieldsProduceNothing) {
+    formula_registry reg = material();
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>{}), "field", "rho");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>{}), "field", "e");
+
+    const formula f = compile_formula(reg, "field:e = field:rho * mat:E");
+    EXPECT_EQ(f.size(), 0u);
+    EXPECT_NO_THROW(f.evaluate(std::span<double>{}));
+    EXPECT_NO_THROW(f.apply());
+    EXPECT_TRUE(static_cast<node<std::vector<double>>*>(reg.find("field:e"))->get().empty());
+}
+
+TEST(Formula, ReadsLockedAndAtomicInputs) {
+    formula_registry reg;
+    reg.add(std::make_unique<node<double, ownership::by_atomic>>(2.0), "a");
+    reg.add(std::make_unique<node<std::vector<double>, ownership::by_spinlock>>(std::vector<double>{1, 2, 3}), "f");
+    reg.add(std::make_unique<node<std::array<double, 3>, ownership::by_rwlock>>(std::array<double, 3>{}), "out");
+    reg.add(std::make_unique<node<int>>(10), "i");
+
+    compile_formula(reg, "out = f * a + i").apply();
+    auto* out = static_cast<node<std::array<double, 3>, ownership::by_rwlock>*>(reg.find("out"));
+    EXPECT_EQ(out->get(), (std::array<double, 3>{12, 14, 16}));
+}
+
+TEST(Formula, Errors) {
+    formula_registry reg = material();
+    reg.add(std::make_unique<node<std::string>>("steel"), "mat", "name");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(3)), "a");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(4)), "b");
+
+    EXPECT_THROW((void)compile_formula(reg, "mat:E +"), std::invalid_argument);
+    EXPECT_THROW((void)compile_formula(reg, "(mat:E"), std::invalid_argument);
+    EXPECT_THROW((void)compile_formula(reg, "mat:E mat:nu"), std::invalid_argument);
+    EXPECT_THROW((void)compile_formula(reg, "foo(1)"), std::invalid_argument);
+    EXPECT_THROW((void)compile_formula(reg, "= 1"), std::invalid_argument);
+    EXPECT_THROW((void)compile_formula(reg, "mat:name * 2"), std::invalid_argument);
+    EXPECT_THROW((void)compile_formula(reg, "mat:K * 2"), std::out_of_range);
+    EXPECT_THROW((void)compile_formula(reg, "mat:K = 2"), std::out_of_range);
+    EXPECT_THROW((void)compile_formula(reg, "1").apply(), std::logic_error);
+    EXPECT_THROW((void)compile_formula(reg, "a + b").size(), std::invalid_argument);
+    EXPECT_THROW(compile_formula(reg, "mat:G = a").apply(), std::invalid_argument);
+
+    try {
+        (void)compile_formula(reg, "1 + * 2");
+        FAIL();
+    } catch (const std::invalid_argument& e) {
+        EXPECT_NE(std::string(e.what()).find("position 4"), std::string::npos) << e.what();
+    }
+}
+
+#endif // FORMULA_TEST_H
@@ -0,0 +1,84 @@
+#ifndef HISTORY_TEST_H
+#define HISTORY_TEST_H
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "propex/property_view.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+
+using namespace numsim::propex;
+
+namespace {
+template <class T>
+using history3 = ownership::history<3>::type<T>;
+} // namespace
+
+TEST(ByHistory, StartsFilledWithInitialValue) {
+    node<double, history3> u(1.5);
+    EXPECT_EQ(u.get(), 1.5);
+    EXPECT_EQ(u.get(1), 1.5);
+    EXPECT_EQ(u.get(2), 1.5);
+    EXPECT_THROW((void)u.get(3), std::out_of_range);
+}
+
+TEST(ByHistory, AdvanceShiftsValuesWithoutCopies) {
+    node<std::vector<double>, history3> u(std::vector<double>(4, 0.0));
+    const double* slots[3];
+    for (int step = 1; step <= 3; ++step) {
+        u.advance();
+        u.set(std::vector<double>(4, double(step)));
+        slots[step - 1] = u.get().data();
+    }
+    EXPECT_EQ(u.get()[0], 3.0);
+    EXPECT_EQ(u.get(1)[0], 2.0);
+    EXPECT_EQ(u.get(2)[0], 1.0);
+    // Values stay in their slots: the one written two steps ago is still there.
+    EXPECT_EQ(u.get(2).data(), slots[0]);
+    EXPECT_EQ(u.get(1).data(), slots[1]);
+}
+
+TEST(ByHistory, RecycledSlotHoldsOldestValueUntilSet) {
+    node<int, history3> u(0);
+    u.set(1);
+    u.advance();
+    u.set(2);
+    u.advance();
+    u.set(3);
+    u.advance();
+    EXPECT_EQ(u.get(), 1);  // oldest value, about to be overwritten
+    EXPECT_EQ(u.get(1), 3);
+    EXPECT_EQ(u.get(2), 2);
+}
+
+TEST(ByHistory, ViewReadsLaggedValues) {
+    node<double, history3> u(0.0);
+    property_view<double, node, history3> v(&u);
+    v = 1.0;
+    u.advance();
+    v = 2.0;
+    EXPECT_EQ(v.get(), 2.0);
+    EXPECT_EQ(v.get(1), 1.0);
+    EXPECT_EQ(v.get_checked(), 2.0);
+}
+
+TEST(ByHistory, RegistryAdvancesOnlyHistoryNodes) {
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<node<double, history3>>(1.0), "u");
+    reg.add(std::make_unique<node<double, ownership::history<2>::type>>(5.0), "v");
+    reg.add(std::make_unique<node<double>>(7.0), "E");
+
+    auto& u = dynamic_cast<node<double, history3>&>(reg.at("u"));
+    u.set(2.0);
+    EXPECT_EQ(reg.advance(), 2u);
+    u.set(3.0);
+
+    EXPECT_EQ(u.get(1), 2.0);
+    EXPECT_EQ(dynamic_cast<node<double>&>(reg.at("E")).get(), 7.0);
+}
+
+#endif // HISTORY_TEST_H
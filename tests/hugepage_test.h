@@ -0,0 +1,101 @@
+#ifndef HUGEPAGE_TEST_H
+#define HUGEPAGE_TEST_H
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "propex/propex_hugepage.h"
+#include "propex/propex_node.h"
+#include "propex/propex_pmr.h"
+
+using namespace numsim::propex;
+
+namespace {
+constexpr std::size_t huge = huge_page_resource::huge_page_size;
+
+std::size_t mapped(const huge_page_stats& s) {
+    return s.explicit_bytes + s.transparent_bytes + s.normal_bytes;
+}
+} // namespace
+
+static_assert(huge_page_resource::round_up(0) == huge);
+static_assert(huge_page_resource::round_up(1) == huge);
+static_assert(huge_page_resource::round_up(huge) == huge);
+static_assert(huge_page_resource::round_up(huge + 1) == 2 * huge);
+
+TEST(HugePageResource, BlocksAreHugePageAlignedAndWritable) {
+    huge_page_resource resource;
+    void* p = resource.allocate(3 * huge / 2, alignof(std::max_align_t));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % huge, 0u);
+    std::memset(p, 0xab, 3 * huge / 2);
+    EXPECT_EQ(resource.stats().live_bytes, 2 * huge);
+    resource.deallocate(p, 3 * huge / 2, alignof(std::max_align_t));
+    EXPECT_EQ(resource.stats().live_bytes, 0u);
+}
+
+TEST(HugePageResource, EveryModeFallsBackToSomePath) {
+    for (auto mode : {huge_page_mode::none, huge_page_mode::transparent, huge_page_mode::explicit_pages}) {
+        huge_page_resource resource(mode);
+        void* p = resource.allocate(huge, 64);
+        static_cast<char*>(p)[huge - 1] = 1;
+        resource.deallocate(p, huge, 64);
+        const auto s = resource.stats();
+        EXPECT_EQ(mapped(s), huge);
+        if (mode == huge_page_mode::none) { EXPECT_EQ(s.normal_bytes, huge); }
+        if (mode != huge_page_mode::explicit_pages) { EXPECT_EQ(s.explicit_bytes, 0u); }
+    }
+}
+
+TEST(HugePageResource, RejectsOveralignedRequests) {
+    huge_page_resource resource;
+    EXPECT_THROW((void)resource.allocate(16, 2 * huge), std::bad_alloc);
+}
+
+TEST(HugePageArena, HostsRegistryAndFieldColumns) {
+    huge_page_arena arena;
+    {
+        pmr::registry<node_base> reg(&arena);
+        for (int i = 0; i < 10000; ++i)
+            reg.add(pmr::make_unique<node<double>>(&arena, double(i)), "elem", std::to_string(i));
+        std::pmr::vector<double> column(100000, 1.0, &arena);
+
+        auto* n = dynamic_cast<node<double>*>(reg.find(std::pmr::string("elem:42", &arena)));
+        ASSERT_NE(n, nullptr);
+        EXPECT_EQ(n->get(), 42.0);
+        EXPECT_EQ(column.back(), 1.0);
+    }
+    const auto used = arena.upstream().stats().live_bytes;
+    EXPECT_GT(used, 0u);
+    EXPECT_EQ(used % huge, 0u);
+    arena.release();
+    EXPECT_EQ(arena.upstream().stats().live_bytes, 0u);
+}
+
+TEST(HugePageArena, MapsOnlyThePagesItUses) {
+    huge_page_arena small;
+    (void)small.allocate(16, 8);
+    EXPECT_EQ(small.upstream().stats().live_bytes, huge);
+
+    huge_page_arena large;
+    std::size_t allocated = 0;
+    for (; allocated < 25 * huge / 4; allocated += 1000) (void)large.allocate(1000, 8);
+    (void)large.allocate(5 * huge / 2, 64);  // larger than one page
+    allocated += 5 * huge / 2;
+    const auto live = large.upstream().stats().live_bytes;
+    EXPECT_GE(live, allocated);
+    EXPECT_LE(live, huge_page_resource::round_up(allocated) + huge);
+}
+
+TEST(HugePageArena, HonoursAlignment) {
+    huge_page_arena arena;
+    (void)arena.allocate(1, 1);
+    void* p = arena.allocate(64, 4096);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 4096, 0u);
+    EXPECT_EQ(arena.upstream().stats().live_bytes, huge);
+}
+
+#endif // HUGEPAGE_TEST_H
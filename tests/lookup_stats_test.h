@@ -0,0 +1,147 @@
+#ifndef LOOKUP_STATS_TEST_H
+#define LOOKUP_STATS_TEST_H
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+
+using namespace numsim::propex;
+
+/// Deliberately terrible hash: every key lands in the same bucket.
+struct constant_hash {
+    std::size_t operator()(const std::string&) const noexcept { return 42; }
+};
+
+/// Outside the anonymous namespace: it becomes the type of a registry member.
+template <class K, class V>
+using clustered_map = std::unordered_map<K, V, constant_hash>;
+
+namespace {
+
+template <class Reg>
+void fill(Reg& reg, std::size_t n, const std::string& prefix = "elem") {
+    for (std::size_t i = 0; i < n; ++i)
+        reg.add(typename Reg::node_pointer(new node<int>(int(i))), prefix, std::to_string(i));
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Lookup counters
+// -----------------------------------------------------------------------------
+TEST(LookupStats, CountsHitsAndMisses) {
+    registry<std::string, node<int>> reg;
+    fill(reg, 8);
+    (void)reg.find("elem:1");
+    (void)reg.contains("elem:2");
+    (void)reg.at("elem:3");
+    (void)reg.find("missing");
+    EXPECT_THROW((void)reg.at("missing"), std::out_of_range);
+
+    const auto s = reg.lookup_stats();
+    EXPECT_EQ(s.hits, 3u);
+    EXPECT_EQ(s.misses, 2u);
+    EXPECT_DOUBLE_EQ(s.hit_rate(), 0.6);
+    EXPECT_EQ(s.chain_samples, 2u);  // the first hit and the first miss
+    EXPECT_EQ(std::accumulate(s.chain_histogram.begin(), s.chain_histogram.end(), std::uint64_t{0}), 2u);
+}
+
+TEST(LookupStats, SamplesProbeLengths) {
+    registry<std::string, node<int>> reg;
+    fill(reg, 8);
+    const std::uint64_t period = lookup_counters::chain_sample_period;
+    for (std::uint64_t i = 0; i < 4 * period; ++i) (void)reg.find("elem:1");
+    const auto s = reg.lookup_stats();
+    EXPECT_EQ(s.chain_samples, 4u);
+    EXPECT_GE(s.mean_chain_length(), 1.0);  // a hit compares at least its own entry
+}
+
+TEST(LookupStats, RecordsRehashesAndLoadFactors) {
+    registry<std::string, node<int>> reg;
+    fill(reg, 1000);
+    const auto s = reg.lookup_stats();
+    EXPECT_GT(s.rehashes, 1u);
+    EXPECT_EQ(std::accumulate(s.load_factor_histogram.begin(), s.load_factor_histogram.end(), std::uint64_t{0}),
+              1000u);
+}
+
+TEST(LookupStats, ChainLengthsExposeBadHashes) {
+    registry<std::string, node<int>, std::unique_ptr, clustered_map> reg;
+    fill(reg, 32);
+    (void)reg.find("missing");  // a miss compares every entry of the bucket
+    const auto s = reg.lookup_stats();
+    EXPECT_EQ(s.chain_total, 32u);
+    EXPECT_EQ(s.chain_histogram.back(), 1u);
+}
+
+TEST(LookupStats, OrderedMapsCountOnlyHitsAndMisses) {
+    registry<std::string, node<int>, std::unique_ptr, std::map> reg;
+    fill(reg, 4);
+    (void)reg.find("elem:0");
+    const auto s = reg.lookup_stats();
+    EXPECT_EQ(s.hits, 1u);
+    EXPECT_EQ(s.chain_total, 0u);
+    EXPECT_EQ(s.rehashes, 0u);
+}
+
+TEST(LookupStats, ResetAndMovePreserveSemantics) {
+    registry<std::string, node<int>> reg;
+    fill(reg, 2);
+    (void)reg.find("elem:0");
+    registry<std::string, node<int>> moved(std::move(reg));
+    EXPECT_EQ(moved.lookup_stats().hits, 1u);
+    moved.reset_lookup_stats();
+    EXPECT_EQ(moved.lookup_stats().lookups(), 0u);
+}
+
+// -----------------------------------------------------------------------------
+// Key diagnostics
+// -----------------------------------------------------------------------------
+TEST(KeyDiagnostics, IndexPattern) {
+    EXPECT_EQ(index_pattern("elem:17"), "elem:#");
+    EXPECT_EQ(index_pattern("u:n-1"), "u:n-#");
+    EXPECT_EQ(index_pattern("speed"), "");
+}
+
+TEST(KeyDiagnostics, FlagsTrailingIndexFamilies) {
+    registry<std::string, node<int>> reg;
+    fill(reg, 200, "elem");
+    fill(reg, 10, "node");
+    reg.add(std::make_unique<node<int>>(0), "material", "E");
+
+    const auto report = diagnose_keys(reg, 64);
+    EXPECT_EQ(report.keys, 211u);
+    ASSERT_EQ(report.indexed_families.size(), 1u);
+    EXPECT_EQ(report.indexed_families[0].pattern, "elem:#");
+    EXPECT_EQ(report.indexed_families[0].count, 200u);
+    EXPECT_NEAR(report.indexed_fraction, 200.0 / 211.0, 1e-12);
+    EXPECT_TRUE(report.pathological());
+}
+
+TEST(KeyDiagnostics, FlagsClusteredBuckets) {
+    registry<std::string, node<int>, std::unique_ptr, clustered_map> reg;
+    fill(reg, 100);
+    const auto report = diagnose_keys(reg, 1000);
+    EXPECT_TRUE(report.indexed_families.empty());
+    EXPECT_EQ(report.max_chain, 100u);
+    EXPECT_TRUE(report.pathological());
+}
+
+TEST(KeyDiagnostics, HealthyRegistryHasNoWarnings) {
+    registry<std::string, node<int>> reg;
+    for (int i = 0; i < 100; ++i)
+        reg.add(std::make_unique<node<int>>(i), "obj" + std::to_string(i), "prop");
+    const auto report = diagnose_keys(reg);
+    EXPECT_FALSE(report.pathological());
+    EXPECT_GT(report.buckets, 0u);
+}
+
+#endif // LOOKUP_STATS_TEST_H
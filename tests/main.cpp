@@ -2,6 +2,21 @@
 #include "key_traits_test.h"
 #include "registry_test.h"
 #include "property_view_test.h"
+#include "memory_test.h"
+#include "pmr_test.h"
+#include "hugepage_test.h"
+#include "compact_test.h"
+#include "history_test.h"
+#include "tabulated_test.h"
+#include "mmap_test.h"
+#include "cold_test.h"
+#include "move_test.h"
+#include "field_test.h"
+#include "expr_test.h"
+#include "formula_test.h"
+#include "sensitivity_test.h"
+#include "async_test.h"
+#include "scheduler_test.h"
 
 int main(int argc, char *argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,108 @@
+#ifndef MEMORY_TEST_H
+#define MEMORY_TEST_H
+
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "propex/propex_memory.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+
+using namespace numsim::propex;
+
+// -----------------------------------------------------------------------------
+// Value accounting
+// -----------------------------------------------------------------------------
+TEST(MemoryTraits, ShortStringsStayInline) {
+    const std::string s = "ab";
+    EXPECT_TRUE(memory_traits<std::string>::is_inline(s));
+    EXPECT_EQ(heap_bytes(s), 0u);
+}
+
+TEST(MemoryTraits, LongStringsCountCapacity) {
+    const std::string s(100, 'x');
+    EXPECT_FALSE(memory_traits<std::string>::is_inline(s));
+    EXPECT_GE(heap_bytes(s), 101u);
+}
+
+TEST(MemoryTraits, VectorsCountCapacityAndElements) {
+    std::vector<double> v;
+    v.reserve(32);
+    EXPECT_EQ(heap_bytes(v), 32 * sizeof(double));
+
+    std::vector<std::string> strings{std::string(100, 'y')};
+    EXPECT_GE(heap_bytes(strings), sizeof(std::string) + 101);
+}
+
+TEST(StorageMemory, ReferencedValuesAreNotCounted) {
+    std::vector<double> external(64);
+    node<std::vector<double>, ownership::by_reference> referenced(external);
+    node<std::vector<double>, ownership::by_value> owned(external);
+    EXPECT_EQ(referenced.payload_bytes(), 0u);
+    EXPECT_EQ(owned.payload_bytes(), 64 * sizeof(double));
+}
+
+TEST(StorageMemory, SharedValuesAreSplitBetweenOwners) {
+    auto sp = std::make_shared<std::vector<double>>(64);
+    node<std::vector<double>, ownership::by_shared> a(sp);
+    const auto alone = a.payload_bytes();
+    node<std::vector<double>, ownership::by_shared> b(sp);
+    EXPECT_LT(a.payload_bytes(), alone);
+    EXPECT_EQ(a.payload_bytes(), b.payload_bytes());
+}
+
+TEST(StorageMemory, LockedValuesAreCounted) {
+    node<std::vector<double>, ownership::by_spinlock> spin(std::vector<double>(64));
+    node<std::vector<double>, ownership::by_rwlock> rw(std::vector<double>(64));
+    EXPECT_EQ(spin.payload_bytes(), 64 * sizeof(double));
+    EXPECT_EQ(rw.payload_bytes(), 64 * sizeof(double));
+    // Taking the shared lock may throw std::system_error.
+    static_assert(!noexcept(ownership::storage_memory<ownership::by_rwlock<std::vector<double>>>::heap_bytes(
+        std::declval<const ownership::by_rwlock<std::vector<double>>&>())));
+}
+
+// -----------------------------------------------------------------------------
+// Registry footprint
+// -----------------------------------------------------------------------------
+TEST(RegistryMemory, EmptyRegistryOnlyCountsItself) {
+    registry<std::string, node_base, std::unique_ptr, std::map> reg;
+    const auto f = reg.memory_usage();
+    EXPECT_EQ(f.properties, 0u);
+    EXPECT_EQ(f.total(), sizeof(reg));
+    EXPECT_EQ(f.bytes_per_property(), 0.0);
+}
+
+TEST(RegistryMemory, BreakdownCoversKeysNodesAndPayload) {
+    registry<std::string, node_base> reg;
+    reg.add(std::make_unique<node<double>>(1.0), "short");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(128)),
+            std::string(40, 'k'));
+
+    const auto f = reg.memory_usage();
+    EXPECT_EQ(f.properties, 2u);
+    EXPECT_EQ(f.keys_inline, 1u);
+    EXPECT_EQ(f.keys_on_heap, 1u);
+    EXPECT_GE(f.key_heap, 41u);
+    EXPECT_GT(f.index_buckets, 0u);
+    EXPECT_EQ(f.node_objects, sizeof(node<double>) + sizeof(node<std::vector<double>>));
+    EXPECT_EQ(f.payload_heap, 128 * sizeof(double));
+    EXPECT_EQ(f.by_type.at(typeid(double)), sizeof(node<double>));
+    EXPECT_EQ(f.by_type.at(typeid(std::vector<double>)),
+              sizeof(node<std::vector<double>>) + 128 * sizeof(double));
+    EXPECT_GT(f.total(), f.node_objects + f.payload_heap + f.key_heap);
+}
+
+TEST(RegistryMemory, SharedPointersAddControlBlocks) {
+    registry<std::string, node_base, std::unique_ptr> unique_reg;
+    registry<std::string, node_base, std::shared_ptr> shared_reg;
+    unique_reg.add(std::make_unique<node<int>>(1), "a");
+    shared_reg.add(std::shared_ptr<node_base>(new node<int>(1)), "a");
+    EXPECT_GT(shared_reg.memory_usage().node_pointers, unique_reg.memory_usage().node_pointers);
+}
+
+#endif // MEMORY_TEST_H
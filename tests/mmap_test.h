@@ -0,0 +1,141 @@
+#ifndef MMAP_TEST_H
+#define MMAP_TEST_H
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "propex/property_view.h"
+#include "propex/propex_mmap.h"
+#include "propex/propex_node.h"
+
+using namespace numsim::propex;
+
+namespace {
+/// Temporary file removed at the end of the test.
+struct temp_file {
+    std::filesystem::path path;
+    explicit temp_file(const std::string& name)
+        : path(std::filesystem::temp_directory_path() / ("propex_" + name + ".bin")) {
+        std::filesystem::remove(path);
+    }
+    ~temp_file() { std::filesystem::remove(path); }
+
+    void write(const std::vector<double>& values) const {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(values.data()),
+                  static_cast<std::streamsize>(values.size() * sizeof(double)));
+    }
+
+    std::vector<double> read() const {
+        std::vector<double> values(std::filesystem::file_size(path) / sizeof(double));
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(double)));
+        return values;
+    }
+};
+
+using mmap_node = node<double, ownership::by_mmap>;
+using mmap_view = property_view<double, node, ownership::by_mmap>;
+} // namespace
+
+TEST(ByMmap, ReadOnlyMappingIsZeroCopy) {
+    temp_file file("read_only");
+    std::vector<double> values(1000);
+    std::iota(values.begin(), values.end(), 0.0);
+    file.write(values);
+
+    mmap_node n(ownership::mmap_file{file.path, 0, ownership::mmap_mode::read_only, ownership::mmap_advice::random});
+    mmap_view v(&n);
+    const std::span<const double> a = v.get();
+    const std::span<const double> b = v.get();
+    ASSERT_EQ(a.size(), 1000u);
+    EXPECT_EQ(a.data(), b.data());
+    EXPECT_EQ(a[999], 999.0);
+    EXPECT_THROW((void)v.span(), std::logic_error);
+}
+
+TEST(ByMmap, ReadWriteCreatesFileAndFlushes) {
+    temp_file file("read_write");
+    {
+        mmap_node n(ownership::mmap_file{file.path, 64, ownership::mmap_mode::read_write,
+                                      ownership::mmap_advice::sequential});
+        mmap_view v(&n);
+        auto data = v.span();
+        ASSERT_EQ(data.size(), 64u);
+        for (std::size_t i = 0; i < data.size(); ++i) data[i] = 2.0 * static_cast<double>(i);
+        v.flush();
+        EXPECT_EQ(file.read()[63], 126.0);
+
+        std::vector<double> replacement(64, 1.5);
+        v.set(replacement);
+        EXPECT_EQ(v.get()[10], 1.5);
+    }
+    const auto stored = file.read();
+    ASSERT_EQ(stored.size(), 64u);
+    EXPECT_EQ(stored[10], 1.5);
+}
+
+TEST(ByMmap, CopyOnWriteNeverTouchesTheFile) {
+    temp_file file("copy_on_write");
+    file.write(std::vector<double>(16, 1.0));
+    {
+        mmap_node n(ownership::mmap_file{file.path, 0, ownership::mmap_mode::copy_on_write});
+        mmap_view v(&n);
+        v.span()[3] = 42.0;
+        EXPECT_EQ(v.get()[3], 42.0);
+        v.flush();
+    }
+    EXPECT_EQ(file.read()[3], 1.0);
+}
+
+TEST(ByMmap, ReportsInvalidFiles) {
+    temp_file missing("missing");
+    EXPECT_THROW(mmap_node(ownership::mmap_file{missing.path}), std::system_error);
+
+    temp_file odd("odd_size");
+    {
+        std::ofstream out(odd.path, std::ios::binary);
+        out << "abc";
+    }
+    EXPECT_THROW(mmap_node(ownership::mmap_file{odd.path}), std::invalid_argument);
+    EXPECT_THROW(mmap_node(ownership::mmap_file{odd.path, 8}), std::invalid_argument);
+}
+
+TEST(ByMmap, SetErrorsReachTheCaller) {
+    temp_file file("set_errors");
+    file.write(std::vector<double>(8, 3.0));
+    mmap_node rw(ownership::mmap_file{file.path, 0, ownership::mmap_mode::read_write});
+    mmap_view v(&rw);
+    static_assert(!noexcept(v.set(std::vector<double>{})));
+    EXPECT_THROW(v.set(std::vector<double>(7, 1.0)), std::invalid_argument);
+    EXPECT_EQ(rw.version(), 0u);
+
+    mmap_node ro(ownership::mmap_file{file.path});
+    mmap_view r(&ro);
+    EXPECT_THROW(r.set(std::vector<double>(8, 1.0)), std::logic_error);
+    EXPECT_THROW(r.set_checked(std::vector<double>(8, 1.0)), std::logic_error);
+    EXPECT_EQ(r.get()[0], 3.0);
+}
+
+TEST(ByMmap, NodesCanBeRelocated) {
+    temp_file file("relocate");
+    file.write(std::vector<double>(8, 3.0));
+    mmap_node n(ownership::mmap_file{file.path});
+    const double* data = n.get().data();
+
+    alignas(mmap_node) unsigned char buffer[sizeof(mmap_node)];
+    auto* moved = static_cast<mmap_node*>(n.relocate_to(buffer));
+    ASSERT_NE(moved, nullptr);
+    EXPECT_EQ(moved->get().data(), data);
+    EXPECT_EQ(n.get().size(), 0u);
+    moved->~mmap_node();
+}
+
+#endif // MMAP_TEST_H
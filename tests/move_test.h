@@ -0,0 +1,194 @@
+#ifndef MOVE_TEST_H
+#define MOVE_TEST_H
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "propex/property_view.h"
+#include "propex/propex_cold.h"
+#include "propex/propex_node.h"
+
+using namespace numsim::propex;
+
+namespace {
+/// Counts copies and moves of the value itself.
+struct tracked {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    static void reset() { copies = moves = 0; }
+
+    int value{0};
+
+    tracked() = default;
+    explicit tracked(int v) : value(v) {}
+    tracked(const tracked& o) : value(o.value) { ++copies; }
+    tracked(tracked&& o) noexcept : value(o.value) { ++moves; }
+    tracked& operator=(const tracked& o) {
+        value = o.value;
+        ++copies;
+        return *this;
+    }
+    tracked& operator=(tracked&& o) noexcept {
+        value = o.value;
+        ++moves;
+        return *this;
+    }
+};
+
+/// Counts heap allocations of containers that use it.
+struct allocation_counter {
+    static inline std::size_t allocations = 0;
+};
+
+template <class T>
+struct counting_allocator {
+    using value_type = T;
+    counting_allocator() = default;
+    template <class U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+    T* allocate(std::size_t n) {
+        ++allocation_counter::allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>{}.deallocate(p, n); }
+    friend bool operator==(const counting_allocator&, const counting_allocator&) = default;
+};
+
+using counted_vector = std::vector<double, counting_allocator<double>>;
+
+template <class T>
+using history3_t = ownership::history<3>::type<T>;
+
+template <template <class> class Ownership>
+void expect_moved_construction_and_set() {
+    tracked::reset();
+    node<tracked, Ownership> n(tracked{1});
+    EXPECT_EQ(tracked::copies, 0);
+    property_view<tracked, node, Ownership> v(&n);
+    v.set(tracked{2});
+    v.set_checked(tracked{3});
+    EXPECT_EQ(tracked::copies, 0);
+}
+
+template <class Node>
+concept has_set_from = requires(Node& n) { n.set_from([](double&) {}); };
+
+void fill(counted_vector& v, double x) {
+    v.resize(1000);
+    for (auto& e : v) e = x;
+}
+} // namespace
+
+TEST(MoveAware, RvaluesAreMovedThroughEveryPolicy) {
+    expect_moved_construction_and_set<ownership::by_value>();
+    expect_moved_construction_and_set<ownership::by_shared>();
+    expect_moved_construction_and_set<ownership::by_lazy>();
+    expect_moved_construction_and_set<ownership::by_spinlock>();
+    expect_moved_construction_and_set<ownership::by_rwlock>();
+}
+
+TEST(MoveAware, BracedInitializersStillSelectTheValueOverloads) {
+    node<std::vector<int>> n(std::vector<int>{});
+    property_view<std::vector<int>, node, ownership::by_value> v(&n);
+    v.set({1, 2});
+    EXPECT_EQ(n.get(), (std::vector<int>{1, 2}));
+    v.set_checked({1, 2, 3});
+    EXPECT_EQ(n.get(), (std::vector<int>{1, 2, 3}));
+}
+
+TEST(MoveAware, HistoryCopiesOnlyIntoOlderSlots) {
+    tracked::reset();
+    node<tracked, history3_t> n(tracked{1});
+    EXPECT_EQ(tracked::copies, 2);  // K - 1
+    n.advance();
+    n.set(tracked{2});
+    EXPECT_EQ(tracked::copies, 2);
+}
+
+TEST(MoveAware, AtomicSharedPublishesMovedValue) {
+    tracked::reset();
+    node<tracked, ownership::by_atomic_shared> n(tracked{1});
+    n.set(tracked{2});
+    EXPECT_EQ(tracked::copies, 0);
+    EXPECT_EQ(n.get()->value, 2);
+}
+
+TEST(MoveAware, MovedVectorsKeepTheirBuffer) {
+    counted_vector u(1000, 1.0);
+    const double* buffer = u.data();
+    allocation_counter::allocations = 0;
+
+    node<counted_vector> n(std::move(u));
+    EXPECT_EQ(n.get().data(), buffer);
+
+    counted_vector next(1000, 2.0);
+    const double* next_buffer = next.data();
+    allocation_counter::allocations = 0;
+    property_view<counted_vector, node, ownership::by_value> v(&n);
+    v.set(std::move(next));
+    EXPECT_EQ(allocation_counter::allocations, 0u);
+    EXPECT_EQ(v.get().data(), next_buffer);
+
+    counted_vector shared(1000, 3.0);
+    const double* shared_buffer = shared.data();
+    allocation_counter::allocations = 0;
+    node<counted_vector, ownership::by_shared> s(std::move(shared));
+    EXPECT_EQ(allocation_counter::allocations, 0u);
+    EXPECT_EQ(s.get().data(), shared_buffer);
+}
+
+TEST(MoveAware, SetFromReusesCapacity) {
+    node<counted_vector> n(counted_vector(1000, 0.0));
+    property_view<counted_vector, node, ownership::by_value> v(&n);
+    const double* buffer = v.get().data();
+
+    allocation_counter::allocations = 0;
+    for (int step = 1; step <= 10; ++step) v.set_from([&](counted_vector& u) { fill(u, step); });
+    EXPECT_EQ(allocation_counter::allocations, 0u);
+    EXPECT_EQ(v.get().data(), buffer);
+    EXPECT_EQ(v.get()[999], 10.0);
+
+    // For comparison: rebuilding and assigning allocates every step.
+    for (int step = 1; step <= 10; ++step) {
+        counted_vector fresh;
+        fill(fresh, step);
+        v.set(std::move(fresh));
+    }
+    EXPECT_GE(allocation_counter::allocations, 10u);
+}
+
+TEST(MoveAware, SetFromWorksWithLockingAndHistoryPolicies) {
+    node<counted_vector, ownership::by_spinlock> locked(counted_vector(1000, 0.0));
+    node<counted_vector, history3_t> hist(counted_vector(1000, 0.0));
+
+    allocation_counter::allocations = 0;
+    locked.set_from([](counted_vector& u) { fill(u, 1.0); });
+    hist.advance();
+    hist.set_from([](counted_vector& u) { fill(u, 1.0); });
+    EXPECT_EQ(allocation_counter::allocations, 0u);
+
+    EXPECT_EQ(locked.get()[0], 1.0);
+    EXPECT_EQ(hist.get()[0], 1.0);
+    EXPECT_EQ(hist.get(1)[0], 0.0);
+}
+
+TEST(MoveAware, SetFromThawsCompressedValues) {
+    node<std::vector<int>, ownership::by_compressed> n(std::vector<int>(1000, 7));
+    n.compress_cold();
+    ASSERT_EQ(n.compress_cold().compressed, 1u);
+    n.set_from([](std::vector<int>& u) { u[0] = 1; });
+    EXPECT_EQ(n.get()[0], 1);
+    EXPECT_EQ(n.get()[1], 7);
+}
+
+TEST(MoveAware, SetFromIsUnavailableForAtomicPolicies) {
+    EXPECT_FALSE((has_set_from<node<double, ownership::by_atomic>>));
+    EXPECT_FALSE((has_set_from<node<double, ownership::by_atomic_shared>>));
+    EXPECT_TRUE((has_set_from<node<double>>));
+}
+
+#endif // MOVE_TEST_H
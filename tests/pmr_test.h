@@ -0,0 +1,170 @@
+#ifndef PMR_TEST_H
+#define PMR_TEST_H
+
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "propex/key_traits.h"
+#include "propex/propex_memory.h"
+#include "propex/propex_node.h"
+#include "propex/propex_pmr.h"
+
+using namespace numsim::propex;
+
+namespace {
+
+/// Forwards to an upstream resource and counts what passes through.
+class counting_resource final : public std::pmr::memory_resource {
+public:
+    explicit counting_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+
+    std::size_t allocations{};
+    std::size_t outstanding{};
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocations;
+        outstanding += bytes;
+        return upstream_->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        outstanding -= bytes;
+        upstream_->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+};
+
+/// Installs a counting default resource for the lifetime of the guard.
+struct default_resource_guard {
+    counting_resource counter;
+    std::pmr::memory_resource* previous{std::pmr::set_default_resource(&counter)};
+    ~default_resource_guard() { std::pmr::set_default_resource(previous); }
+};
+
+const std::string long_part(40, 'p');
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Keys
+// -----------------------------------------------------------------------------
+TEST(PmrKeys, MergeUsesGivenAllocator) {
+    counting_resource resource;
+    using traits = key_traits<std::pmr::string>;
+    const auto key = traits::merge(std::allocator_arg, &resource, long_part, "speed");
+    EXPECT_EQ(std::string_view(key), long_part + ":speed");
+    EXPECT_EQ(key.get_allocator().resource(), &resource);
+    EXPECT_EQ(resource.allocations, 1u);
+}
+
+TEST(PmrKeys, SplitWorksOnPmrStrings) {
+    const std::pmr::string key = "a:b:c";
+    const auto parts = key_traits<std::pmr::string>::split(key);
+    ASSERT_EQ(parts.size(), 3u);
+    EXPECT_EQ(parts[2], "c");
+}
+
+// -----------------------------------------------------------------------------
+// Registry
+// -----------------------------------------------------------------------------
+TEST(PmrRegistry, AllAllocationsComeFromTheResource) {
+    counting_resource resource;
+    default_resource_guard guard;
+    {
+        pmr::registry<node_base> reg(&resource);
+        EXPECT_EQ(pmr::resource_of(reg), &resource);
+        reg.add(pmr::make_unique<node<double>>(&resource, 1.0), long_part, "E");
+        reg.add(pmr::make_unique<node<int>>(&resource, 2), std::string_view(long_part));
+        EXPECT_GT(resource.allocations, 4u);
+        EXPECT_EQ(guard.counter.allocations, 0u);
+
+        const std::pmr::string key(long_part + ":E", &resource);
+        auto* n = dynamic_cast<node<double>*>(reg.find(key));
+        ASSERT_NE(n, nullptr);
+        EXPECT_EQ(n->get(), 1.0);
+        EXPECT_EQ(reg.find(key)->underlying_type(), typeid(double));
+    }
+    EXPECT_EQ(resource.outstanding, 0u);
+    EXPECT_EQ(guard.counter.allocations, 0u);
+}
+
+TEST(PmrRegistry, StringViewLookupsBuildNoTemporaryKey) {
+    counting_resource resource;
+    pmr::registry<node_base> hashed(&resource);
+    pmr::registry<node_base, pmr::map> ordered(&resource);
+    hashed.add(pmr::make_unique<node<double>>(&resource, 1.0), long_part, "E");
+    ordered.add(pmr::make_unique<node<double>>(&resource, 1.0), long_part, "E");
+
+    default_resource_guard guard;
+    const std::string key = long_part + ":E";
+    EXPECT_NE(hashed.find(std::string_view(key)), nullptr);
+    EXPECT_NE(ordered.find(std::string_view(key)), nullptr);
+    EXPECT_NE(hashed.find(key), nullptr);
+    EXPECT_EQ(hashed.find("missing"), nullptr);
+    EXPECT_TRUE(ordered.contains(std::string_view(key)));
+    EXPECT_FALSE(hashed.contains("missing"));
+    EXPECT_EQ(&hashed.at(std::string_view(key)), hashed.find(key));
+    EXPECT_THROW((void)ordered.at("missing"), std::out_of_range);
+    EXPECT_EQ(guard.counter.allocations, 0u);
+}
+
+TEST(PmrRegistry, EraseReturnsNodeMemory) {
+    counting_resource resource;
+    pmr::registry<node_base, pmr::map> reg(&resource);
+    reg.add(pmr::make_unique<node<double>>(&resource, 1.0), "a");
+    const auto with_node = resource.outstanding;
+    EXPECT_TRUE(reg.erase(std::pmr::string("a", &resource)));
+    EXPECT_LT(resource.outstanding, with_node);
+    EXPECT_EQ(resource.outstanding, 0u);
+}
+
+TEST(PmrRegistry, PhaseTeardownIsOneArenaRelease) {
+    counting_resource upstream;
+    std::pmr::monotonic_buffer_resource arena(4096, &upstream);
+    {
+        pmr::registry<node_base> reg(&arena);
+        for (int i = 0; i < 1000; ++i)
+            reg.add(pmr::make_unique<node<int>>(&arena, i), "elem", std::to_string(i));
+        EXPECT_EQ(reg.data().size(), 1000u);
+    }
+    EXPECT_GT(upstream.outstanding, 0u);
+    arena.release();
+    EXPECT_EQ(upstream.outstanding, 0u);
+}
+
+TEST(PmrRegistry, MemoryUsageWorksWithPmrKeys) {
+    std::pmr::monotonic_buffer_resource arena;
+    pmr::registry<node_base> reg(&arena);
+    reg.add(pmr::make_unique<node<double>>(&arena, 1.0), long_part);
+    const auto f = reg.memory_usage();
+    EXPECT_EQ(f.keys_on_heap, 1u);
+    EXPECT_EQ(f.node_objects, sizeof(node<double>));
+    EXPECT_FALSE(f.measured);
+}
+
+TEST(PmrRegistry, MemoryUsageIsMeasuredThroughAnAccountingResource) {
+    accounting_resource counted;
+    {
+        pmr::registry<node_base> reg(&counted);
+        reg.add(pmr::make_unique<node<double>>(&counted, 1.0), long_part);
+        const auto with_one = reg.memory_usage();
+        EXPECT_TRUE(with_one.measured);
+        EXPECT_EQ(with_one.measured_bytes, counted.bytes_in_use());
+        EXPECT_GE(with_one.measured_bytes, sizeof(node<double>) + long_part.size());
+
+        reg.add(pmr::make_unique<node<double>>(&counted, 2.0), "b");
+        EXPECT_GT(reg.memory_usage().measured_bytes, with_one.measured_bytes + sizeof(node<double>) - 1);
+    }
+    EXPECT_EQ(counted.bytes_in_use(), 0u);
+    EXPECT_GT(counted.allocations(), 0u);
+}
+
+#endif // PMR_TEST_H
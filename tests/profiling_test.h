@@ -0,0 +1,140 @@
+#ifndef PROFILING_TEST_H
+#define PROFILING_TEST_H
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+#include "propex/property_view.h"
+
+using namespace numsim::propex;
+
+using profiled_node = node<int>;
+using profiled_registry = registry<std::string, profiled_node>;
+
+class ProfilingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        profiling::set_sample_period(1);
+        profiling::reset();
+        reg.add(std::make_unique<profiled_node>(1), "hot");
+        reg.add(std::make_unique<profiled_node>(2), "warm");
+        reg.add(std::make_unique<profiled_node>(3), "cold");
+    }
+
+    profiled_registry reg;
+};
+
+TEST_F(ProfilingTest, CountsFindGetAndSetPerNode) {
+    auto* n = reg.find("hot");
+    property_view<int, node> v(n);
+    for (int i = 0; i < 5; ++i) v.set(i);
+    for (int i = 0; i < 3; ++i) (void)v.get();
+
+    const auto counts = profiling::snapshot();
+    const auto& c = counts.at(n);
+    EXPECT_EQ(c.find, 1u);
+    EXPECT_EQ(c.set, 5u);
+    EXPECT_EQ(c.get, 3u);
+}
+
+TEST_F(ProfilingTest, MissesAreNotCounted) {
+    EXPECT_EQ(reg.find("absent"), nullptr);
+    EXPECT_TRUE(profiling::snapshot().empty());
+}
+
+TEST_F(ProfilingTest, HotKeysAreOrderedAndTruncated) {
+    for (int i = 0; i < 10; ++i) (void)reg.find("hot");
+    for (int i = 0; i < 4; ++i) (void)reg.find("warm");
+    (void)reg.find("cold");
+
+    const auto top = profiling::hot_keys(reg, 2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].key, "hot");
+    EXPECT_EQ(top[0].counts.total(), 10u);
+    EXPECT_EQ(top[1].key, "warm");
+}
+
+TEST_F(ProfilingTest, SamplingWeightsRecordedAccesses) {
+    profiling::set_sample_period(4);
+    // A fresh thread, so no countdown drawn with another period carries over.
+    std::thread t([this] {
+        for (int i = 0; i < 4000; ++i) (void)reg.find("hot");
+    });
+    t.join();
+
+    const auto top = profiling::hot_keys(reg, 1);
+    ASSERT_EQ(top.size(), 1u);
+    // Samples are drawn at random intervals; each one counts for a whole period.
+    EXPECT_EQ(top[0].counts.find % 4, 0u);
+    EXPECT_GE(top[0].counts.find, 3000u);
+    EXPECT_LE(top[0].counts.find, 5000u);
+}
+
+TEST_F(ProfilingTest, DefaultPeriodOnlySamplesAccesses) {
+    static_assert(profiling::default_sample_period > 1);
+    profiling::set_sample_period(profiling::default_sample_period);
+    const std::uint64_t accesses = 1000 * profiling::default_sample_period;
+    std::thread t([&] {
+        for (std::uint64_t i = 0; i < accesses; ++i) (void)reg.find("hot");
+    });
+    t.join();
+
+    const auto top = profiling::hot_keys(reg, 1);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].counts.find % profiling::default_sample_period, 0u);
+    EXPECT_GE(top[0].counts.find, accesses * 4 / 5);
+    EXPECT_LE(top[0].counts.find, accesses * 6 / 5);
+}
+
+TEST_F(ProfilingTest, RoundRobinAccessesDoNotAlias) {
+    constexpr std::size_t nodes = profiling::default_sample_period;
+    constexpr std::uint64_t rounds = 2000;
+    profiling::set_sample_period(profiling::default_sample_period);
+    std::vector<int> targets(nodes);  // only their addresses matter
+    std::thread t([&] {
+        for (std::uint64_t r = 0; r < rounds; ++r)
+            for (const auto& n : targets) profiling::record(profiling::access::get, &n);
+    });
+    t.join();
+
+    const auto counts = profiling::snapshot();
+    std::uint64_t total = 0;
+    for (const auto& n : targets) {
+        const auto it = counts.find(&n);
+        ASSERT_NE(it, counts.end()) << "node " << (&n - targets.data()) << " was never sampled";
+        total += it->second.get;
+    }
+    EXPECT_GE(total, nodes * rounds * 4 / 5);
+    EXPECT_LE(total, nodes * rounds * 6 / 5);
+}
+
+TEST_F(ProfilingTest, CountsFromAllThreadsAreMerged) {
+    auto worker = [this] { for (int i = 0; i < 100; ++i) (void)reg.find("warm"); };
+    std::thread a(worker), b(worker);
+    a.join();
+    b.join();
+
+    const auto top = profiling::hot_keys(reg, 1);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_EQ(top[0].key, "warm");
+    EXPECT_EQ(top[0].counts.find, 200u);
+}
+
+TEST_F(ProfilingTest, ResetAndReport) {
+    (void)reg.find("cold");
+    std::ostringstream os;
+    profiling::write_report(os, reg, 5);
+    EXPECT_NE(os.str().find("cold\ttotal=1"), std::string::npos);
+
+    profiling::reset();
+    EXPECT_TRUE(profiling::hot_keys(reg, 5).empty());
+}
+
+#endif // PROFILING_TEST_H
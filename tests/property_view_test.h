@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <memory>
+#include <new>
 #include <atomic>
+#include <thread>
+#include <vector>
 #include <stdexcept>
 
 #include "propex/ownership_policies.h"
@@ -31,7 +35,11 @@ using OwnershipTypes = ::testing::Types<
     OwnershipTag<ownership::by_value>,
     OwnershipTag<ownership::by_reference>,
     OwnershipTag<ownership::by_shared>,
-    OwnershipTag<ownership::by_atomic>
+    OwnershipTag<ownership::by_atomic>,
+    OwnershipTag<ownership::by_lazy>,
+    OwnershipTag<ownership::by_atomic_ref>,
+    OwnershipTag<ownership::by_spinlock>,
+    OwnershipTag<ownership::by_rwlock>
     >;
 
 TYPED_TEST_SUITE(PropertyViewTest, OwnershipTypes);
@@ -123,3 +131,221 @@ TEST(PropertyViewOwnership, ByAtomicStoresAtomically) {
     v.set(100);
     EXPECT_EQ(v.get_checked(), 100);
 }
+
+TEST(PropertyViewOwnership, ByLazyBuildsOnFirstGet) {
+    int builds{0};
+    node<int, ownership::by_lazy> n([&] { ++builds; return 42; });
+    property_view<int, node, ownership::by_lazy> v(&n);
+    EXPECT_EQ(builds, 0);
+    EXPECT_EQ(v.get_checked(), 42);
+    EXPECT_EQ(v.get(), 42);
+    EXPECT_EQ(builds, 1);
+}
+
+TEST(PropertyViewOwnership, ByLazySetBeforeGetSkipsFactory) {
+    bool built{false};
+    node<int, ownership::by_lazy> n([&] { built = true; return 1; });
+    property_view<int, node, ownership::by_lazy> v(&n);
+    v = 7;
+    EXPECT_EQ(v.get(), 7);
+    EXPECT_FALSE(built);
+}
+
+TEST(PropertyViewOwnership, ByLazyRetriesAfterThrowingFactory) {
+    int attempts{0};
+    ownership::by_lazy<int> lazy([&] {
+        if (++attempts == 1) throw std::runtime_error("not yet");
+        return 5;
+    });
+    EXPECT_THROW((void)lazy.get(), std::runtime_error);
+    EXPECT_FALSE(lazy.initialized());
+    EXPECT_EQ(lazy.get(), 5);
+    EXPECT_TRUE(lazy.initialized());
+}
+
+TEST(PropertyViewOwnership, ByLazyFactoryErrorsReachTheCaller) {
+    int attempts{0};
+    node<int, ownership::by_lazy> n([&] {
+        if (++attempts <= 2) throw std::runtime_error("not yet");
+        return 5;
+    });
+    property_view<int, node, ownership::by_lazy> v(&n);
+    static_assert(!noexcept(v.get()) && !noexcept(n.get()));
+    EXPECT_THROW((void)v.get_checked(), std::runtime_error);
+    EXPECT_THROW((void)v.get(), std::runtime_error);
+    EXPECT_EQ(v.get(), 5);
+
+    node<int> plain(1);
+    property_view<int, node> p(&plain);
+    static_assert(noexcept(p.get()) && noexcept(plain.get()));
+}
+
+TEST(PropertyViewOwnership, ByLazyFirstUseIsThreadSafe) {
+    std::atomic<int> builds{0};
+    node<std::vector<int>, ownership::by_lazy> n([&] {
+        ++builds;
+        return std::vector<int>(1000, 3);
+    });
+    std::vector<std::thread> threads;
+    std::atomic<long> sum{0};
+    for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&] { sum += n.get()[999]; });
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(builds.load(), 1);
+    EXPECT_EQ(sum.load(), 8 * 3);
+}
+
+TEST(PropertyViewOwnership, ByAtomicSharedReadersKeepTheirSnapshot) {
+    node<std::vector<int>, ownership::by_atomic_shared> n(std::vector<int>{1, 2, 3});
+    property_view<std::vector<int>, node, ownership::by_atomic_shared> v(&n);
+
+    const auto old = v.get();
+    v = std::vector<int>{4, 5};
+    EXPECT_EQ(old->size(), 3u);
+    EXPECT_EQ(v.get_checked()->size(), 2u);
+
+    v.set(std::make_shared<const std::vector<int>>(7, 0));
+    EXPECT_EQ(v.get()->size(), 7u);
+}
+
+TEST(PropertyViewOwnership, ByAtomicSharedAdoptsLvalueSharedPointers) {
+    node<std::vector<int>, ownership::by_atomic_shared> n(std::vector<int>{1});
+    property_view<std::vector<int>, node, ownership::by_atomic_shared> v(&n);
+
+    auto mutable_ptr = std::make_shared<std::vector<int>>(3, 0);
+    v.set(mutable_ptr);
+    EXPECT_EQ(v.get().get(), mutable_ptr.get());
+
+    std::shared_ptr<const std::vector<int>> const_ptr = std::make_shared<const std::vector<int>>(5, 0);
+    n.set(const_ptr);
+    EXPECT_EQ(n.get().get(), const_ptr.get());
+}
+
+TEST(PropertyViewOwnership, ByAtomicSharedPublishesWholeValues) {
+    node<std::vector<int>, ownership::by_atomic_shared> n(std::vector<int>(256, 0));
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                const auto snapshot = n.get();
+                if (std::count(snapshot->begin(), snapshot->end(), snapshot->front()) != 256) ++torn;
+            }
+        });
+    }
+    for (int version = 1; version <= 2000; ++version)
+        n.set(std::vector<int>(256, version));
+    done = true;
+    for (auto& t : readers) t.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(n.get()->front(), 2000);
+}
+
+TEST(PropertyViewOwnership, ByAtomicRefWritesThroughToExternalArray) {
+    std::vector<double> field(4, 0.0);
+    node<double, ownership::by_atomic_ref> n(field[2]);
+    property_view<double, node, ownership::by_atomic_ref> v(&n);
+    v = 3.5;
+    EXPECT_EQ(field[2], 3.5);
+    field[2] = 1.0;
+    EXPECT_EQ(v.get_checked(), 1.0);
+}
+
+TEST(PropertyViewOwnership, ByAtomicRefSharesExternalStorageAcrossThreads) {
+    using policy = ownership::atomic_ref_order<std::memory_order_acquire, std::memory_order_release>;
+    alignas(std::atomic_ref<long>::required_alignment) long counter{0};
+    node<long, policy::type> n(counter);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+        workers.emplace_back([&] {
+            ownership::by_atomic_ref<long> ref(counter);
+            for (int i = 0; i < 10000; ++i) ref.ref().fetch_add(1, std::memory_order_relaxed);
+        });
+    for (auto& w : workers) w.join();
+    EXPECT_EQ(n.get(), 40000);
+}
+
+template <class Tag>
+class LockedPropertyTest : public ::testing::Test {};
+
+/// Value whose copy throws once `fail` is set.
+struct throwing_copy {
+    static inline bool fail = false;
+    int value{0};
+    explicit throwing_copy(int v) : value(v) {}
+    throwing_copy(const throwing_copy& other) : value(other.value) {
+        if (fail) throw std::bad_alloc();
+    }
+    throwing_copy& operator=(const throwing_copy&) = default;
+};
+
+using LockPolicies = ::testing::Types<
+    OwnershipTag<ownership::by_spinlock>,
+    OwnershipTag<ownership::by_rwlock>
+    >;
+
+TYPED_TEST_SUITE(LockedPropertyTest, LockPolicies);
+
+TYPED_TEST(LockedPropertyTest, WithLockUpdatesInPlace) {
+    using Node = node<std::vector<double>, TypeParam::template type>;
+    Node n(std::vector<double>(3, 1.0));
+    property_view<std::vector<double>, node, TypeParam::template type> v(&n);
+
+    const auto size = v.with_lock([](std::vector<double>& a) {
+        a[1] = 5.0;
+        return a.size();
+    });
+    EXPECT_EQ(size, 3u);
+    EXPECT_EQ(v.get(), (std::vector<double>{1.0, 5.0, 1.0}));
+
+    const auto& cv = v;
+    EXPECT_EQ(cv.with_lock([](const std::vector<double>& a) { return a[1]; }), 5.0);
+}
+
+TYPED_TEST(LockedPropertyTest, GetReturnsIndependentSnapshot) {
+    node<std::vector<int>, TypeParam::template type> n(std::vector<int>{1, 2});
+    auto snapshot = n.get();
+    n.set(std::vector<int>{3, 4, 5});
+    EXPECT_EQ(snapshot, (std::vector<int>{1, 2}));
+    EXPECT_EQ(n.get().size(), 3u);
+}
+
+TYPED_TEST(LockedPropertyTest, SnapshotErrorsReachTheCaller) {
+    node<throwing_copy, TypeParam::template type> n(throwing_copy(7));
+    property_view<throwing_copy, node, TypeParam::template type> v(&n);
+    static_assert(!noexcept(v.get()));
+    throwing_copy::fail = true;
+    EXPECT_THROW((void)v.get(), std::bad_alloc);
+    EXPECT_THROW((void)v.get_checked(), std::bad_alloc);
+    throwing_copy::fail = false;
+    EXPECT_EQ(v.get().value, 7);  // the lock was released
+
+    // Locking a std::shared_mutex may throw std::system_error, so only spinlock reads of scalars are noexcept.
+    node<double, TypeParam::template type> scalar(1.0);
+    static_assert(noexcept(scalar.get()) == std::is_same_v<TypeParam, OwnershipTag<ownership::by_spinlock>>);
+}
+
+TYPED_TEST(LockedPropertyTest, ConcurrentUpdatesAreNotLost) {
+    node<std::vector<long>, TypeParam::template type> n(std::vector<long>(4, 0));
+    property_view<std::vector<long>, node, TypeParam::template type> v(&n);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&] {
+            for (int i = 0; i < 5000; ++i)
+                v.with_lock([](std::vector<long>& a) { for (auto& x : a) ++x; });
+        });
+    threads.emplace_back([&] {
+        // Snapshots must never observe a half-applied update.
+        for (int i = 0; i < 5000; ++i) {
+            const auto s = v.get();
+            EXPECT_TRUE(std::all_of(s.begin(), s.end(), [&](long x) { return x == s[0]; }));
+        }
+    });
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(v.get(), (std::vector<long>(4, 20000)));
+}
@@ -0,0 +1,205 @@
+#ifndef SCHEDULER_TEST_H
+#define SCHEDULER_TEST_H
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_async.h"
+#include "propex/propex_node.h"
+#include "propex/propex_scheduler.h"
+
+using namespace numsim::propex;
+
+namespace {
+/// An "external" executor: one thread per task.
+struct thread_per_task_executor {
+    std::vector<std::jthread> threads;
+    void submit(task t) { threads.emplace_back([t = std::move(t)]() mutable { t(); }); }
+    void wait(task_group& g) { g.wait(); }
+    std::size_t concurrency() const { return 4; }
+};
+
+/// Accepts @p limit tasks, then fails to submit.
+struct failing_executor {
+    thread_per_task_executor threads;
+    std::size_t limit;
+    void submit(task t) {
+        if (limit-- == 0) throw std::runtime_error("failing_executor: queue full");
+        threads.submit(std::move(t));
+    }
+    void wait(task_group& g) { g.wait(); }
+    std::size_t concurrency() const { return 4; }
+};
+
+detached_task resume_on_pool(property_view<int, node, ownership::by_atomic>& v, work_stealing_scheduler& pool,
+                             std::atomic<std::thread::id>& resumed_on) {
+    co_await v.changed(pool);
+    resumed_on = std::this_thread::get_id();
+    resumed_on.notify_one();
+}
+} // namespace
+
+TEST(Scheduler, RunsEveryTaskOfAGroup) {
+    work_stealing_scheduler pool(scheduler_options{.workers = 2});
+    EXPECT_EQ(pool.workers(), 2u);
+    EXPECT_EQ(pool.concurrency(), 3u);
+
+    std::atomic<int> sum{0};
+    task_group g;
+    for (int i = 1; i <= 1000; ++i) pool.run(g, [&sum, i] { sum += i; });
+    pool.wait(g);
+    EXPECT_EQ(sum, 500500);
+    EXPECT_EQ(g.pending(), 0u);
+}
+
+TEST(Scheduler, TasksStoreSmallAndLargeCallables) {
+    int calls = 0;
+    task small([&calls] { ++calls; });
+    std::array<double, 64> big{};
+    big[63] = 1.0;
+    task large([&calls, big] { calls += static_cast<int>(big[63]); });
+    task moved_only([p = std::make_unique<int>(5), &calls] { calls += *p; });
+
+    task moved(std::move(small));
+    EXPECT_FALSE(small);
+    moved();
+    large();
+    moved_only();
+    EXPECT_EQ(calls, 7);
+    EXPECT_FALSE(moved);
+
+    // A task that never runs still releases its group.
+    task_group g;
+    { task dropped([] {}, &g); EXPECT_EQ(g.pending(), 1u); }
+    EXPECT_EQ(g.pending(), 0u);
+}
+
+TEST(Scheduler, WaitRethrowsTheFirstException) {
+    work_stealing_scheduler pool(scheduler_options{.workers = 2});
+    std::atomic<int> ran{0};
+    task_group g;
+    for (int i = 0; i < 10; ++i)
+        pool.run(g, [&ran, i] {
+            ++ran;
+            if (i == 3) throw std::runtime_error("task failed");
+        });
+    EXPECT_THROW(pool.wait(g), std::runtime_error);
+    EXPECT_EQ(ran, 10);  // the others still ran
+    EXPECT_NO_THROW(pool.wait(g));
+}
+
+TEST(Scheduler, NestedParallelLoopsHelpInsteadOfBlocking) {
+    // One worker: nested waits only finish because waiting threads run queued tasks.
+    work_stealing_scheduler pool(scheduler_options{.workers = 1});
+    std::vector<std::atomic<int>> hits(64 * 64);
+    parallel_for(pool, 64, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+            parallel_for(pool, 64, [&, i](std::size_t a, std::size_t b) {
+                for (std::size_t j = a; j < b; ++j) ++hits[i * 64 + j];
+            }, 8);
+    }, 8);
+    for (const auto& h : hits) EXPECT_EQ(h, 1);
+}
+
+TEST(Scheduler, IdleWorkersSteal) {
+    work_stealing_scheduler pool(scheduler_options{.workers = 2});
+    std::atomic<bool> taken{false};
+    std::atomic<std::thread::id> owner, thief;
+    task_group outer;
+    pool.run(outer, [&] {
+        // Queued on this worker's own deque. The worker then blocks until the
+        // task has run, so only the other worker can take it, by stealing.
+        owner = std::this_thread::get_id();
+        task_group inner;
+        pool.run(inner, [&] {
+            thief = std::this_thread::get_id();
+            taken = true;
+            taken.notify_one();
+        });
+        taken.wait(false);
+        pool.wait(inner);
+    });
+    outer.wait();  // not pool.wait(): this thread must not take the task itself
+    EXPECT_NE(thief.load(), owner.load());
+    EXPECT_GT(pool.steals(), 0u);
+}
+
+TEST(Scheduler, ParallelForCoversTheRangeOnAnyExecutor) {
+    const auto check = [](auto& ex, std::size_t n, std::size_t chunks) {
+        std::vector<int> seen(n, 0);
+        parallel_for(ex, n, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) ++seen[i];
+        }, chunks);
+        EXPECT_EQ(std::accumulate(seen.begin(), seen.end(), 0), static_cast<int>(n));
+        EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](int s) { return s == 1; }));
+    };
+    work_stealing_scheduler pool(scheduler_options{.workers = 3});
+    sequential_executor sequential;
+    thread_per_task_executor external;
+    static_assert(executor<work_stealing_scheduler> && executor<sequential_executor>
+                  && executor<thread_per_task_executor>);
+    for (const std::size_t chunks : {0u, 1u, 3u, 7u, 200u}) {
+        check(pool, 101, chunks);
+        check(sequential, 101, chunks);
+        check(external, 101, chunks);
+    }
+    check(pool, 0, 4);
+}
+
+TEST(Scheduler, ParallelForWaitsForQueuedRangesWhenSubmitFails) {
+    failing_executor ex{{}, 2};
+    std::atomic<int> finished{0};
+    EXPECT_THROW(parallel_for(ex, 8, [&](std::size_t, std::size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        finished.fetch_add(1);
+    }, 4), std::runtime_error);
+    EXPECT_EQ(finished.load(), 2);  // the queued ranges finished before the exception left parallel_for
+}
+
+TEST(Scheduler, ResumesCoroutinesOnWorkers) {
+    work_stealing_scheduler pool(scheduler_options{.workers = 1});
+    static_assert(resume_scheduler<work_stealing_scheduler>);
+    node<int, ownership::by_atomic> n(0);
+    property_view<int, node, ownership::by_atomic> v(&n);
+    std::atomic<std::thread::id> resumed_on{};
+
+    resume_on_pool(v, pool, resumed_on);
+    v.set(1);
+    resumed_on.wait(std::thread::id{});
+    EXPECT_NE(resumed_on.load(), std::this_thread::get_id());
+}
+
+TEST(Scheduler, PinningIsBestEffort) {
+    EXPECT_EQ(detail::parse_cpulist("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    for (const pinning pin : {pinning::cores, pinning::numa_nodes}) {
+        work_stealing_scheduler pool(scheduler_options{.workers = 2, .pin = pin});
+        EXPECT_LE(pool.pinned_workers(), 2u);
+        std::atomic<int> ran{0};
+        task_group g;
+        for (int i = 0; i < 8; ++i) pool.run(g, [&ran] { ++ran; });
+        pool.wait(g);
+        EXPECT_EQ(ran, 8);
+    }
+}
+
+TEST(Scheduler, DestructorRunsPostedTasks) {
+    std::atomic<int> ran{0};
+    {
+        work_stealing_scheduler pool(scheduler_options{.workers = 2});
+        for (int i = 0; i < 100; ++i) pool.post([&ran] { ++ran; });
+    }
+    EXPECT_EQ(ran, 100);
+}
+
+#endif // SCHEDULER_TEST_H
@@ -0,0 +1,156 @@
+#ifndef SENSITIVITY_TEST_H
+#define SENSITIVITY_TEST_H
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "propex/propex_formula.h"
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+#include "propex/propex_sensitivity.h"
+
+using namespace numsim::propex;
+
+namespace {
+using sensitivity_registry = registry<std::string, node_base>;
+
+sensitivity_registry elastic() {
+    sensitivity_registry reg;
+    reg.add(std::make_unique<node<double>>(200.0), "mat", "E");
+    reg.add(std::make_unique<node<double>>(0.25), "mat", "nu");
+    reg.add(std::make_unique<node<double>>(0.0), "mat", "G");
+    reg.add(std::make_unique<node<double>>(0.01), "load", "gamma");
+    reg.add(std::make_unique<node<double>>(0.0), "load", "tau");
+    return reg;
+}
+
+double scalar(const sensitivity_registry& reg, const char* key) {
+    return static_cast<node<double>*>(reg.find(key))->get();
+}
+} // namespace
+
+TEST(Sensitivity, PropagatesThroughAChainOfFormulas) {
+    sensitivity_registry reg = elastic();
+    sensitivity_pass pass(reg, {"mat:E", "mat:nu"});
+    pass.apply(compile_formula(reg, "mat:G = mat:E / (2*(1+mat:nu))"));
+    pass.apply(compile_formula(reg, "load:tau = mat:G * load:gamma"));
+
+    EXPECT_DOUBLE_EQ(scalar(reg, "mat:G"), 80.0);
+    EXPECT_DOUBLE_EQ(scalar(reg, "load:tau"), 0.8);
+    EXPECT_DOUBLE_EQ(pass.derivative("mat:G", 0), 1.0 / 2.5);
+    EXPECT_DOUBLE_EQ(pass.derivative("mat:G", 1), -200.0 / (2 * 1.25 * 1.25));
+    EXPECT_DOUBLE_EQ(pass.derivative("load:tau", 0), 0.01 / 2.5);
+    EXPECT_DOUBLE_EQ(pass.derivative("load:tau", 1), -0.01 * 200.0 / (2 * 1.25 * 1.25));
+    EXPECT_EQ(pass.derivative("mat:nu", 1), 1.0);
+    EXPECT_EQ(pass.derivative("mat:nu", 0), 0.0);
+    EXPECT_THROW((void)pass.derivative("load:gamma", 0), std::out_of_range);
+    EXPECT_THROW((void)pass.derivative("mat:G", 2), std::out_of_range);
+}
+
+TEST(Sensitivity, MatchesFiniteDifferencesForEveryOperation) {
+    sensitivity_registry reg;
+    reg.add(std::make_unique<node<double>>(1.3), "x");
+    reg.add(std::make_unique<node<double>>(0.7), "y");
+    reg.add(std::make_unique<node<double>>(0.0), "r");
+    const char* text = "r = sqrt(x) * exp(y) / log(1 + x) - pow(x, y) + abs(-x * y) + max(x, y)^3 - min(x, 2*y) + (-2)^2";
+
+    sensitivity_pass pass(reg, {"x", "y"});
+    pass.apply(compile_formula(reg, text));
+
+    const formula f = compile_formula(reg, text);
+    const double h = 1e-6;
+    for (std::size_t k = 0; k < 2; ++k) {
+        auto* p = static_cast<node<double>*>(reg.find(k == 0 ? "x" : "y"));
+        const double base = p->get();
+        p->set(base + h);
+        const double up = f.value();
+        p->set(base - h);
+        const double down = f.value();
+        p->set(base);
+        EXPECT_NEAR(pass.derivative("r", k), (up - down) / (2 * h), 1e-6) << k;
+    }
+}
+
+TEST(Sensitivity, FieldsCarryPerElementDerivatives) {
+    const std::size_t n = 300;
+    std::vector<double> x(n);
+    for (std::size_t i = 0; i < n; ++i) x[i] = 0.01 * static_cast<double>(i);
+    sensitivity_registry reg = elastic();
+    reg.add(std::make_unique<node<std::vector<double>>>(x), "field", "x");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(n)), "field", "s");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(n)), "field", "w");
+
+    sensitivity_pass pass(reg, {"mat:nu", "mat:E"});
+    pass.apply(compile_formula(reg, "field:s = mat:E * field:x^2 + mat:nu"));
+    pass.apply(compile_formula(reg, "field:w = field:s * field:s"));
+
+    ASSERT_EQ(pass.derivatives("field:w").size(), 2 * n);
+    const auto& s = static_cast<node<std::vector<double>>*>(reg.find("field:s"))->get();
+    for (std::size_t i = 0; i < n; ++i) {
+        EXPECT_DOUBLE_EQ(pass.derivative("field:s", 0, i), 1.0);
+        EXPECT_DOUBLE_EQ(pass.derivative("field:s", 1, i), x[i] * x[i]);
+        EXPECT_DOUBLE_EQ(pass.derivative("field:w", 1, i), 2 * s[i] * x[i] * x[i]);
+    }
+}
+
+TEST(Sensitivity, ConstantInputsHaveZeroDerivatives) {
+    sensitivity_registry reg = elastic();
+    sensitivity_pass pass(reg, {"mat:E"});
+    pass.apply(compile_formula(reg, "load:tau = load:gamma * 3"));
+    EXPECT_EQ(pass.derivative("load:tau", 0), 0.0);
+    pass.apply(compile_formula(reg, "mat:G = mat:E"));
+    EXPECT_EQ(pass.derivative("mat:G", 0), 1.0);
+}
+
+TEST(Sensitivity, AcceptsParameterKeysFromAnyRange) {
+    sensitivity_registry reg = elastic();
+    const std::vector<std::string> keys{"mat:E", "mat:nu"};
+    sensitivity_pass from_vector(reg, keys);
+    sensitivity_pass from_span(reg, std::span<const std::string>(keys).last(1));
+    EXPECT_EQ(from_vector.parameters(), 2u);
+    EXPECT_EQ(from_span.parameters(), 1u);
+
+    const formula shear = compile_formula(reg, "mat:G = mat:E / (2*(1+mat:nu))");
+    from_vector.apply(shear);
+    from_span.apply(shear);
+    EXPECT_DOUBLE_EQ(from_vector.derivative("mat:G", 1), from_span.derivative("mat:G", 0));
+}
+
+TEST(Sensitivity, EmptyFieldsHaveNoDerivatives) {
+    sensitivity_registry reg = elastic();
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>{}), "field", "x");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>{}), "field", "s");
+    sensitivity_pass pass(reg, {"mat:E"});
+    EXPECT_NO_THROW(pass.apply(compile_formula(reg, "field:s = mat:E * field:x")));
+    EXPECT_TRUE(pass.derivatives("field:s").empty());
+}
+
+TEST(Sensitivity, RejectsInputsResizedAfterRecording) {
+    sensitivity_registry reg = elastic();
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(4, 1.0)), "field", "x");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(4)), "field", "s");
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(8)), "field", "w");
+    sensitivity_pass pass(reg, {"mat:E"});
+    pass.apply(compile_formula(reg, "field:s = mat:E * field:x"));
+
+    static_cast<node<std::vector<double>>*>(reg.find("field:s"))->set(std::vector<double>(8, 1.0));
+    EXPECT_THROW(pass.apply(compile_formula(reg, "field:w = 2 * field:s")), std::invalid_argument);
+    EXPECT_TRUE(pass.derivatives("field:w").empty());
+}
+
+TEST(Sensitivity, RejectsInvalidParameters) {
+    sensitivity_registry reg = elastic();
+    reg.add(std::make_unique<node<std::vector<double>>>(std::vector<double>(3)), "field");
+    EXPECT_THROW((sensitivity_pass(reg, {"mat:K"})), std::out_of_range);
+    EXPECT_THROW((sensitivity_pass(reg, {"field"})), std::invalid_argument);
+    sensitivity_pass pass(reg, {"mat:E"});
+    EXPECT_THROW(pass.apply(compile_formula(reg, "mat:E * 2")), std::logic_error);
+}
+
+#endif // SENSITIVITY_TEST_H
@@ -0,0 +1,154 @@
+#ifndef TABULATED_TEST_H
+#define TABULATED_TEST_H
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "propex/ownership_policies.h"
+#include "propex/property_view.h"
+#include "propex/propex_node.h"
+#include "propex/propex_tabulated.h"
+
+using namespace numsim::propex;
+
+namespace {
+/// Reference implementation: the linear search plus interpolation users write by hand.
+double linear_reference(const std::vector<double>& xs, const std::vector<double>& ys, double x) {
+    x = std::clamp(x, xs.front(), xs.back());
+    std::size_t i = 0;
+    while (i + 2 < xs.size() && xs[i + 1] <= x) ++i;
+    const double t = (x - xs[i]) / (xs[i + 1] - xs[i]);
+    return ys[i] + t * (ys[i + 1] - ys[i]);
+}
+
+std::vector<double> random_points(std::size_t n, double lo, double hi) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    std::vector<double> xs(n);
+    for (auto& x : xs) x = dist(gen);
+    return xs;
+}
+} // namespace
+
+TEST(Tabulated, LinearInterpolatesBetweenPoints) {
+    tabulated t({0.0, 1.0, 2.0}, {0.0, 10.0, 30.0});
+    EXPECT_EQ(t.search(), table_search::uniform);
+    EXPECT_DOUBLE_EQ(t.eval(0.0), 0.0);
+    EXPECT_DOUBLE_EQ(t.eval(0.5), 5.0);
+    EXPECT_DOUBLE_EQ(t.eval(1.0), 10.0);
+    EXPECT_DOUBLE_EQ(t.eval(1.5), 20.0);
+    EXPECT_DOUBLE_EQ(t.eval(2.0), 30.0);
+}
+
+TEST(Tabulated, ClampsOutsideTheRange) {
+    tabulated t({0.0, 1.0, 3.0}, {1.0, 2.0, 4.0});
+    EXPECT_DOUBLE_EQ(t.eval(-5.0), 1.0);
+    EXPECT_DOUBLE_EQ(t.eval(7.0), 4.0);
+    EXPECT_DOUBLE_EQ(t.eval(std::numeric_limits<double>::quiet_NaN()), 1.0);
+}
+
+TEST(Tabulated, EytzingerSearchMatchesLinearSearch) {
+    std::vector<double> xs{0.0, 0.1, 0.35, 0.4, 1.0, 1.7, 2.0, 3.5, 3.6, 5.0, 8.0};
+    std::vector<double> ys(xs.size());
+    for (std::size_t i = 0; i < xs.size(); ++i) ys[i] = std::sin(xs[i]);
+    tabulated t(xs, ys);
+    ASSERT_EQ(t.search(), table_search::eytzinger);
+
+    for (double x : random_points(2000, -1.0, 9.0))
+        EXPECT_NEAR(t.eval(x), linear_reference(xs, ys, x), 1e-12) << "x = " << x;
+    for (double x : xs) EXPECT_NEAR(t.eval(x), linear_reference(xs, ys, x), 1e-12);
+}
+
+TEST(Tabulated, SearchModesAgreeOnUniformGrid) {
+    std::vector<double> xs(33), ys(33);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = 250.0 + 12.5 * static_cast<double>(i);
+        ys[i] = 1.0 / xs[i];
+    }
+    tabulated uniform(xs, ys, interpolation::cubic, table_search::uniform);
+    tabulated tree(xs, ys, interpolation::cubic, table_search::eytzinger);
+    for (double x : random_points(1000, 240.0, 660.0))
+        EXPECT_NEAR(uniform.eval(x), tree.eval(x), 1e-15);
+}
+
+TEST(Tabulated, CubicSplineIsExactAtKnotsAndForLines) {
+    std::vector<double> xs{0.0, 0.5, 2.0, 2.5, 4.0};
+    std::vector<double> ys{1.0, -2.0, 0.5, 3.0, 2.0};
+    tabulated spline(xs, ys, interpolation::cubic);
+    for (std::size_t i = 0; i < xs.size(); ++i) EXPECT_NEAR(spline.eval(xs[i]), ys[i], 1e-12);
+
+    // A natural spline through points on a line is the line itself.
+    std::vector<double> line(xs.size());
+    for (std::size_t i = 0; i < xs.size(); ++i) line[i] = 3.0 * xs[i] - 1.0;
+    tabulated exact(xs, line, interpolation::cubic);
+    for (double x : random_points(200, 0.0, 4.0)) EXPECT_NEAR(exact.eval(x), 3.0 * x - 1.0, 1e-12);
+}
+
+TEST(Tabulated, CubicSplineConvergesOnSmoothData) {
+    std::vector<double> xs(41), ys(41);
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = 0.1 * static_cast<double>(i);
+        ys[i] = std::exp(-xs[i]);
+    }
+    tabulated linear(xs, ys), cubic(xs, ys, interpolation::cubic);
+    double linear_error = 0.0, cubic_error = 0.0;
+    for (double x : random_points(500, 0.5, 3.5)) {
+        linear_error = std::max(linear_error, std::abs(linear.eval(x) - std::exp(-x)));
+        cubic_error = std::max(cubic_error, std::abs(cubic.eval(x) - std::exp(-x)));
+    }
+    EXPECT_LT(cubic_error, 1e-5);
+    EXPECT_LT(cubic_error, linear_error / 50.0);
+}
+
+TEST(Tabulated, BatchEvaluationMatchesScalar) {
+    std::vector<double> xs{0.0, 0.3, 0.4, 1.1, 2.0, 2.2, 3.0};
+    std::vector<double> ys{0.0, 1.0, 0.5, 0.7, 2.0, 1.5, 1.0};
+    for (auto kind : {interpolation::linear, interpolation::cubic}) {
+        for (auto search : {table_search::automatic, table_search::eytzinger}) {
+            tabulated t(xs, ys, kind, search);
+            const auto points = random_points(1037, -0.5, 3.5);  // not a multiple of the block size
+            std::vector<double> out(points.size());
+            t.eval(points, out);
+            for (std::size_t j = 0; j < points.size(); ++j) EXPECT_EQ(out[j], t.eval(points[j]));
+        }
+    }
+}
+
+TEST(Tabulated, RejectsInvalidTables) {
+    EXPECT_THROW(tabulated({0.0}, {1.0}), std::invalid_argument);
+    EXPECT_THROW(tabulated({0.0, 1.0}, {1.0}), std::invalid_argument);
+    EXPECT_THROW(tabulated({0.0, 1.0, 1.0}, {1.0, 2.0, 3.0}), std::invalid_argument);
+    EXPECT_THROW(tabulated({0.0, 1.0, 3.0}, {1.0, 2.0, 3.0}, interpolation::linear, table_search::uniform),
+                 std::invalid_argument);
+
+    tabulated t({0.0, 1.0}, {0.0, 1.0});
+    std::vector<double> in(4), out(3);
+    EXPECT_THROW(t.eval(in, out), std::invalid_argument);
+}
+
+TEST(Tabulated, ViewEvaluatesStoredTable) {
+    node<tabulated, ownership::by_value> n(tabulated({293.0, 473.0, 673.0}, {210e9, 195e9, 180e9}));
+    property_view<tabulated, node, ownership::by_value> E(&n);
+    EXPECT_DOUBLE_EQ(E.eval(383.0), 202.5e9);
+
+    std::vector<double> temperatures{293.0, 573.0}, moduli(2);
+    E.eval(temperatures, moduli);
+    EXPECT_DOUBLE_EQ(moduli[0], 210e9);
+    EXPECT_DOUBLE_EQ(moduli[1], 187.5e9);
+}
+
+TEST(Tabulated, ViewEvaluatesPublishedSnapshot) {
+    using table_ptr = std::shared_ptr<const tabulated>;
+    node<tabulated, ownership::by_atomic_shared> n(table_ptr(std::make_shared<tabulated>(
+        std::vector<double>{0.0, 1.0}, std::vector<double>{0.0, 2.0})));
+    property_view<tabulated, node, ownership::by_atomic_shared> v(&n);
+    EXPECT_DOUBLE_EQ(v.eval(0.25), 0.5);
+}
+
+#endif // TABULATED_TEST_H
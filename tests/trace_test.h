@@ -0,0 +1,84 @@
+#ifndef TRACE_TEST_H
+#define TRACE_TEST_H
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "propex/propex_node.h"
+#include "propex/propex_registry.h"
+#include "propex/property_view.h"
+
+using namespace numsim::propex;
+
+namespace {
+
+std::string trace_json() {
+    std::ostringstream os;
+    tracing::chrome_trace::write(os);
+    return os.str();
+}
+
+std::size_t count(const std::string& haystack, const std::string& needle) {
+    std::size_t n{0};
+    for (auto pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+} // namespace
+
+TEST(Tracing, RegistryAndViewOperationsEmitEvents) {
+    tracing::chrome_trace::clear();
+    registry<std::string, node<int>> reg;
+    reg.add(std::make_unique<node<int>>(1), "a", "b");
+    property_view<int, node> v(reg.find("a:b"));
+    v.set(3);
+    EXPECT_EQ(v.get(), 3);
+    EXPECT_TRUE(reg.erase("a:b"));
+
+    const auto json = trace_json();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(count(json, "\"cat\":\"registry\",\"name\":\"add\",\"ph\":\"X\""), 1u);
+    EXPECT_EQ(count(json, "\"cat\":\"registry\",\"name\":\"find\""), 1u);
+    EXPECT_EQ(count(json, "\"cat\":\"registry\",\"name\":\"erase\""), 1u);
+    EXPECT_EQ(count(json, "\"cat\":\"view\",\"name\":\"bind\",\"ph\":\"i\""), 1u);
+    EXPECT_EQ(count(json, "\"cat\":\"view\",\"name\":\"get\""), 1u);
+    EXPECT_EQ(count(json, "\"cat\":\"view\",\"name\":\"set\""), 1u);
+}
+
+TEST(Tracing, PhasesAndThreadsAreSeparated) {
+    tracing::chrome_trace::clear();
+    {
+        PROPEX_TRACE_PHASE("checkpoint:write");
+    }
+    std::thread worker([] { PROPEX_TRACE_PHASE("worker"); });
+    worker.join();
+
+    const auto json = trace_json();
+    EXPECT_EQ(count(json, "\"cat\":\"phase\",\"name\":\"checkpoint:write\""), 1u);
+    const auto main_event = json.find("checkpoint:write");
+    const auto worker_event = json.find("\"worker\"");
+    ASSERT_NE(worker_event, std::string::npos);
+    const auto tid_of = [&](std::size_t pos) { return json.substr(json.find("\"tid\":", pos), 8); };
+    EXPECT_NE(tid_of(main_event), tid_of(worker_event));
+}
+
+TEST(Tracing, NamesAreEscaped) {
+    tracing::chrome_trace::clear();
+    {
+        PROPEX_TRACE_PHASE("say \"hi\" to C:\\tmp\n\x01");
+    }
+    EXPECT_EQ(count(trace_json(), "\"name\":\"say \\\"hi\\\" to C:\\\\tmp\\n\\u0001\""), 1u);
+}
+
+TEST(Tracing, ClearDiscardsEvents) {
+    {
+        PROPEX_TRACE_PHASE("discarded");
+    }
+    tracing::chrome_trace::clear();
+    EXPECT_EQ(trace_json().find("discarded"), std::string::npos);
+}
+
+#endif // TRACE_TEST_H